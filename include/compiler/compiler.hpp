@@ -6,4 +6,16 @@
 #else
     #define FORCE_INLINE inline
 #endif
+
+// Starts loading the cache line of an address that will be read soon, a hint only
+#if defined(NO_PREFETCH)
+    #define PREFETCH(address) ((void)(address))
+#elif defined(_MSC_VER)
+    #include <xmmintrin.h>
+    #define PREFETCH(address) _mm_prefetch(reinterpret_cast<const char *>(address), _MM_HINT_T0)
+#elif defined(__GNUC__) || defined(__clang__)
+    #define PREFETCH(address) __builtin_prefetch(address)
+#else
+    #define PREFETCH(address) ((void)(address))
+#endif
 // clang-format on
@@ -1,8 +1,12 @@
 #pragma once
 
+#include <chrono>
+#include <random>
+#include <memory>
 #include <vector>
 #include <string>
 #include <cstdint>
+#include <string_view>
 
 #include "engine/board/Piece.hpp"
 #include "engine/board/Colour.hpp"
@@ -13,6 +17,16 @@
 
 #include "engine/hash/Transposition.hpp"
 
+#include "engine/book/Book.hpp"
+
+#include "engine/data/Record.hpp"
+
+#include "engine/tablebase/Tablebase.hpp"
+
+#include "engine/search/Tunable.hpp"
+#include "engine/search/Reduction.hpp"
+#include "engine/search/History.hpp"
+
 #include "engine/evaluation/Score.hpp"
 
 #include "compiler/compiler.hpp"
@@ -36,11 +50,74 @@ struct SearchResult {
     }
 };
 
+// Zero means no limit on time or nodes
+struct SearchLimits {
+    int depth;
+
+    int64_t time;
+
+    uint64_t nodes;
+};
+
+// Nodes cut or moves skipped by each forward pruning method, and how often the first move already failed high, during the last search
+struct SearchStatistics {
+    uint64_t nullMove;
+    uint64_t razoring;
+    uint64_t reverseFutility;
+    uint64_t futility;
+    uint64_t lateMove;
+    uint64_t multiCut;
+    uint64_t delta;
+    uint64_t see;
+    uint64_t betaCutoffs;
+    uint64_t firstMoveCutoffs;
+};
+
+// Recorded after every completed depth of iterative deepening
+struct SearchIteration {
+    int depth;
+    int score;
+
+    uint16_t bestMove;
+
+    uint64_t nodes;
+
+    int64_t time;
+
+    // Searches of this depth repeated after the score fell outside the aspiration window
+    int researches;
+};
+
+// One line of a multi-PV search, the first line holds the move that is played
+struct PrincipalVariation {
+    int depth;
+    int score;
+
+    // Spent on this line alone, re-searches included
+    uint64_t nodes;
+
+    // Since the start of the search
+    int64_t time;
+
+    std::vector<uint16_t> moves;
+};
+
 class Engine {
   public:
     Engine();
 
-    void parse(const char *fen);
+    // Attack, hash and endgame tables shared by every engine, built once, code that reads them without an engine calls this first
+    static void initialise();
+
+    // Leaves the position unchanged and logs where the text went wrong when it is not a valid FEN
+    bool parse(std::string_view fen);
+
+    // Null terminated into a caller buffer of at least FenCodec::MAX_SIZE bytes, returns the length or zero when it does not fit
+    size_t toFen(char *buffer, size_t size);
+
+    bool loadBook(const std::string &path);
+
+    bool loadTablebases(const std::string &directory);
 
     void run();
 
@@ -60,8 +137,51 @@ class Engine {
 
     void runPerft(int depth);
 
+    // Depths are clamped to getMaxSearchDepth
+    void setSearchLimits(const SearchLimits &searchLimits);
+
+    static int getMaxSearchDepth();
+
+    bool setTunable(const std::string &name, int value);
+
+    // Number of best root moves searched and reported, book and tablebase moves are skipped above one
+    void setMultiPV(int multiPV);
+
+    int getEvaluation();
+
+    const std::vector<SearchIteration> &getSearchIterations() const;
+
+    const SearchStatistics &getSearchStatistics() const;
+
+    // Lines of the last completed depth, best first
+    const std::vector<PrincipalVariation> &getPrincipalVariations() const;
+
+    void clearTranspositionTable();
+
+    // Move ordering tables are kept between searches of one game, a new game or an unrelated position starts them empty
+    void clearHistories();
+
+    void setTranspositionTableSize(size_t megabytes);
+
+    std::string getSan(uint16_t move);
+
+    // Standard algebraic notation back to a legal move, zero when it matches none or more than one
+    uint16_t getMoveFromSan(std::string_view san);
+
     engine::board::ColourType getSide();
 
+    uint16_t getHalfMove();
+
+    uint64_t getPolyglotKey();
+
+    void pack(engine::data::Record &record);
+
+    void unpack(const engine::data::Record &record);
+
+    bool hasLegalMove();
+
+    bool isInsufficientMaterial();
+
     void printBoard();
 
   private:
@@ -71,20 +191,28 @@ class Engine {
 
     static inline constexpr int _MAX_HALF_MOVES = 50;
 
-    // LMR
-    static inline constexpr int _FULL_DEPTH = 4;
-    static inline constexpr int _REDUCTION_DEPTH = 2;
-    static inline constexpr int _REDUCTION_LIMIT = 3;
-
-    // NMP
-    static inline constexpr int _NMP_REDUCTION = 2;
+    // Ring buffer of position keys before every move, far longer than any reversible stretch of play
+    static inline constexpr int _REPETITION_TABLE_SIZE = 1024;
 
     static inline constexpr int _SEARCH_DEPTH = 9;
 
-    // Aspiration Window
-    static inline constexpr int _ASPIRATION_WINDOW_VALUE = 50;
+    // Leaves room for quiescence plies in the ply indexed tables
+    static inline constexpr int _MAX_SEARCH_DEPTH = engine::move::MAX_PLY / 2;
+
+    static inline constexpr int _MAX_MULTI_PV = 32;
+
+    // Time and node limits are checked every 2048 nodes
+    static inline constexpr int _STOP_CHECK_MASK = 2047;
+
+    // LMR, NMP, razoring, aspiration window and move ordering constants
+    engine::search::Tunables _tunables;
 
-    engine::hash::Transposition::Entry _transpositionTable[engine::hash::Transposition::TRANSPOSITION_TABLE_ENTRIES];
+    // Late move reductions by remaining depth and move number, rebuilt when the LMR tunables change
+    int _reductions[_MAX_SEARCH_DEPTH + 1][engine::search::Reduction::MAX_MOVES];
+
+    std::vector<engine::hash::Transposition::Entry> _transpositionTable;
+
+    size_t _transpositionTableMask;
 
     uint64_t _bitboards[2][6];
     uint64_t _occupancies[2];
@@ -92,6 +220,10 @@ class Engine {
 
     uint64_t _zobrist;
 
+    // Kept up to date by createPiece and removePiece, the score is packed as (opening, endgame) from white's point of view
+    int _phase;
+    int _pieceSquareScore;
+
     uint8_t _castleRights;
 
     uint16_t _halfMove;
@@ -101,34 +233,69 @@ class Engine {
 
     SearchResult _searchResult;
 
+    SearchLimits _searchLimits;
+
+    std::vector<SearchIteration> _searchIterations;
+
+    int _multiPV;
+
+    std::vector<PrincipalVariation> _principalVariations;
+
+    // Root moves of the lines already found at the current depth, the next line is searched without them
+    engine::move::Move::MoveList _rootExcludedMoves;
+
+    std::chrono::steady_clock::time_point _searchStart;
+
+    uint64_t _searchNodes;
+
+    SearchStatistics _searchStatistics;
+
+    bool _isStopped;
+
     int _enPassantSquare;
 
     std::vector<engine::move::Undo> _undoStack;
 
     uint16_t _killerMoves[engine::move::MAX_KILLER_MOVES][engine::move::MAX_PLY];
-    uint16_t _historyMoves[2][6][64];
+    int16_t _historyMoves[2][6][64];
 
-    int _pvLength[64];
-    uint16_t _pvTable[engine::move::MAX_PLY][engine::move::MAX_PLY];
+    // Indexed by side, moving piece, to square and captured piece
+    int16_t _captureHistory[2][6][64][6];
 
-    int _repetitionIndex;
-    uint64_t _repetitionTable[1000];
+    // Quiet move that refuted the previous move, indexed by the previous move's side, piece and to square
+    uint16_t _counterMoves[2][6][64];
+
+    // One table per earlier ply, too large for the engine object itself
+    std::vector<engine::search::History::ContinuationHistory> _continuationHistory;
+
+    // Move and moving piece of each search ply, zero for null moves and quiescence
+    uint16_t _searchMoves[engine::move::MAX_PLY];
+    engine::board::PieceType _searchPieces[engine::move::MAX_PLY];
+
+    // Static evaluation of each search ply, -INF when in check
+    int _staticEvaluations[engine::move::MAX_PLY];
 
-    void initialise();
+    // Move skipped by the singular extension search of each ply, zero when none
+    uint16_t _excludedMoves[engine::move::MAX_PLY];
 
-    void parseFenPosition(std::string &position);
+    int _pvLength[64];
+    uint16_t _pvTable[engine::move::MAX_PLY][engine::move::MAX_PLY];
 
-    void parseFenSide(std::string &side);
+    int _repetitionIndex;
+    uint64_t _repetitionTable[_REPETITION_TABLE_SIZE];
 
-    void parseFenCastleRights(std::string &castleRights);
+    // Positions from here on were reached by the search, earlier ones were played
+    int _searchRootIndex;
 
-    void parseFenEnPassantSquare(std::string &enPassantSquare);
+    std::shared_ptr<engine::book::Book> _book;
 
-    void parseFenHalfMove(std::string &halfMove);
+    // Picks between book moves, per engine as the book may be shared between threads
+    std::mt19937 _bookGenerator;
 
-    void parseFenFullMove(std::string &fullMove);
+    std::shared_ptr<engine::tablebase::Tablebase> _tablebase;
 
-    void createFenPiece(int rank, int file, char letter);
+    // Occupancies, phase, piece square score and key from the bitboards and state just loaded
+    void initialisePosition();
 
     void createPiece(int rank, int file, engine::board::ColourType side);
 
@@ -176,6 +343,8 @@ class Engine {
 
     void generateKingCaptures(engine::move::Move::MoveList &captures, engine::board::ColourType side);
 
+    engine::move::Move::MoveList generateEvasions(engine::board::ColourType side);
+
     bool isInCheck(engine::board::ColourType side);
 
     bool isSquareAttacked(int square, engine::board::ColourType side);
@@ -186,6 +355,9 @@ class Engine {
 
     void updateCastleRights(engine::board::ColourType side);
 
+    // Only children that probe the transposition table are worth a prefetch, others just compete for memory
+    void makeMove(uint16_t &move, bool isPrefetched);
+
     void unmakeMove(uint16_t &move);
 
     void makeNullMove();
@@ -194,7 +366,7 @@ class Engine {
 
     FORCE_INLINE void makeQuietMove(int from, int to, engine::board::PieceType fromPiece);
 
-    FORCE_INLINE void makeCaptureMove(int from, int to, engine::move::Undo &undo, engine::board::PieceType fromPiece, engine::board::ColourType otherSide);
+    FORCE_INLINE void makeCaptureMove(int from, int to, engine::move::Undo &undo, engine::board::PieceType fromPiece, engine::board::PieceType capturedPiece, engine::board::ColourType otherSide);
 
     FORCE_INLINE void makeDoublePawnMove(int from, int to, engine::board::PieceType fromPiece);
 
@@ -206,7 +378,7 @@ class Engine {
 
     FORCE_INLINE void makePromotionQuietMove(int from, int to, engine::board::PieceType promotionPiece);
 
-    FORCE_INLINE void makePromotionCaptureMove(int from, int to, engine::board::PieceType promotionPiece, engine::move::Undo &undo, engine::board::ColourType otherSide);
+    FORCE_INLINE void makePromotionCaptureMove(int from, int to, engine::board::PieceType promotionPiece, engine::move::Undo &undo, engine::board::PieceType capturedPiece, engine::board::ColourType otherSide);
 
     FORCE_INLINE void unmakeQuietMove(int from, int to, engine::board::PieceType toPiece);
 
@@ -224,7 +396,13 @@ class Engine {
 
     FORCE_INLINE void storeKillerMove(const uint16_t move, int ply);
 
-    FORCE_INLINE void storeHistoryMove(const uint16_t move, engine::board::ColourType side, int depth);
+    void ageHistories();
+
+    FORCE_INLINE int getQuietHistory(engine::board::ColourType side, engine::board::PieceType piece, int to, int ply);
+
+    FORCE_INLINE void updateQuietHistory(engine::board::ColourType side, engine::board::PieceType piece, int to, int ply, int bonus);
+
+    void updateHistories(const uint16_t bestMove, int depth, int ply, const engine::move::Move::MoveList &quiets, const engine::move::Move::MoveList &captures);
 
     FORCE_INLINE void storePVMove(const uint16_t move, int ply);
 
@@ -232,34 +410,66 @@ class Engine {
 
     int seeMove(int from, int to, engine::board::PieceType toPiece, engine::board::ColourType side);
 
-    int see(int to, engine::board::PieceType toPiece, engine::board::ColourType side);
-
     FORCE_INLINE bool isNMP(bool isPVNode, bool isParentInCheck, int depth, int ply);
 
     FORCE_INLINE bool isRazoring(bool isPVNode, bool isParentInCheck, int depth);
 
-    FORCE_INLINE bool isLMR(const uint16_t move, bool isPVNode, bool isParentInCheck);
+    FORCE_INLINE bool isReverseFutility(bool isPVNode, bool isParentInCheck, int depth, int staticEvaluation, int beta, bool isImproving);
+
+    FORCE_INLINE bool isFutility(bool isPVNode, bool isParentInCheck, int depth, int staticEvaluation, int alpha);
+
+    FORCE_INLINE bool isLateMovePrune(bool isPVNode, bool isParentInCheck, int depth, int legalMoves, int alpha, bool isImproving);
+
+    FORCE_INLINE bool isLMR(const uint16_t move, bool isParentInCheck);
+
+    FORCE_INLINE int getLMRDepth(const uint16_t move, int depth, int ply, int moveNumber, bool isPVNode, bool isCutNode, bool isImproving);
+
+    void initialiseReductions();
 
     FORCE_INLINE int probeTranspositionTable(int alpha, int beta, int depth, int ply, uint16_t &bestMove);
 
+    FORCE_INLINE const engine::hash::Transposition::Entry *getTranspositionTableEntry();
+
+    FORCE_INLINE bool isSingularExtension(const engine::hash::Transposition::Entry *entry, uint16_t ttMove, int depth, int ply);
+
     FORCE_INLINE void recordTranspositionTableEntry(int score, int depth, engine::hash::Transposition::NodeType nodeType, int ply, uint16_t bestMove);
 
-    FORCE_INLINE bool isRepetition(int ply);
+    FORCE_INLINE uint64_t getPreviousKey(int plies);
+
+    FORCE_INLINE bool isRepetition();
+
+    FORCE_INLINE bool hasUpcomingRepetition(int ply);
+
+    FORCE_INLINE bool isFiftyMoveDraw();
+
+    FORCE_INLINE bool isDrawnEndgame();
+
+    FORCE_INLINE bool isSearchStopped();
+
+    FORCE_INLINE bool isRootExcluded(const uint16_t move, int ply);
+
+    int searchAspiration(int depth, int previousScore, int &researches);
+
+    std::string getPVString(const std::vector<uint16_t> &moves);
+
+    int64_t getElapsedTime();
+
+    FORCE_INLINE bool probeTablebase(int ply, int &score);
+
+    bool getBookMove(uint16_t &move);
+
+    bool getTablebaseMove(uint16_t &move);
 
     void searchIterative(int depth);
 
     void searchRoot(int depth);
 
-    int search(int alpha, int beta, int depth, int ply);
+    int search(int alpha, int beta, int depth, int ply, bool isCutNode);
 
     int quiescence(int alpha, int beta, int ply);
 
     int evaluate(engine::board::ColourType side);
 
-    int evaluatePesto(engine::board::ColourType side);
-
-    FORCE_INLINE int getGamePhaseScore();
-
     uint64_t perft(int depth);
 
     void reset();
@@ -7,7 +7,7 @@ inline constexpr const char *INITIAL_POSITION = "rnbqkbnr/pppppppp/8/8/8/8/PPPPP
 // https://www.chessprogramming.org/Perft_Results#Position_5
 // clang-format off
 inline constexpr const char *POSITIONS[5] = {
-    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - - -",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
     "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
     "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
     "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
@@ -37,14 +37,14 @@ inline constexpr const char* NMP_POSITIONS[] = {
 };
 // clang-format on
 
-inline constexpr const char *KILLER_POSITION = "6k1/3q1pp1/pp3n1p/1r6/5P2/1P4P1/PQ4BP/2R3K1 w KQkq - 0 1";
+inline constexpr const char *KILLER_POSITION = "6k1/3q1pp1/pp3n1p/1r6/5P2/1P4P1/PQ4BP/2R3K1 w - - 0 1";
 
 inline constexpr const char *PROMOTION_POSITIONS[] = {
     "3k4/ppp2pp1/2b4p/8/8/8/4K3/8 b - - 0 1",
 };
 
 inline constexpr const char *TEST_POSITIONS[1] = {
-    "r1b1k2r/pppp1ppp/2n1pq2/2Q5/3PPn2/5N2/PPP2PPP/2KR1B1R b Kkq - 0 1",
+    "r1b1k2r/pppp1ppp/2n1pq2/2Q5/3PPn2/5N2/PPP2PPP/2KR1B1R b kq - 0 1",
 };
 
 inline constexpr const char *EN_PASSANT_POSITIONS[] = {
@@ -56,15 +56,15 @@ inline constexpr const char *REPETITION_POSITIONS[] = {
 };
 
 inline constexpr const char *STACKED_PAWN_POSITIONS[] = {
-    "8/p6p/p6p/8/8/P6P/P6P/8 b - - - -",
+    "8/p6p/p6p/8/8/P6P/P6P/8 b - - 0 1",
 };
 
 inline constexpr const char *ISOLATED_PAWN_POSITIONS[] = {
-    "8/p1p1p1pp/8/8/8/8/P1P1P1PP/8 b - - - -",
+    "8/p1p1p1pp/8/8/8/8/P1P1P1PP/8 b - - 0 1",
 };
 
 inline constexpr const char *PASSED_PAWN_POSITIONS[] = {
-    "8/8/8/P1P5/5p1p/8/8/8 b - - - -",
+    "8/8/8/P1P5/5p1p/8/8/8 b - - 0 1",
 };
 
 inline constexpr const char *SEMI_OPEN_FILE_POSITIONS[] = {
@@ -0,0 +1,487 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#include "engine/board/Piece.hpp"
+#include "engine/board/Colour.hpp"
+#include "engine/board/Castle.hpp"
+
+#include "utility/BitUtility.hpp"
+#include "utility/BoardUtility.hpp"
+#include "utility/AttackUtility.hpp"
+
+// Single pass FEN reading and writing without allocations, for bulk ingestion
+// https://www.chessprogramming.org/Forsyth-Edwards_Notation
+namespace engine::board::FenCodec {
+
+enum class FenError : uint8_t {
+    NONE,
+    BOARD,
+    KINGS,
+    PAWNS,
+    SIDE,
+    CHECK,
+    CASTLE_RIGHTS,
+    EN_PASSANT,
+    HALF_MOVE,
+    FULL_MOVE,
+    TRAILING,
+};
+
+// clang-format off
+inline constexpr const char *ERROR_NAMES[] = {
+    "none",
+    "board",
+    "kings",
+    "pawns",
+    "side to move",
+    "check",
+    "castle rights",
+    "en passant square",
+    "half move clock",
+    "full move number",
+    "trailing characters",
+};
+// clang-format on
+
+// Longest possible FEN with a terminator: full board, all castle rights and five digit counters
+inline constexpr size_t MAX_SIZE = 96;
+
+struct FenPosition {
+    uint64_t bitboards[2][6];
+
+    uint8_t castleRights;
+
+    // -1 when none
+    int enPassantSquare;
+
+    engine::board::ColourType side;
+
+    uint16_t halfMove;
+    uint16_t fullMove;
+};
+
+struct FenResult {
+    FenError error;
+
+    // Of the first character that could not be read, the end of the text for a missing field
+    size_t offset;
+};
+
+[[nodiscard]] inline FenResult parse(std::string_view fen, FenPosition &position);
+
+[[nodiscard]] inline size_t write(const FenPosition &position, char *buffer, size_t size);
+
+[[nodiscard]] inline int getPiece(char letter);
+
+[[nodiscard]] inline size_t skipSpaces(std::string_view fen, size_t index);
+
+[[nodiscard]] inline bool isFieldEnd(std::string_view fen, size_t index);
+
+[[nodiscard]] inline bool isSpace(char letter);
+
+[[nodiscard]] inline bool isOtherKingAttacked(FenPosition &position);
+
+[[nodiscard]] inline bool isCastleValid(const FenPosition &position, int castle);
+
+[[nodiscard]] inline bool isEnPassantValid(const FenPosition &position, int square);
+
+[[nodiscard]] inline uint64_t getOccupancy(const FenPosition &position);
+
+[[nodiscard]] inline bool parseCounter(std::string_view fen, size_t &index, uint16_t &counter);
+
+inline char *writeCounter(char *output, uint16_t counter);
+
+// EPD style text without the move counters reads as "0 1". Rejects positions that can not arise in a game as far as a cheap test tells, which needs the piece attack tables, see Engine::initialise
+[[nodiscard]] inline FenResult parse(std::string_view fen, FenPosition &position) {
+    std::memset(position.bitboards, 0, sizeof(position.bitboards));
+
+    position.castleRights = 0;
+    position.enPassantSquare = -1;
+    position.side = engine::board::ColourType::WHITE;
+    position.halfMove = 0;
+    position.fullMove = 1;
+
+    size_t index = skipSpaces(fen, 0);
+
+    int rank = 7;
+    int file = 0;
+
+    for (; !isFieldEnd(fen, index); ++index) {
+        const char letter = fen[index];
+
+        if (letter == '/') {
+            if (file != 8 || rank == 0) {
+                return { FenError::BOARD, index };
+            }
+
+            --rank;
+            file = 0;
+        } else if (letter >= '1' && letter <= '8') {
+            file += letter - '0';
+
+            if (file > 8) {
+                return { FenError::BOARD, index };
+            }
+        } else {
+            const int piece = getPiece(letter);
+
+            if (piece == engine::board::PieceType::EMPTY || file == 8) {
+                return { FenError::BOARD, index };
+            }
+
+            const int colour = (letter < 'a') ? engine::board::ColourType::WHITE : engine::board::ColourType::BLACK;
+
+            utility::BitUtility::setBit(position.bitboards[colour][piece], (rank << 3) | file);
+
+            ++file;
+        }
+    }
+
+    if (rank != 0 || file != 8) {
+        return { FenError::BOARD, index };
+    }
+
+    if (utility::BitUtility::popCount(position.bitboards[engine::board::ColourType::WHITE][engine::board::PieceType::KING]) != 1 || utility::BitUtility::popCount(position.bitboards[engine::board::ColourType::BLACK][engine::board::PieceType::KING]) != 1) {
+        return { FenError::KINGS, 0 };
+    }
+
+    // First and eighth ranks
+    if ((position.bitboards[engine::board::ColourType::WHITE][engine::board::PieceType::PAWN] | position.bitboards[engine::board::ColourType::BLACK][engine::board::PieceType::PAWN]) & 0xFF000000000000FFULL) {
+        return { FenError::PAWNS, 0 };
+    }
+
+    index = skipSpaces(fen, index);
+
+    if (index >= fen.size() || (fen[index] != 'w' && fen[index] != 'b') || !isFieldEnd(fen, index + 1)) {
+        return { FenError::SIDE, index };
+    }
+
+    position.side = (fen[index] == 'w') ? engine::board::ColourType::WHITE : engine::board::ColourType::BLACK;
+
+    if (isOtherKingAttacked(position)) {
+        return { FenError::CHECK, index };
+    }
+
+    index = skipSpaces(fen, index + 1);
+
+    if (index >= fen.size()) {
+        return { FenError::CASTLE_RIGHTS, index };
+    }
+
+    if (fen[index] == '-') {
+        ++index;
+    } else {
+        for (; !isFieldEnd(fen, index); ++index) {
+            int castle = 0;
+
+            switch (fen[index]) {
+            case 'K':
+                castle = Castle::WHITE_KING;
+                break;
+            case 'Q':
+                castle = Castle::WHITE_QUEEN;
+                break;
+            case 'k':
+                castle = Castle::BLACK_KING;
+                break;
+            case 'q':
+                castle = Castle::BLACK_QUEEN;
+                break;
+            default:
+                return { FenError::CASTLE_RIGHTS, index };
+            }
+
+            if (!isCastleValid(position, castle)) {
+                return { FenError::CASTLE_RIGHTS, index };
+            }
+
+            position.castleRights |= CASTLE_MASK[castle];
+        }
+    }
+
+    if (!isFieldEnd(fen, index)) {
+        return { FenError::CASTLE_RIGHTS, index };
+    }
+
+    index = skipSpaces(fen, index);
+
+    if (index >= fen.size()) {
+        return { FenError::EN_PASSANT, index };
+    }
+
+    if (fen[index] == '-') {
+        ++index;
+    } else {
+        if (index + 1 >= fen.size() || fen[index] < 'a' || fen[index] > 'h' || (fen[index + 1] != '3' && fen[index + 1] != '6')) {
+            return { FenError::EN_PASSANT, index };
+        }
+
+        const int square = ((fen[index + 1] - '1') << 3) | (fen[index] - 'a');
+
+        if (!isEnPassantValid(position, square)) {
+            return { FenError::EN_PASSANT, index };
+        }
+
+        position.enPassantSquare = square;
+
+        index += 2;
+    }
+
+    if (!isFieldEnd(fen, index)) {
+        return { FenError::EN_PASSANT, index };
+    }
+
+    index = skipSpaces(fen, index);
+
+    if (index < fen.size()) {
+        if (!parseCounter(fen, index, position.halfMove)) {
+            return { FenError::HALF_MOVE, index };
+        }
+
+        if (!isFieldEnd(fen, index)) {
+            return { FenError::HALF_MOVE, index };
+        }
+
+        index = skipSpaces(fen, index);
+    }
+
+    if (index < fen.size()) {
+        if (!parseCounter(fen, index, position.fullMove)) {
+            return { FenError::FULL_MOVE, index };
+        }
+
+        if (!isFieldEnd(fen, index)) {
+            return { FenError::FULL_MOVE, index };
+        }
+
+        index = skipSpaces(fen, index);
+    }
+
+    if (index < fen.size()) {
+        return { FenError::TRAILING, index };
+    }
+
+    return { FenError::NONE, index };
+}
+
+// Null terminated, returns the length or zero when the buffer is too small
+[[nodiscard]] inline size_t write(const FenPosition &position, char *buffer, size_t size) {
+    constexpr char LETTERS[2][6] = { { 'P', 'N', 'B', 'R', 'Q', 'K' }, { 'p', 'n', 'b', 'r', 'q', 'k' } };
+
+    char board[64] = {};
+
+    for (int colour = engine::board::ColourType::WHITE; colour <= engine::board::ColourType::BLACK; ++colour) {
+        for (int piece = engine::board::PieceType::PAWN; piece <= engine::board::PieceType::KING; ++piece) {
+            uint64_t bitboard = position.bitboards[colour][piece];
+
+            while (bitboard) {
+                board[utility::BitUtility::popLSB(bitboard)] = LETTERS[colour][piece];
+            }
+        }
+    }
+
+    char fen[MAX_SIZE];
+
+    char *output = fen;
+
+    for (int rank = 7; rank >= 0; --rank) {
+        int empty = 0;
+
+        for (int file = 0; file < 8; ++file) {
+            const char letter = board[(rank << 3) | file];
+
+            if (letter == 0) {
+                ++empty;
+
+                continue;
+            }
+
+            if (empty > 0) {
+                *output++ = static_cast<char>('0' + empty);
+
+                empty = 0;
+            }
+
+            *output++ = letter;
+        }
+
+        if (empty > 0) {
+            *output++ = static_cast<char>('0' + empty);
+        }
+
+        if (rank > 0) {
+            *output++ = '/';
+        }
+    }
+
+    *output++ = ' ';
+    *output++ = (position.side == engine::board::ColourType::WHITE) ? 'w' : 'b';
+    *output++ = ' ';
+
+    if (position.castleRights == 0) {
+        *output++ = '-';
+    } else {
+        constexpr char CASTLE_LETTERS[4] = { 'K', 'Q', 'k', 'q' };
+        constexpr Castle CASTLES[4] = { Castle::WHITE_KING, Castle::WHITE_QUEEN, Castle::BLACK_KING, Castle::BLACK_QUEEN };
+
+        for (int i = 0; i < 4; ++i) {
+            if (position.castleRights & CASTLE_MASK[CASTLES[i]]) {
+                *output++ = CASTLE_LETTERS[i];
+            }
+        }
+    }
+
+    *output++ = ' ';
+
+    if (position.enPassantSquare == -1) {
+        *output++ = '-';
+    } else {
+        *output++ = static_cast<char>('a' + (position.enPassantSquare & 7));
+        *output++ = static_cast<char>('1' + (position.enPassantSquare >> 3));
+    }
+
+    *output++ = ' ';
+
+    output = writeCounter(output, position.halfMove);
+
+    *output++ = ' ';
+
+    output = writeCounter(output, position.fullMove);
+
+    const size_t length = static_cast<size_t>(output - fen);
+
+    if (length + 1 > size) {
+        return 0;
+    }
+
+    std::memcpy(buffer, fen, length);
+
+    buffer[length] = '\0';
+
+    return length;
+}
+
+// engine::board::PieceType, EMPTY for anything that is not a piece letter
+[[nodiscard]] inline int getPiece(char letter) {
+    switch (letter | 0x20) {
+    case 'p':
+        return engine::board::PieceType::PAWN;
+    case 'n':
+        return engine::board::PieceType::KNIGHT;
+    case 'b':
+        return engine::board::PieceType::BISHOP;
+    case 'r':
+        return engine::board::PieceType::ROOK;
+    case 'q':
+        return engine::board::PieceType::QUEEN;
+    case 'k':
+        return engine::board::PieceType::KING;
+    default:
+        return engine::board::PieceType::EMPTY;
+    }
+}
+
+[[nodiscard]] inline size_t skipSpaces(std::string_view fen, size_t index) {
+    while (index < fen.size() && isSpace(fen[index])) {
+        ++index;
+    }
+
+    return index;
+}
+
+[[nodiscard]] inline bool isFieldEnd(std::string_view fen, size_t index) {
+    return index >= fen.size() || isSpace(fen[index]);
+}
+
+[[nodiscard]] inline bool isSpace(char letter) {
+    return letter == ' ' || letter == '\t' || letter == '\r' || letter == '\n' || letter == '\v' || letter == '\f';
+}
+
+// The side to move could capture the king
+[[nodiscard]] inline bool isOtherKingAttacked(FenPosition &position) {
+    const engine::board::ColourType otherSide = utility::BoardUtility::getOtherSide(position.side);
+
+    const int kingSquare = utility::BitUtility::getLSBIndex(position.bitboards[otherSide][engine::board::PieceType::KING]);
+
+    return utility::AttackUtility::getAttackersToSquare(kingSquare, position.bitboards, getOccupancy(position), position.side) != 0ULL;
+}
+
+// The king and the rook are still on their origin squares
+[[nodiscard]] inline bool isCastleValid(const FenPosition &position, int castle) {
+    const int colour = castle >> 1;
+
+    return utility::BitUtility::isBitSet(position.bitboards[colour][engine::board::PieceType::KING], KING_ORIGIN_SQUARES[colour]) && utility::BitUtility::isBitSet(position.bitboards[colour][engine::board::PieceType::ROOK], ROOK_ORIGIN_SQUARES[castle]);
+}
+
+// The other side just pushed a pawn two squares past this one, making and unmaking the capture assume that pawn is there
+[[nodiscard]] inline bool isEnPassantValid(const FenPosition &position, int square) {
+    const bool isWhite = position.side == engine::board::ColourType::WHITE;
+
+    if ((square >> 3) != (isWhite ? 5 : 2)) {
+        return false;
+    }
+
+    const int pawnSquare = isWhite ? square - 8 : square + 8;
+    const int originSquare = isWhite ? square + 8 : square - 8;
+
+    const uint64_t occupancy = getOccupancy(position);
+
+    return utility::BitUtility::isBitSet(position.bitboards[utility::BoardUtility::getOtherSide(position.side)][engine::board::PieceType::PAWN], pawnSquare) && !utility::BitUtility::isBitSet(occupancy, square) && !utility::BitUtility::isBitSet(occupancy, originSquare);
+}
+
+[[nodiscard]] inline uint64_t getOccupancy(const FenPosition &position) {
+    uint64_t occupancy = 0ULL;
+
+    for (int colour = engine::board::ColourType::WHITE; colour <= engine::board::ColourType::BLACK; ++colour) {
+        for (int piece = engine::board::PieceType::PAWN; piece <= engine::board::PieceType::KING; ++piece) {
+            occupancy |= position.bitboards[colour][piece];
+        }
+    }
+
+    return occupancy;
+}
+
+// Decimal up to 65535
+[[nodiscard]] inline bool parseCounter(std::string_view fen, size_t &index, uint16_t &counter) {
+    uint32_t value = 0;
+
+    const size_t start = index;
+
+    while (index < fen.size() && fen[index] >= '0' && fen[index] <= '9') {
+        value = value * 10 + static_cast<uint32_t>(fen[index] - '0');
+
+        if (value > UINT16_MAX) {
+            return false;
+        }
+
+        ++index;
+    }
+
+    counter = static_cast<uint16_t>(value);
+
+    return index > start;
+}
+
+inline char *writeCounter(char *output, uint16_t counter) {
+    char digits[5];
+
+    int size = 0;
+
+    do {
+        digits[size++] = static_cast<char>('0' + counter % 10);
+
+        counter /= 10;
+    } while (counter > 0);
+
+    while (size > 0) {
+        *output++ = digits[--size];
+    }
+
+    return output;
+}
+
+} // namespace engine::board::FenCodec
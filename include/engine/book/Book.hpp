@@ -0,0 +1,87 @@
+#pragma once
+
+#include <string>
+#include <random>
+#include <cstddef>
+#include <cstdint>
+
+#include "engine/board/Piece.hpp"
+
+#include "utility/MappedFile.hpp"
+
+// http://hgm.nubati.net/book_format.html
+namespace engine::book {
+
+inline constexpr const char *BOOK_PATH = "resources/books/book.bin";
+
+// Encoding (polyglot):
+// to square: 0-5, from square: 6-11
+// promotion piece: 12-14 (0 none, 1 knight, 2 bishop, 3 rook, 4 queen)
+inline constexpr uint16_t TO_MASK = 0b0000000000111111;
+inline constexpr uint16_t FROM_MASK = 0b0000111111000000;
+inline constexpr uint16_t PROMOTION_MASK = 0b0111000000000000;
+
+inline constexpr int FROM_OFFSET = 6;
+inline constexpr int PROMOTION_OFFSET = 12;
+
+// Stored big-endian on disk, sorted by key
+struct Entry {
+    uint64_t key;
+
+    uint16_t move;
+    uint16_t weight;
+
+    uint32_t learn;
+};
+
+static_assert(sizeof(Entry) == 16, "Polyglot entries must be 16 bytes");
+
+[[nodiscard]] inline constexpr int getFrom(uint16_t move) {
+    return (move & FROM_MASK) >> FROM_OFFSET;
+}
+
+[[nodiscard]] inline constexpr int getTo(uint16_t move) {
+    return move & TO_MASK;
+}
+
+// Polyglot promotion pieces line up with the engine's piece types
+[[nodiscard]] inline constexpr engine::board::PieceType getPromotionPiece(uint16_t move) {
+    int promotion = (move & PROMOTION_MASK) >> PROMOTION_OFFSET;
+
+    return (promotion == 0) ? engine::board::PieceType::EMPTY : static_cast<engine::board::PieceType>(promotion);
+}
+
+class Book {
+  public:
+    Book();
+
+    Book(const Book &) = delete;
+
+    Book &operator=(const Book &) = delete;
+
+    bool open(const std::string &path);
+
+    void close();
+
+    bool isOpen() const;
+
+    size_t size() const;
+
+    // The caller owns the generator, so engines sharing a book never share its state
+    uint16_t getMove(uint64_t key, std::mt19937 &generator) const;
+
+  private:
+    utility::MappedFile _file;
+
+    const Entry *_entries;
+
+    size_t _size;
+
+    size_t getFirstIndex(uint64_t key) const;
+
+    uint64_t getKey(size_t index) const;
+
+    uint16_t getWeight(size_t index) const;
+};
+
+} // namespace engine::book
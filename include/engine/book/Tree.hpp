@@ -0,0 +1,74 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#include "utility/MappedFile.hpp"
+
+namespace engine::book {
+
+// One move from one position, sorted by key then move on disk in native byte order
+struct TreeEntry {
+    // Polyglot key of the position the move was played from
+    uint64_t key;
+
+    // Engine encoding, legal in the keyed position
+    uint16_t move;
+
+    uint16_t padding;
+
+    uint32_t whiteWins;
+    uint32_t draws;
+    uint32_t blackWins;
+};
+
+static_assert(sizeof(TreeEntry) == 24, "Tree entries are read and written as raw 24 byte blocks");
+
+[[nodiscard]] inline bool isTreeEntryBefore(const TreeEntry &entry, const TreeEntry &otherEntry);
+
+[[nodiscard]] inline uint64_t getTreeGames(const TreeEntry &entry);
+
+[[nodiscard]] inline bool isTreeEntryBefore(const TreeEntry &entry, const TreeEntry &otherEntry) {
+    return (entry.key != otherEntry.key) ? entry.key < otherEntry.key : entry.move < otherEntry.move;
+}
+
+[[nodiscard]] inline uint64_t getTreeGames(const TreeEntry &entry) {
+    return static_cast<uint64_t>(entry.whiteWins) + entry.draws + entry.blackWins;
+}
+
+// Maps an index built by TreeBuilder read-only, a lookup touches a handful of pages
+class Tree {
+  public:
+    Tree();
+
+    Tree(const Tree &) = delete;
+
+    Tree &operator=(const Tree &) = delete;
+
+    bool open(const std::string &path);
+
+    void close();
+
+    bool isOpen() const;
+
+    size_t size() const;
+
+    // Moves played from the position, most played first
+    std::vector<TreeEntry> getEntries(uint64_t key) const;
+
+  private:
+    // Interpolation steps before falling back to bisection, uniform keys need far fewer
+    static inline constexpr int _INTERPOLATION_STEPS = 8;
+
+    utility::MappedFile _file;
+
+    const TreeEntry *_entries;
+
+    size_t _size;
+
+    size_t getFirstIndex(uint64_t key) const;
+};
+
+} // namespace engine::book
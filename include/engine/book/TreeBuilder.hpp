@@ -0,0 +1,88 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+
+#include "engine/book/Tree.hpp"
+
+namespace engine::book {
+
+// A sorted run on disk read back a block at a time during the merge
+struct TreeRun {
+    std::ifstream file;
+
+    std::vector<TreeEntry> buffer;
+
+    // Read at a time, the memory budget shared between the runs
+    size_t blockEntries;
+
+    size_t index;
+};
+
+// Aggregates (key, move) results within a memory budget, spilling sorted runs to disk and merging them into the index, so databases larger than memory can be indexed
+class TreeBuilder {
+  public:
+    TreeBuilder(const std::string &path, size_t memoryBytes);
+
+    ~TreeBuilder();
+
+    TreeBuilder(const TreeBuilder &) = delete;
+
+    TreeBuilder &operator=(const TreeBuilder &) = delete;
+
+    // Not thread safe, callers adding from several threads serialise
+    bool add(const TreeEntry *entries, size_t count);
+
+    // Writes the index, nothing can be added afterwards
+    bool finish();
+
+    // Entries in the finished index
+    uint64_t size() const;
+
+    size_t runs() const;
+
+  private:
+    // Smallest block read from a run while merging, however many runs share the memory budget
+    static inline constexpr size_t _MIN_BLOCK_ENTRIES = 1 << 10;
+
+    // Runs merged at once, more would run into the open file limit, so larger builds merge in passes
+    static inline constexpr size_t _MAX_FAN_IN = 64;
+
+    std::string _path;
+
+    std::vector<TreeEntry> _buffer;
+
+    size_t _capacity;
+
+    std::vector<std::string> _runPaths;
+
+    // Numbers run files, merge passes add runs after others were removed
+    size_t _nextRun;
+
+    uint64_t _size;
+
+    bool _isFailed;
+
+    bool flush();
+
+    bool writeRun();
+
+    bool merge();
+
+    bool mergeRuns(const std::vector<std::string> &paths, const std::string &outputPath, uint64_t &size);
+
+    std::string getRunPath();
+
+    void removeRuns();
+
+    static void aggregate(std::vector<TreeEntry> &entries);
+
+    static void addCounts(TreeEntry &entry, const TreeEntry &otherEntry);
+
+    static bool readRun(TreeRun &run, TreeEntry &entry);
+};
+
+} // namespace engine::book
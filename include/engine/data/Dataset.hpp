@@ -0,0 +1,94 @@
+#pragma once
+
+#include <deque>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <condition_variable>
+
+#include "engine/data/Record.hpp"
+
+#include "utility/MappedFile.hpp"
+
+namespace engine::data {
+
+struct DatasetSettings {
+    // Records handed out at a time
+    size_t chunkSize;
+
+    // Chunks are visited in a new random order every pass and the records inside each chunk are shuffled
+    bool isShuffled;
+
+    // Chunks the background thread keeps ready, none reads on the caller's thread
+    size_t prefetchChunks;
+
+    uint64_t seed;
+};
+
+// Maps a record file read-only and hands it out a chunk at a time, pages are faulted in by the prefetch thread instead of the consumer
+class Dataset {
+  public:
+    explicit Dataset(const DatasetSettings &settings);
+
+    ~Dataset();
+
+    Dataset(const Dataset &) = delete;
+
+    Dataset &operator=(const Dataset &) = delete;
+
+    bool open(const std::string &path);
+
+    void close();
+
+    bool isOpen() const;
+
+    // False once every chunk of the pass has been handed out
+    bool next(std::vector<Record> &chunk);
+
+    // Starts a new pass, reshuffled when shuffling
+    void rewind();
+
+    size_t size() const;
+
+    size_t chunks() const;
+
+  private:
+    DatasetSettings _settings;
+
+    utility::MappedFile _file;
+
+    const Record *_records;
+
+    size_t _size;
+
+    std::mt19937_64 _generator;
+
+    // Chunk indices in the order of the current pass
+    std::vector<size_t> _order;
+
+    // Next position in _order to load
+    size_t _nextChunk;
+
+    std::deque<std::vector<Record>> _ready;
+
+    std::thread _prefetcher;
+
+    std::mutex _mutex;
+
+    std::condition_variable _chunkReady;
+    std::condition_variable _chunkTaken;
+
+    bool _isStopped;
+
+    void prefetch(uint64_t seed);
+
+    void stopPrefetch();
+
+    void load(size_t chunk, std::vector<Record> &records, std::mt19937_64 &generator) const;
+};
+
+} // namespace engine::data
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <fstream>
+
+#include "engine/data/Record.hpp"
+
+namespace engine::data {
+
+// Streams records in large blocks, the file never has to fit in memory
+class Reader {
+  public:
+    Reader();
+
+    Reader(const Reader &) = delete;
+
+    Reader &operator=(const Reader &) = delete;
+
+    bool open(const std::string &path);
+
+    void close();
+
+    bool isOpen() const;
+
+    bool read(Record &record);
+
+    size_t read(Record *records, size_t count);
+
+    void rewind();
+
+    size_t size() const;
+
+  private:
+    static inline constexpr size_t _BUFFER_RECORDS = 1 << 14;
+
+    std::ifstream _file;
+
+    std::vector<Record> _buffer;
+
+    size_t _index;
+
+    size_t _size;
+
+    bool fill();
+};
+
+} // namespace engine::data
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <cstdint>
+
+#include "engine/board/Piece.hpp"
+#include "engine/board/Colour.hpp"
+
+#include "utility/BitUtility.hpp"
+
+namespace engine::data {
+
+enum Result : uint8_t {
+    BLACK_WIN = 0,
+    DRAW = 1,
+    WHITE_WIN = 2,
+};
+
+inline constexpr uint8_t NO_EN_PASSANT = 64;
+
+// Fixed size training record, pieces are 4 bit codes (colour << 3 | piece) in square order of the occupancy
+struct Record {
+    uint64_t occupancy;
+
+    uint8_t pieces[16];
+
+    // Side to move in bit 7, castle rights in bits 0 - 3
+    uint8_t flags;
+
+    uint8_t enPassantSquare;
+    uint8_t halfMove;
+
+    // engine::data::Result
+    uint8_t result;
+
+    // Search score from white's point of view
+    int16_t score;
+
+    uint16_t fullMove;
+};
+
+static_assert(sizeof(Record) == 32, "Records are read and written as raw 32 byte blocks");
+
+inline void encode(Record &record, const uint64_t bitboards[2][6], uint8_t castleRights, int enPassantSquare, engine::board::ColourType side, uint16_t halfMove, uint16_t fullMove);
+
+inline void decode(const Record &record, uint64_t bitboards[2][6], uint8_t &castleRights, int &enPassantSquare, engine::board::ColourType &side, uint16_t &halfMove, uint16_t &fullMove);
+
+[[nodiscard]] inline bool isValid(const Record &record);
+
+// Lossless for anything the engine can reach, only a half move clock beyond 255 is clamped. Positions have at most 32 pieces, so the nibbles always fit
+inline void encode(Record &record, const uint64_t bitboards[2][6], uint8_t castleRights, int enPassantSquare, engine::board::ColourType side, uint16_t halfMove, uint16_t fullMove) {
+    record = Record{};
+
+    uint8_t codes[64] = {};
+
+    for (int colour = engine::board::ColourType::WHITE; colour <= engine::board::ColourType::BLACK; ++colour) {
+        for (int piece = engine::board::PieceType::PAWN; piece <= engine::board::PieceType::KING; ++piece) {
+            uint64_t bitboard = bitboards[colour][piece];
+
+            while (bitboard) {
+                int square = utility::BitUtility::popLSB(bitboard);
+
+                codes[square] = static_cast<uint8_t>((colour << 3) | piece);
+
+                utility::BitUtility::setBit(record.occupancy, square);
+            }
+        }
+    }
+
+    uint64_t occupancy = record.occupancy;
+
+    for (int i = 0; occupancy && i < 32; ++i) {
+        int square = utility::BitUtility::popLSB(occupancy);
+
+        record.pieces[i >> 1] |= static_cast<uint8_t>(codes[square] << ((i & 1) << 2));
+    }
+
+    record.flags = static_cast<uint8_t>((side << 7) | (castleRights & 0xF));
+    record.enPassantSquare = (enPassantSquare == -1) ? NO_EN_PASSANT : static_cast<uint8_t>(enPassantSquare);
+    record.halfMove = static_cast<uint8_t>(halfMove > 255 ? 255 : halfMove);
+    record.fullMove = fullMove;
+}
+
+inline void decode(const Record &record, uint64_t bitboards[2][6], uint8_t &castleRights, int &enPassantSquare, engine::board::ColourType &side, uint16_t &halfMove, uint16_t &fullMove) {
+    for (int colour = engine::board::ColourType::WHITE; colour <= engine::board::ColourType::BLACK; ++colour) {
+        for (int piece = engine::board::PieceType::PAWN; piece <= engine::board::PieceType::KING; ++piece) {
+            bitboards[colour][piece] = 0ULL;
+        }
+    }
+
+    uint64_t occupancy = record.occupancy;
+
+    for (int i = 0; occupancy && i < 32; ++i) {
+        int square = utility::BitUtility::popLSB(occupancy);
+
+        uint8_t code = (record.pieces[i >> 1] >> ((i & 1) << 2)) & 0xF;
+
+        utility::BitUtility::setBit(bitboards[code >> 3][code & 0x7], square);
+    }
+
+    castleRights = record.flags & 0xF;
+    enPassantSquare = (record.enPassantSquare == NO_EN_PASSANT) ? -1 : record.enPassantSquare;
+    side = static_cast<engine::board::ColourType>(record.flags >> 7);
+    halfMove = record.halfMove;
+    fullMove = record.fullMove;
+}
+
+// Whether decoding is safe, for files that may be corrupt or written by other tools
+[[nodiscard]] inline bool isValid(const Record &record) {
+    const int pieces = utility::BitUtility::popCount(record.occupancy);
+
+    if (pieces > 32 || (record.flags & 0x70) != 0 || record.result > Result::WHITE_WIN) {
+        return false;
+    }
+
+    // Third or sixth rank
+    if (record.enPassantSquare != NO_EN_PASSANT && (record.enPassantSquare >> 3) != 2 && (record.enPassantSquare >> 3) != 5) {
+        return false;
+    }
+
+    int kings[2] = { 0, 0 };
+
+    for (int i = 0; i < pieces; ++i) {
+        uint8_t code = (record.pieces[i >> 1] >> ((i & 1) << 2)) & 0xF;
+
+        if ((code & 0x7) > engine::board::PieceType::KING) {
+            return false;
+        }
+
+        kings[code >> 3] += ((code & 0x7) == engine::board::PieceType::KING);
+    }
+
+    return kings[engine::board::ColourType::WHITE] == 1 && kings[engine::board::ColourType::BLACK] == 1;
+}
+
+} // namespace engine::data
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <fstream>
+
+#include "engine/data/Record.hpp"
+
+namespace engine::data {
+
+// Appends records to a headerless file, so files from several runs can simply be concatenated
+class Writer {
+  public:
+    Writer();
+
+    ~Writer();
+
+    Writer(const Writer &) = delete;
+
+    Writer &operator=(const Writer &) = delete;
+
+    bool open(const std::string &path);
+
+    void close();
+
+    bool isOpen() const;
+
+    void write(const Record &record);
+
+    void write(const Record *records, size_t count);
+
+    void flush();
+
+    size_t size() const;
+
+  private:
+    static inline constexpr size_t _BUFFER_RECORDS = 1 << 14;
+
+    std::ofstream _file;
+
+    std::vector<Record> _buffer;
+
+    size_t _size;
+};
+
+} // namespace engine::data
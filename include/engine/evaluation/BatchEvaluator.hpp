@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+
+#include "engine/data/Record.hpp"
+
+namespace engine::evaluation {
+
+// Static evaluation of packed positions in bulk, without decoding each one into an engine, e.g. for filtering data sets
+class BatchEvaluator {
+  public:
+    explicit BatchEvaluator(int threads);
+
+    // Scores from the side to move's point of view, equal to Engine::getEvaluation after unpacking the record, records with an unknown piece or without one king a side score zero
+    void evaluate(const engine::data::Record *records, size_t count, int *scores) const;
+
+  private:
+    // Positions decoded into the structure of arrays at a time, small enough to stay in the first level cache
+    static inline constexpr size_t _BLOCK_SIZE = 256;
+
+    // Positions handed to a thread at a time
+    static inline constexpr size_t _CHUNK_SIZE = 1 << 14;
+
+    int _threads;
+
+    static void evaluateBlock(const engine::data::Record *records, size_t count, int *scores);
+};
+
+} // namespace engine::evaluation
@@ -9,6 +9,9 @@ inline constexpr int CHECKMATE_SCORE = 49000;
 inline constexpr int CHECKMATE_OFFSET = 1000;
 inline constexpr int CHECKMATE_THRESHOLD = CHECKMATE_SCORE - CHECKMATE_OFFSET;
 
+// Won endgames score above any middlegame evaluation but below mate scores
+inline constexpr int KNOWN_WIN = 10000;
+
 [[nodiscard]] inline constexpr int getCheckMateScore(int ply);
 
 [[nodiscard]] inline constexpr int getCheckMateScore(int ply) {
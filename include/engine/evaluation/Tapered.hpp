@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstdint>
+
+#include "engine/board/Piece.hpp"
+#include "engine/board/Colour.hpp"
+
+#include "engine/evaluation/pesto/Phase.hpp"
+#include "engine/evaluation/pesto/Material.hpp"
+#include "engine/evaluation/pesto/Position.hpp"
+
+namespace engine::evaluation {
+
+// Opening score in the low 16 bits and endgame score in the high 16 bits, so both phases are summed in one add
+[[nodiscard]] inline constexpr int makeScore(int opening, int endgame);
+
+[[nodiscard]] inline constexpr int getOpeningScore(int score);
+
+[[nodiscard]] inline constexpr int getEndgameScore(int score);
+
+[[nodiscard]] inline constexpr int taper(int score, int phase);
+
+[[nodiscard]] inline constexpr int makeScore(int opening, int endgame) {
+    return static_cast<int>(static_cast<uint32_t>(endgame) << 16) + opening;
+}
+
+[[nodiscard]] inline constexpr int getOpeningScore(int score) {
+    return static_cast<int16_t>(static_cast<uint16_t>(static_cast<uint32_t>(score)));
+}
+
+// Rounds the borrow of a negative opening score back into the endgame half
+[[nodiscard]] inline constexpr int getEndgameScore(int score) {
+    return static_cast<int16_t>(static_cast<uint16_t>((static_cast<uint32_t>(score) + 0x8000U) >> 16));
+}
+
+// Promotions can push the phase above its starting value
+[[nodiscard]] inline constexpr int taper(int score, int phase) {
+    phase = (phase < pesto::MAX_PHASE) ? phase : pesto::MAX_PHASE;
+
+    return (getOpeningScore(score) * phase + getEndgameScore(score) * (pesto::MAX_PHASE - phase)) / pesto::MAX_PHASE;
+}
+
+struct PieceSquareScores {
+    int scores[2][6][64];
+};
+
+// Material and position from white's point of view, tables are laid out from a8 so white reads them mirrored
+[[nodiscard]] inline constexpr PieceSquareScores makePieceSquareScores() {
+    PieceSquareScores pieceSquareScores{};
+
+    for (int piece = engine::board::PieceType::PAWN; piece <= engine::board::PieceType::KING; ++piece) {
+        for (int square = 0; square < 64; ++square) {
+            const int whiteIndex = square ^ 56;
+
+            pieceSquareScores.scores[engine::board::ColourType::WHITE][piece][square] = makeScore(pesto::MATERIAL_VALUES[pesto::GamePhase::OPENING][piece] + pesto::POSITION_VALUES[pesto::GamePhase::OPENING][piece][whiteIndex], pesto::MATERIAL_VALUES[pesto::GamePhase::ENDGAME][piece] + pesto::POSITION_VALUES[pesto::GamePhase::ENDGAME][piece][whiteIndex]);
+
+            pieceSquareScores.scores[engine::board::ColourType::BLACK][piece][square] = -makeScore(pesto::MATERIAL_VALUES[pesto::GamePhase::OPENING][piece] + pesto::POSITION_VALUES[pesto::GamePhase::OPENING][piece][square], pesto::MATERIAL_VALUES[pesto::GamePhase::ENDGAME][piece] + pesto::POSITION_VALUES[pesto::GamePhase::ENDGAME][piece][square]);
+        }
+    }
+
+    return pieceSquareScores;
+}
+
+inline constexpr PieceSquareScores PIECE_SQUARE_SCORES = makePieceSquareScores();
+
+inline constexpr int STACKED_PAWN_SCORE = makeScore(pesto::STACKED_PAWN_PENALTY_PESTO[pesto::GamePhase::OPENING], pesto::STACKED_PAWN_PENALTY_PESTO[pesto::GamePhase::ENDGAME]);
+
+inline constexpr int ISOLATED_PAWN_SCORE = makeScore(pesto::ISOLATED_PAWN_PENALTY_PESTO[pesto::GamePhase::OPENING], pesto::ISOLATED_PAWN_PENALTY_PESTO[pesto::GamePhase::ENDGAME]);
+
+// clang-format off
+// Indexed by rank relative to the side
+inline constexpr int PASSED_PAWN_SCORES[8] = {
+    makeScore(pesto::PASSED_PAWN_BONUS_PESTO[0], pesto::PASSED_PAWN_BONUS_PESTO[0]),
+    makeScore(pesto::PASSED_PAWN_BONUS_PESTO[1], pesto::PASSED_PAWN_BONUS_PESTO[1]),
+    makeScore(pesto::PASSED_PAWN_BONUS_PESTO[2], pesto::PASSED_PAWN_BONUS_PESTO[2]),
+    makeScore(pesto::PASSED_PAWN_BONUS_PESTO[3], pesto::PASSED_PAWN_BONUS_PESTO[3]),
+    makeScore(pesto::PASSED_PAWN_BONUS_PESTO[4], pesto::PASSED_PAWN_BONUS_PESTO[4]),
+    makeScore(pesto::PASSED_PAWN_BONUS_PESTO[5], pesto::PASSED_PAWN_BONUS_PESTO[5]),
+    makeScore(pesto::PASSED_PAWN_BONUS_PESTO[6], pesto::PASSED_PAWN_BONUS_PESTO[6]),
+    makeScore(pesto::PASSED_PAWN_BONUS_PESTO[7], pesto::PASSED_PAWN_BONUS_PESTO[7]),
+};
+// clang-format on
+
+inline constexpr int SEMI_OPEN_FILE_SCORE = makeScore(pesto::SEMI_OPEN_FILE_SCORE_PESTO, pesto::SEMI_OPEN_FILE_SCORE_PESTO);
+
+inline constexpr int OPEN_FILE_SCORE = makeScore(pesto::OPEN_FILE_SCORE_PESTO, pesto::OPEN_FILE_SCORE_PESTO);
+
+inline constexpr int BISHOP_MOBILITY_SCORE = makeScore(pesto::BISHOP_MOBILITY_WEIGHT[pesto::GamePhase::OPENING], pesto::BISHOP_MOBILITY_WEIGHT[pesto::GamePhase::ENDGAME]);
+
+inline constexpr int QUEEN_MOBILITY_SCORE = makeScore(pesto::QUEEN_MOBILITY_WEIGHT[pesto::GamePhase::OPENING], pesto::QUEEN_MOBILITY_WEIGHT[pesto::GamePhase::ENDGAME]);
+
+inline constexpr int KING_SAFETY_SCORE = makeScore(pesto::KING_SAFETY_WEIGHT_PESTO, pesto::KING_SAFETY_WEIGHT_PESTO);
+
+} // namespace engine::evaluation
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstdint>
+
+#include "engine/board/Piece.hpp"
+#include "engine/board/Colour.hpp"
+#include "engine/board/Square.hpp"
+
+#include "engine/piece/King.hpp"
+#include "engine/piece/Queen.hpp"
+#include "engine/piece/Bishop.hpp"
+
+#include "engine/evaluation/Tapered.hpp"
+
+#include "engine/evaluation/pesto/Position.hpp"
+
+#include "utility/BitUtility.hpp"
+
+// Evaluation terms beyond material and position, shared by the engine and the batch evaluator
+namespace engine::evaluation {
+
+[[nodiscard]] inline int getTermScore(const uint64_t bitboards[2][6], const uint64_t occupancies[2], uint64_t occupancyBoth);
+
+// Packed (opening, endgame) from white's point of view, both colours go through the same terms so flags and counts multiply the weights instead of branching
+[[nodiscard]] inline int getTermScore(const uint64_t bitboards[2][6], const uint64_t occupancies[2], uint64_t occupancyBoth) {
+    int score = 0;
+
+    const uint64_t bothPawns = bitboards[engine::board::ColourType::WHITE][engine::board::PieceType::PAWN] | bitboards[engine::board::ColourType::BLACK][engine::board::PieceType::PAWN];
+
+    for (int colour = engine::board::ColourType::WHITE; colour <= engine::board::ColourType::BLACK; ++colour) {
+        const int sign = 1 - 2 * colour;
+
+        // Flips black squares so ranks are counted from the side's own back rank
+        const int flip = 56 * colour;
+
+        const uint64_t ownPawns = bitboards[colour][engine::board::PieceType::PAWN];
+        const uint64_t otherPawns = bitboards[colour ^ 1][engine::board::PieceType::PAWN];
+
+        int sideScore = 0;
+
+        uint64_t pieces = ownPawns;
+
+        while (pieces) {
+            int square = utility::BitUtility::popLSB(pieces);
+
+            int file = engine::board::FILE_FROM_SQUARE[square];
+
+            sideScore += ISOLATED_PAWN_SCORE * ((ownPawns & engine::board::ISOLATED_FILE_MASKS[file]) == 0ULL);
+            sideScore += PASSED_PAWN_SCORES[engine::board::RANK_FROM_SQUARE[square ^ flip]] * ((otherPawns & engine::board::PASSED_PAWN_MASKS[colour][square]) == 0ULL);
+            sideScore += STACKED_PAWN_SCORE * (utility::BitUtility::popCount(ownPawns & engine::board::FILE_MASKS[file]) - 1);
+        }
+
+        pieces = bitboards[colour][engine::board::PieceType::BISHOP];
+
+        while (pieces) {
+            int square = utility::BitUtility::popLSB(pieces);
+
+            sideScore += BISHOP_MOBILITY_SCORE * (utility::BitUtility::popCount(engine::piece::Bishop::getAttacks(square, occupancyBoth)) - pesto::BISHOP_OFFSET_VALUE);
+        }
+
+        pieces = bitboards[colour][engine::board::PieceType::ROOK];
+
+        while (pieces) {
+            int file = engine::board::FILE_FROM_SQUARE[utility::BitUtility::popLSB(pieces)];
+
+            sideScore += SEMI_OPEN_FILE_SCORE * ((ownPawns & engine::board::FILE_MASKS[file]) == 0ULL);
+            sideScore += OPEN_FILE_SCORE * ((bothPawns & engine::board::FILE_MASKS[file]) == 0ULL);
+        }
+
+        pieces = bitboards[colour][engine::board::PieceType::QUEEN];
+
+        while (pieces) {
+            int square = utility::BitUtility::popLSB(pieces);
+
+            sideScore += QUEEN_MOBILITY_SCORE * (utility::BitUtility::popCount(engine::piece::Queen::getAttacks(square, occupancyBoth)) - pesto::QUEEN_OFFSET_VALUE);
+        }
+
+        // Open files around the king are a liability, own pieces next to it shelter it
+        const int kingSquare = utility::BitUtility::getLSBIndex(bitboards[colour][engine::board::PieceType::KING]);
+        const int kingFile = engine::board::FILE_FROM_SQUARE[kingSquare];
+
+        sideScore -= SEMI_OPEN_FILE_SCORE * ((ownPawns & engine::board::FILE_MASKS[kingFile]) == 0ULL);
+        sideScore -= OPEN_FILE_SCORE * ((bothPawns & engine::board::FILE_MASKS[kingFile]) == 0ULL);
+        sideScore += KING_SAFETY_SCORE * utility::BitUtility::popCount(engine::piece::King::ATTACKS[kingSquare] & occupancies[colour]);
+
+        score += sign * sideScore;
+    }
+
+    return score;
+}
+
+} // namespace engine::evaluation
@@ -0,0 +1,294 @@
+#pragma once
+
+#include <cstdint>
+
+#include "engine/board/Piece.hpp"
+#include "engine/board/Colour.hpp"
+#include "engine/board/Square.hpp"
+
+#include "engine/evaluation/Score.hpp"
+#include "engine/evaluation/Material.hpp"
+
+#include "engine/evaluation/endgame/Kpk.hpp"
+
+#include "utility/BitUtility.hpp"
+#include "utility/BoardUtility.hpp"
+
+// Dedicated evaluators for endgames the search cannot resolve on its own, dispatched by material signature
+// https://www.chessprogramming.org/Material_Hash_Table
+namespace engine::evaluation::endgame {
+
+enum EndgameType : uint8_t {
+    NONE = 0,
+    KXK = 1,
+    KBNK = 2,
+    KBBK = 3,
+    KPK = 4,
+    DRAW = 5,
+};
+
+// Every recognised endgame has at most this many pieces, kings included
+inline constexpr int MAX_PIECES = 4;
+
+// 4 bits per piece count (kings are implied), white in the low 20 bits, black in the high 20 bits
+inline constexpr int MATERIAL_KEY_SIDE_OFFSET = 20;
+inline constexpr int MATERIAL_KEY_PIECE_OFFSET = 4;
+
+inline constexpr uint64_t MATERIAL_KEY_SIDE_MASK = (1ULL << MATERIAL_KEY_SIDE_OFFSET) - 1;
+
+// clang-format off
+// Drive the losing king to the edge
+inline constexpr int PUSH_TO_EDGE[64] = {
+    100, 90, 80, 70, 70, 80, 90, 100,
+     90, 70, 60, 50, 50, 60, 70,  90,
+     80, 60, 40, 30, 30, 40, 60,  80,
+     70, 50, 30, 20, 20, 30, 50,  70,
+     70, 50, 30, 20, 20, 30, 50,  70,
+     80, 60, 40, 30, 30, 40, 60,  80,
+     90, 70, 60, 50, 50, 60, 70,  90,
+    100, 90, 80, 70, 70, 80, 90, 100,
+};
+
+// Drive the losing king to a1 or h8, mirror the file for light squared bishops
+inline constexpr int PUSH_TO_CORNER[64] = {
+    200, 190, 180, 170, 160, 150, 140, 130,
+    190, 180, 170, 160, 150, 140, 130, 140,
+    180, 170, 155, 140, 140, 125, 140, 150,
+    170, 160, 140, 120, 110, 140, 150, 160,
+    160, 150, 140, 110, 120, 140, 160, 170,
+    150, 140, 125, 140, 140, 155, 170, 180,
+    140, 130, 140, 150, 160, 170, 180, 190,
+    130, 140, 150, 160, 170, 180, 190, 200,
+};
+// clang-format on
+
+// Indexed by the distance between the kings
+inline constexpr int PUSH_CLOSE[8] = { 0, 0, 100, 80, 60, 40, 20, 10 };
+
+inline constexpr uint64_t DARK_SQUARES = 0xAA55AA55AA55AA55ULL;
+
+// Won king and pawn endgames prefer pushing the pawn
+inline constexpr int KPK_RANK_BONUS = 20;
+
+struct Signature {
+    uint64_t materialKey;
+
+    EndgameType endgameType;
+};
+
+[[nodiscard]] inline constexpr uint64_t getMaterialKey(const char *code);
+
+[[nodiscard]] inline constexpr uint64_t getMaterialKey(const uint64_t bitboards[2][6]);
+
+[[nodiscard]] inline constexpr uint64_t getMirroredMaterialKey(uint64_t materialKey);
+
+[[nodiscard]] inline EndgameType getEndgameType(const uint64_t bitboards[2][6], engine::board::ColourType &strongSide);
+
+[[nodiscard]] inline int evaluateKXK(const uint64_t bitboards[2][6], engine::board::ColourType strongSide);
+
+[[nodiscard]] inline int evaluateKBNK(const uint64_t bitboards[2][6], engine::board::ColourType strongSide);
+
+[[nodiscard]] inline int evaluateKBBK(const uint64_t bitboards[2][6], engine::board::ColourType strongSide);
+
+[[nodiscard]] inline int evaluateKPK(const uint64_t bitboards[2][6], engine::board::ColourType strongSide, engine::board::ColourType side);
+
+[[nodiscard]] inline bool evaluate(const uint64_t bitboards[2][6], engine::board::ColourType side, int &score);
+
+// Codes list the strong side first, e.g. "KBNK" is white king, bishop and knight against a lone black king
+[[nodiscard]] inline constexpr uint64_t getMaterialKey(const char *code) {
+    uint64_t materialKey = 0ULL;
+
+    int side = -1;
+
+    for (const char *letter = code; *letter != '\0'; ++letter) {
+        int piece = 0;
+
+        switch (*letter) {
+        case 'K':
+            ++side;
+            continue;
+        case 'P':
+            piece = engine::board::PieceType::PAWN;
+            break;
+        case 'N':
+            piece = engine::board::PieceType::KNIGHT;
+            break;
+        case 'B':
+            piece = engine::board::PieceType::BISHOP;
+            break;
+        case 'R':
+            piece = engine::board::PieceType::ROOK;
+            break;
+        default:
+            piece = engine::board::PieceType::QUEEN;
+            break;
+        }
+
+        materialKey += 1ULL << (side * MATERIAL_KEY_SIDE_OFFSET + piece * MATERIAL_KEY_PIECE_OFFSET);
+    }
+
+    return materialKey;
+}
+
+[[nodiscard]] inline constexpr uint64_t getMaterialKey(const uint64_t bitboards[2][6]) {
+    uint64_t materialKey = 0ULL;
+
+    for (int side = 0; side < 2; ++side) {
+        for (int piece = engine::board::PieceType::PAWN; piece < engine::board::PieceType::KING; ++piece) {
+            uint64_t count = utility::BitUtility::popCount(bitboards[side][piece]);
+
+            materialKey += count << (side * MATERIAL_KEY_SIDE_OFFSET + piece * MATERIAL_KEY_PIECE_OFFSET);
+        }
+    }
+
+    return materialKey;
+}
+
+[[nodiscard]] inline constexpr uint64_t getMirroredMaterialKey(uint64_t materialKey) {
+    return (materialKey >> MATERIAL_KEY_SIDE_OFFSET) | ((materialKey & MATERIAL_KEY_SIDE_MASK) << MATERIAL_KEY_SIDE_OFFSET);
+}
+
+// clang-format off
+inline constexpr Signature SIGNATURES[] = {
+    { getMaterialKey("KQK"), EndgameType::KXK },
+    { getMaterialKey("KRK"), EndgameType::KXK },
+    { getMaterialKey("KBNK"), EndgameType::KBNK },
+    { getMaterialKey("KBBK"), EndgameType::KBBK },
+    { getMaterialKey("KPK"), EndgameType::KPK },
+    { getMaterialKey("KBK"), EndgameType::DRAW },
+    { getMaterialKey("KNK"), EndgameType::DRAW },
+    { getMaterialKey("KNNK"), EndgameType::DRAW },
+    { getMaterialKey("KK"), EndgameType::DRAW },
+};
+// clang-format on
+
+[[nodiscard]] inline EndgameType getEndgameType(const uint64_t bitboards[2][6], engine::board::ColourType &strongSide) {
+    uint64_t materialKey = getMaterialKey(bitboards);
+
+    for (const Signature &signature : SIGNATURES) {
+        if (materialKey == signature.materialKey) {
+            strongSide = engine::board::ColourType::WHITE;
+
+            return signature.endgameType;
+        }
+
+        if (materialKey == getMirroredMaterialKey(signature.materialKey)) {
+            strongSide = engine::board::ColourType::BLACK;
+
+            return signature.endgameType;
+        }
+    }
+
+    return EndgameType::NONE;
+}
+
+// Lone king against overwhelming material, mate it on the edge
+[[nodiscard]] inline int evaluateKXK(const uint64_t bitboards[2][6], engine::board::ColourType strongSide) {
+    engine::board::ColourType weakSide = utility::BoardUtility::getOtherSide(strongSide);
+
+    int strongKing = utility::BitUtility::getLSBIndex(bitboards[strongSide][engine::board::PieceType::KING]);
+    int weakKing = utility::BitUtility::getLSBIndex(bitboards[weakSide][engine::board::PieceType::KING]);
+
+    int score = Score::KNOWN_WIN;
+
+    for (int piece = engine::board::PieceType::PAWN; piece < engine::board::PieceType::KING; ++piece) {
+        score += MATERIAL_TABLE[piece] * utility::BitUtility::popCount(bitboards[strongSide][piece]);
+    }
+
+    score += PUSH_TO_EDGE[weakKing];
+    score += PUSH_CLOSE[utility::BoardUtility::getDistance(strongKing, weakKing)];
+
+    return score;
+}
+
+// Mate can only be forced in the corner of the bishop's colour
+[[nodiscard]] inline int evaluateKBNK(const uint64_t bitboards[2][6], engine::board::ColourType strongSide) {
+    engine::board::ColourType weakSide = utility::BoardUtility::getOtherSide(strongSide);
+
+    int strongKing = utility::BitUtility::getLSBIndex(bitboards[strongSide][engine::board::PieceType::KING]);
+    int weakKing = utility::BitUtility::getLSBIndex(bitboards[weakSide][engine::board::PieceType::KING]);
+
+    int cornerSquare = (bitboards[strongSide][engine::board::PieceType::BISHOP] & DARK_SQUARES) ? weakKing : (weakKing ^ 7);
+
+    int score = Score::KNOWN_WIN + MATERIAL_TABLE[engine::board::PieceType::BISHOP] + MATERIAL_TABLE[engine::board::PieceType::KNIGHT];
+
+    score += PUSH_TO_CORNER[cornerSquare];
+    score += PUSH_CLOSE[utility::BoardUtility::getDistance(strongKing, weakKing)];
+
+    return score;
+}
+
+// Bishops on the same colour cannot mate
+[[nodiscard]] inline int evaluateKBBK(const uint64_t bitboards[2][6], engine::board::ColourType strongSide) {
+    uint64_t bishops = bitboards[strongSide][engine::board::PieceType::BISHOP];
+
+    if (!(bishops & DARK_SQUARES) || !(bishops & ~DARK_SQUARES)) {
+        return 0;
+    }
+
+    return evaluateKXK(bitboards, strongSide);
+}
+
+// Normalise so the strong side is white with its pawn on files a-d, then probe the bitbase
+[[nodiscard]] inline int evaluateKPK(const uint64_t bitboards[2][6], engine::board::ColourType strongSide, engine::board::ColourType side) {
+    engine::board::ColourType weakSide = utility::BoardUtility::getOtherSide(strongSide);
+
+    int strongKing = utility::BitUtility::getLSBIndex(bitboards[strongSide][engine::board::PieceType::KING]);
+    int strongPawn = utility::BitUtility::getLSBIndex(bitboards[strongSide][engine::board::PieceType::PAWN]);
+    int weakKing = utility::BitUtility::getLSBIndex(bitboards[weakSide][engine::board::PieceType::KING]);
+
+    if (strongSide == engine::board::ColourType::BLACK) {
+        strongKing ^= 56;
+        strongPawn ^= 56;
+        weakKing ^= 56;
+    }
+
+    if (utility::BoardUtility::getFile(strongPawn) > 3) {
+        strongKing ^= 7;
+        strongPawn ^= 7;
+        weakKing ^= 7;
+    }
+
+    engine::board::ColourType normalisedSide = (side == strongSide) ? engine::board::ColourType::WHITE : engine::board::ColourType::BLACK;
+
+    if (!Kpk::probe(normalisedSide, strongKing, strongPawn, weakKing)) {
+        return 0;
+    }
+
+    return Score::KNOWN_WIN + MATERIAL_TABLE[engine::board::PieceType::PAWN] + utility::BoardUtility::getRank(strongPawn) * KPK_RANK_BONUS;
+}
+
+// Returns false if the material is not a recognised endgame, otherwise the score is relative to the side
+[[nodiscard]] inline bool evaluate(const uint64_t bitboards[2][6], engine::board::ColourType side, int &score) {
+    engine::board::ColourType strongSide = engine::board::ColourType::WHITE;
+
+    EndgameType endgameType = getEndgameType(bitboards, strongSide);
+
+    switch (endgameType) {
+    case EndgameType::NONE:
+        return false;
+    case EndgameType::KXK:
+        score = evaluateKXK(bitboards, strongSide);
+        break;
+    case EndgameType::KBNK:
+        score = evaluateKBNK(bitboards, strongSide);
+        break;
+    case EndgameType::KBBK:
+        score = evaluateKBBK(bitboards, strongSide);
+        break;
+    case EndgameType::KPK:
+        score = evaluateKPK(bitboards, strongSide, side);
+        break;
+    case EndgameType::DRAW:
+        score = 0;
+        break;
+    }
+
+    if (side != strongSide) {
+        score = -score;
+    }
+
+    return true;
+}
+
+} // namespace engine::evaluation::endgame
@@ -0,0 +1,186 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include "engine/board/Colour.hpp"
+
+#include "engine/piece/Pawn.hpp"
+#include "engine/piece/King.hpp"
+
+#include "utility/BitUtility.hpp"
+#include "utility/BoardUtility.hpp"
+
+// King and pawn versus king bitbase, generated by retrograde analysis
+// The strong side is always white and the pawn is always on files a-d
+// https://www.chessprogramming.org/KPK
+namespace engine::evaluation::endgame::Kpk {
+
+// 2 sides * 24 pawn squares (a2-d7) * 64 * 64 king squares = 24 KB of bits
+inline constexpr int MAX_INDEX = 2 * 24 * 64 * 64;
+
+enum Result : uint8_t {
+    INVALID = 0,
+    UNKNOWN = 1,
+    DRAW = 2,
+    WIN = 4,
+};
+
+inline uint32_t BITBASE[MAX_INDEX / 32];
+
+inline void initialise();
+
+[[nodiscard]] inline constexpr int getIndex(engine::board::ColourType side, int blackKing, int whiteKing, int whitePawn);
+
+[[nodiscard]] inline Result getInitialResult(engine::board::ColourType side, int blackKing, int whiteKing, int whitePawn);
+
+[[nodiscard]] inline Result getResult(const std::vector<Result> &results, engine::board::ColourType side, int blackKing, int whiteKing, int whitePawn);
+
+[[nodiscard]] inline bool probe(engine::board::ColourType side, int whiteKing, int whitePawn, int blackKing);
+
+inline void initialise() {
+    std::vector<Result> results(MAX_INDEX, Result::UNKNOWN);
+
+    for (int index = 0; index < MAX_INDEX; ++index) {
+        int whiteKing = index & 0x3F;
+        int blackKing = (index >> 6) & 0x3F;
+
+        engine::board::ColourType side = static_cast<engine::board::ColourType>((index >> 12) & 0x1);
+
+        int whitePawn = utility::BoardUtility::getSquare(6 - (index >> 15), (index >> 13) & 0x3);
+
+        results[index] = getInitialResult(side, blackKing, whiteKing, whitePawn);
+    }
+
+    // Keep propagating known results backwards until nothing changes
+    bool isChanged = true;
+
+    while (isChanged) {
+        isChanged = false;
+
+        for (int index = 0; index < MAX_INDEX; ++index) {
+            if (results[index] != Result::UNKNOWN) {
+                continue;
+            }
+
+            int whiteKing = index & 0x3F;
+            int blackKing = (index >> 6) & 0x3F;
+
+            engine::board::ColourType side = static_cast<engine::board::ColourType>((index >> 12) & 0x1);
+
+            int whitePawn = utility::BoardUtility::getSquare(6 - (index >> 15), (index >> 13) & 0x3);
+
+            Result result = getResult(results, side, blackKing, whiteKing, whitePawn);
+
+            if (result != Result::UNKNOWN) {
+                results[index] = result;
+
+                isChanged = true;
+            }
+        }
+    }
+
+    for (int index = 0; index < MAX_INDEX; ++index) {
+        if (results[index] == Result::WIN) {
+            BITBASE[index >> 5] |= 1U << (index & 0x1F);
+        }
+    }
+}
+
+[[nodiscard]] inline constexpr int getIndex(engine::board::ColourType side, int blackKing, int whiteKing, int whitePawn) {
+    return whiteKing | (blackKing << 6) | (side << 12) | (utility::BoardUtility::getFile(whitePawn) << 13) | ((6 - utility::BoardUtility::getRank(whitePawn)) << 15);
+}
+
+[[nodiscard]] inline Result getInitialResult(engine::board::ColourType side, int blackKing, int whiteKing, int whitePawn) {
+    const uint64_t whiteKingAttacks = engine::piece::King::ATTACKS[whiteKing];
+    const uint64_t blackKingAttacks = engine::piece::King::ATTACKS[blackKing];
+    const uint64_t pawnAttacks = engine::piece::Pawn::ATTACKS[engine::board::ColourType::WHITE][whitePawn];
+
+    const uint64_t whitePawnBitboard = engine::board::BITBOARD_SQUARES[whitePawn];
+    const uint64_t blackKingBitboard = engine::board::BITBOARD_SQUARES[blackKing];
+
+    // Overlapping pieces, touching kings, or black in check with white to move
+    if ((whiteKingAttacks & blackKingBitboard) || whiteKing == blackKing || whiteKing == whitePawn || blackKing == whitePawn) {
+        return Result::INVALID;
+    }
+
+    if (side == engine::board::ColourType::WHITE && (pawnAttacks & blackKingBitboard)) {
+        return Result::INVALID;
+    }
+
+    // Pawn promotes without being captured
+    if (side == engine::board::ColourType::WHITE && utility::BoardUtility::getRank(whitePawn) == 6) {
+        int promotionSquare = whitePawn + 8;
+
+        const uint64_t promotionBitboard = engine::board::BITBOARD_SQUARES[promotionSquare];
+
+        if (whiteKing != promotionSquare && blackKing != promotionSquare && (!(blackKingAttacks & promotionBitboard) || (whiteKingAttacks & promotionBitboard))) {
+            return Result::WIN;
+        }
+    }
+
+    if (side == engine::board::ColourType::BLACK) {
+        // Stalemate
+        if (!(blackKingAttacks & ~(whiteKingAttacks | pawnAttacks))) {
+            return Result::DRAW;
+        }
+
+        // Black captures an undefended pawn
+        if (blackKingAttacks & whitePawnBitboard & ~whiteKingAttacks) {
+            return Result::DRAW;
+        }
+    }
+
+    return Result::UNKNOWN;
+}
+
+// White needs one winning move, black needs one drawing move
+[[nodiscard]] inline Result getResult(const std::vector<Result> &results, engine::board::ColourType side, int blackKing, int whiteKing, int whitePawn) {
+    const engine::board::ColourType otherSide = utility::BoardUtility::getOtherSide(side);
+
+    const Result good = (side == engine::board::ColourType::WHITE) ? Result::WIN : Result::DRAW;
+    const Result bad = (side == engine::board::ColourType::WHITE) ? Result::DRAW : Result::WIN;
+
+    int result = Result::INVALID;
+
+    uint64_t kingMoves = engine::piece::King::ATTACKS[(side == engine::board::ColourType::WHITE) ? whiteKing : blackKing];
+
+    while (kingMoves) {
+        int to = utility::BitUtility::popLSB(kingMoves);
+
+        if (side == engine::board::ColourType::WHITE) {
+            result |= results[getIndex(otherSide, blackKing, to, whitePawn)];
+        } else {
+            result |= results[getIndex(otherSide, to, whiteKing, whitePawn)];
+        }
+    }
+
+    // Pushing onto a king lands on an invalid index, which does not affect the result
+    if (side == engine::board::ColourType::WHITE && utility::BoardUtility::getRank(whitePawn) < 6) {
+        int singlePush = whitePawn + 8;
+
+        result |= results[getIndex(otherSide, blackKing, whiteKing, singlePush)];
+
+        if (utility::BoardUtility::getRank(whitePawn) == 1 && singlePush != whiteKing && singlePush != blackKing) {
+            result |= results[getIndex(otherSide, blackKing, whiteKing, singlePush + 8)];
+        }
+    }
+
+    if (result & good) {
+        return good;
+    }
+
+    if (result & Result::UNKNOWN) {
+        return Result::UNKNOWN;
+    }
+
+    return bad;
+}
+
+[[nodiscard]] inline bool probe(engine::board::ColourType side, int whiteKing, int whitePawn, int blackKing) {
+    int index = getIndex(side, blackKing, whiteKing, whitePawn);
+
+    return BITBASE[index >> 5] & (1U << (index & 0x1F));
+}
+
+} // namespace engine::evaluation::endgame::Kpk
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstdint>
+#include <utility>
+
+#include "engine/board/Piece.hpp"
+#include "engine/board/Colour.hpp"
+#include "engine/board/Square.hpp"
+
+#include "engine/hash/Zobrist.hpp"
+
+#include "engine/piece/Knight.hpp"
+#include "engine/piece/Bishop.hpp"
+#include "engine/piece/Rook.hpp"
+#include "engine/piece/King.hpp"
+
+#include "logger/LoggerMacros.hpp"
+
+// Zobrist differences of every reversible piece move, so a position one move away from an earlier one is found by lookup
+// http://web.archive.org/web/20201107002606/https://marcelk.net/2013-04-06/paper/upcoming-rep-v2.pdf
+namespace engine::hash::Cuckoo {
+
+inline constexpr int SIZE = 8192;
+
+inline constexpr int MOVES = 3668;
+
+inline uint64_t keys[SIZE];
+
+// From square in the low 6 bits, to square in the next 6, zero marks an empty slot
+inline uint16_t moves[SIZE];
+
+inline void initialise();
+
+[[nodiscard]] inline constexpr int getFirstIndex(uint64_t key);
+
+[[nodiscard]] inline constexpr int getSecondIndex(uint64_t key);
+
+[[nodiscard]] inline uint64_t getAttacks(engine::board::PieceType piece, int square);
+
+// Requires the piece attack tables and the zobrist keys
+inline void initialise() {
+    for (int i = 0; i < SIZE; ++i) {
+        keys[i] = 0ULL;
+        moves[i] = 0U;
+    }
+
+    int count = 0;
+
+    for (int side = engine::board::ColourType::WHITE; side <= engine::board::ColourType::BLACK; ++side) {
+        for (int piece = engine::board::PieceType::KNIGHT; piece <= engine::board::PieceType::KING; ++piece) {
+            for (int from = 0; from < 64; ++from) {
+                for (int to = from + 1; to < 64; ++to) {
+                    if ((getAttacks(static_cast<engine::board::PieceType>(piece), from) & engine::board::BITBOARD_SQUARES[to]) == 0ULL) {
+                        continue;
+                    }
+
+                    uint64_t key = Zobrist::pieceKeys[side][piece][from] ^ Zobrist::pieceKeys[side][piece][to] ^ Zobrist::sideKey;
+                    uint16_t move = static_cast<uint16_t>(from | (to << 6));
+
+                    int index = getFirstIndex(key);
+
+                    // Displaced entries move to their other slot until one lands in an empty slot
+                    while (true) {
+                        std::swap(keys[index], key);
+                        std::swap(moves[index], move);
+
+                        if (move == 0U) {
+                            break;
+                        }
+
+                        index = (index == getFirstIndex(key)) ? getSecondIndex(key) : getFirstIndex(key);
+                    }
+
+                    ++count;
+                }
+            }
+        }
+    }
+
+    if (count != MOVES) {
+        LOG_ERROR("Cuckoo table has {} moves instead of {}", count, MOVES);
+    }
+}
+
+[[nodiscard]] inline constexpr int getFirstIndex(uint64_t key) {
+    return static_cast<int>(key & (SIZE - 1));
+}
+
+[[nodiscard]] inline constexpr int getSecondIndex(uint64_t key) {
+    return static_cast<int>((key >> 16) & (SIZE - 1));
+}
+
+[[nodiscard]] inline uint64_t getAttacks(engine::board::PieceType piece, int square) {
+    switch (piece) {
+    case engine::board::PieceType::KNIGHT:
+        return engine::piece::Knight::ATTACKS[square];
+    case engine::board::PieceType::BISHOP:
+        return engine::piece::Bishop::getAttacks(square, 0ULL);
+    case engine::board::PieceType::ROOK:
+        return engine::piece::Rook::getAttacks(square, 0ULL);
+    case engine::board::PieceType::QUEEN:
+        return engine::piece::Bishop::getAttacks(square, 0ULL) | engine::piece::Rook::getAttacks(square, 0ULL);
+    case engine::board::PieceType::KING:
+        return engine::piece::King::ATTACKS[square];
+    default:
+        return 0ULL;
+    }
+}
+
+} // namespace engine::hash::Cuckoo
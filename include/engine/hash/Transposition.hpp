@@ -12,7 +12,8 @@ enum NodeType : uint8_t {
     UNKNOWN = 3,
 };
 
-struct Entry {
+// Aligned so an entry never straddles two cache lines, one prefetch brings in all of it
+struct alignas(32) Entry {
     uint64_t zobrist;
 
     int32_t score;
@@ -26,9 +27,22 @@ struct Entry {
     }
 };
 
-// 2 MB transposition table = 2mb / 32b entries
-inline constexpr size_t TRANSPOSITION_TABLE_BYTES = 2ULL << 20;
-inline constexpr size_t TRANSPOSITION_TABLE_ENTRIES = TRANSPOSITION_TABLE_BYTES / sizeof(Entry);
-inline constexpr size_t TRANSPOSITION_TABLE_MASK = TRANSPOSITION_TABLE_ENTRIES - 1;
+static_assert(sizeof(Entry) == 32, "Entries are sized to divide a cache line");
+
+// 2 MB transposition table = 2mb / 32b entries, resizable per engine
+inline constexpr size_t TRANSPOSITION_TABLE_MEGABYTES = 2;
+
+// Largest power of two number of entries that fits, so the index is a mask of the key
+[[nodiscard]] inline constexpr size_t getEntries(size_t megabytes);
+
+[[nodiscard]] inline constexpr size_t getEntries(size_t megabytes) {
+    size_t entries = 1;
+
+    while (entries * 2 * sizeof(Entry) <= (megabytes << 20)) {
+        entries *= 2;
+    }
+
+    return entries;
+}
 
 } // namespace engine::hash::Transposition
@@ -3,12 +3,18 @@
 // http://paulwebster.net/mvv-lva-move-ordering/
 namespace engine::move {
 
-inline constexpr int TT_VALUE = 30000;
+inline constexpr int TT_VALUE = 4000000;
 
-inline constexpr int PV_VALUE = 20000;
+inline constexpr int PV_VALUE = 3000000;
 
 // inline constexpr int MVV_LVA_OFFSET = INT_MAX - 4096;
-inline constexpr int MVV_LVA_OFFSET = 10000;
+// Far above the sum of the quiet history tables, so killers and counter moves always come before other quiets
+inline constexpr int MVV_LVA_OFFSET = 2000000;
+
+// Spreads the MVV-LVA steps so capture history only reorders captures of the same victim
+inline constexpr int MVV_LVA_SCALE = 16;
+
+inline constexpr int CAPTURE_HISTORY_DIVISOR = 32;
 
 // clang-format off
 inline constexpr int MVV_LVA[6][6] = {
@@ -23,7 +29,5 @@ inline constexpr int MVV_LVA[6][6] = {
 
 inline constexpr int MAX_PLY = 64;
 inline constexpr int MAX_KILLER_MOVES = 2;
-// inline constexpr int KILLER_VALUE = 10;
-inline constexpr int KILLER_VALUE = 1000;
 
 } // namespace engine::evaluation
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+
+#include "engine/board/Square.hpp"
+
+#include "engine/piece/Bishop.hpp"
+#include "engine/piece/Rook.hpp"
+
+namespace engine::piece::Between {
+
+// Squares strictly between two squares on a line, empty otherwise
+inline uint64_t SQUARES[64][64];
+
+inline void initialise();
+
+// Requires the bishop and rook attack tables
+inline void initialise() {
+    for (int from = 0; from < 64; ++from) {
+        for (int to = 0; to < 64; ++to) {
+            SQUARES[from][to] = 0ULL;
+
+            if (Bishop::getAttacks(from, 0ULL) & engine::board::BITBOARD_SQUARES[to]) {
+                SQUARES[from][to] = Bishop::getAttacks(from, engine::board::BITBOARD_SQUARES[to]) & Bishop::getAttacks(to, engine::board::BITBOARD_SQUARES[from]);
+            } else if (Rook::getAttacks(from, 0ULL) & engine::board::BITBOARD_SQUARES[to]) {
+                SQUARES[from][to] = Rook::getAttacks(from, engine::board::BITBOARD_SQUARES[to]) & Rook::getAttacks(to, engine::board::BITBOARD_SQUARES[from]);
+            }
+        }
+    }
+}
+
+} // namespace engine::piece::Between
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdlib>
+#include <algorithm>
+
+namespace engine::search::History {
+
+// Every history score stays within plus or minus this value
+inline constexpr int MAX_HISTORY = 16384;
+
+inline constexpr int MAX_BONUS = 1600;
+
+// Scores are divided by two to this power between searches, so the previous move's knowledge fades instead of vanishing
+inline constexpr int AGE_SHIFT = 1;
+
+// Earlier plies whose move, together with the current one, indexes a continuation history
+inline constexpr int CONTINUATION_PLIES = 2;
+
+// Scores of a move following an earlier move, indexed by the earlier piece and square, then the side, piece and square of the move
+struct ContinuationHistory {
+    int16_t scores[6][64][2][6][64];
+};
+
+[[nodiscard]] inline constexpr int getBonus(int depth);
+
+inline void update(int16_t &score, int bonus);
+
+inline void age(int16_t *scores, size_t size);
+
+[[nodiscard]] inline constexpr int getBonus(int depth) {
+    return std::min(32 * depth * depth, MAX_BONUS);
+}
+
+// Gravity, the closer a score is to the limit in the bonus direction the less it moves, so scores saturate instead of overflowing
+inline void update(int16_t &score, int bonus) {
+    score += static_cast<int16_t>(bonus - score * std::abs(bonus) / MAX_HISTORY);
+}
+
+inline void age(int16_t *scores, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        scores[i] = static_cast<int16_t>(scores[i] >> AGE_SHIFT);
+    }
+}
+
+} // namespace engine::search::History
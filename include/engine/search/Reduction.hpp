@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cmath>
+
+namespace engine::search::Reduction {
+
+// Move numbers past the last column share its reduction
+inline constexpr int MAX_MOVES = 64;
+
+// Base and divisor are in hundredths of a ply
+[[nodiscard]] inline int getReduction(int depth, int moveNumber, int base, int divisor);
+
+// Grows with the log of both the remaining depth and the number of moves already searched
+[[nodiscard]] inline int getReduction(int depth, int moveNumber, int base, int divisor) {
+    if (depth == 0 || moveNumber == 0) {
+        return 0;
+    }
+
+    return static_cast<int>(base / 100.0 + std::log(depth) * std::log(moveNumber) * 100.0 / divisor);
+}
+
+} // namespace engine::search::Reduction
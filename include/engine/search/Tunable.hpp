@@ -0,0 +1,90 @@
+#pragma once
+
+#include <string>
+#include <algorithm>
+#include <cstddef>
+
+// clang-format off
+// Name, default, minimum, maximum, SPSA step
+#define SEARCH_TUNABLES(TUNABLE)                  \
+    TUNABLE(FULL_DEPTH, 4, 1, 12, 1)              \
+    TUNABLE(REDUCTION_LIMIT, 3, 2, 8, 1)          \
+    TUNABLE(LMR_BASE, 75, 0, 200, 10)             \
+    TUNABLE(LMR_DIVISOR, 225, 100, 400, 15)       \
+    TUNABLE(LMR_HISTORY, 8192, 2048, 32768, 1024) \
+    TUNABLE(NMP_DEPTH, 3, 1, 8, 1)                \
+    TUNABLE(NMP_REDUCTION, 2, 1, 5, 1)            \
+    TUNABLE(RAZOR_DEPTH, 3, 1, 6, 1)              \
+    TUNABLE(RAZOR_MARGIN, 125, 0, 500, 20)        \
+    TUNABLE(RAZOR_SECOND_MARGIN, 175, 0, 500, 20) \
+    TUNABLE(RFP_DEPTH, 8, 1, 12, 1)               \
+    TUNABLE(RFP_MARGIN, 75, 20, 200, 10)          \
+    TUNABLE(FUTILITY_DEPTH, 3, 1, 8, 1)           \
+    TUNABLE(FUTILITY_MARGIN, 100, 20, 300, 15)    \
+    TUNABLE(LMP_DEPTH, 6, 1, 12, 1)               \
+    TUNABLE(LMP_BASE, 3, 1, 12, 1)                \
+    TUNABLE(SE_DEPTH, 8, 4, 12, 1)                \
+    TUNABLE(SE_MARGIN, 3, 1, 10, 1)               \
+    TUNABLE(DELTA_MARGIN, 200, 0, 600, 25)        \
+    TUNABLE(ASPIRATION_WINDOW, 25, 5, 200, 5)     \
+    TUNABLE(ASPIRATION_SCALE, 64, 8, 128, 8)      \
+    TUNABLE(KILLER_VALUE, 1000, 100, 4000, 200)
+// clang-format on
+
+namespace engine::search {
+
+struct TunableInfo {
+    const char *name;
+
+    int value;
+    int minimum;
+    int maximum;
+    int step;
+};
+
+// clang-format off
+#define TUNABLE_INFO(NAME, VALUE, MINIMUM, MAXIMUM, STEP) { #NAME, VALUE, MINIMUM, MAXIMUM, STEP },
+
+inline constexpr TunableInfo TUNABLES[] = {
+    SEARCH_TUNABLES(TUNABLE_INFO)
+};
+
+#undef TUNABLE_INFO
+// clang-format on
+
+inline constexpr size_t TUNABLE_COUNT = sizeof(TUNABLES) / sizeof(TUNABLES[0]);
+
+// Release builds fold every tunable into a constant, -DTUNING gives each engine its own settable copy
+struct Tunables {
+    // clang-format off
+    #ifdef TUNING
+        #define TUNABLE_MEMBER(NAME, VALUE, ...) int NAME = VALUE;
+    #else
+        #define TUNABLE_MEMBER(NAME, VALUE, ...) static constexpr int NAME = VALUE;
+    #endif
+    // clang-format on
+
+    SEARCH_TUNABLES(TUNABLE_MEMBER)
+
+    #undef TUNABLE_MEMBER
+
+    // Clamped to the range, the search relies on the minimums, e.g. a reduction needs a depth of at least 2
+    bool set(const std::string &name, int value) {
+        // clang-format off
+        #ifdef TUNING
+            #define TUNABLE_SET(NAME, VALUE, MINIMUM, MAXIMUM, ...) if (name == #NAME) { this->NAME = std::clamp(value, MINIMUM, MAXIMUM); return true; }
+
+            SEARCH_TUNABLES(TUNABLE_SET)
+
+            #undef TUNABLE_SET
+        #endif
+        // clang-format on
+
+        (void)name;
+        (void)value;
+
+        return false;
+    }
+};
+
+} // namespace engine::search
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <cstdint>
+#include <functional>
+
+#include "engine/board/Colour.hpp"
+
+#include "engine/tablebase/Index.hpp"
+#include "engine/tablebase/Tablebase.hpp"
+
+namespace engine::tablebase {
+
+// More than the legal moves of any position with at most five pieces
+inline constexpr int MAX_MOVES = 128;
+
+// Indices handed to a worker at a time
+inline constexpr uint64_t CHUNK_SIZE = 1ULL << 14;
+
+struct Position {
+    uint64_t bitboards[2][6];
+    uint64_t occupancies[2];
+    uint64_t occupancyBoth;
+
+    engine::board::ColourType side;
+};
+
+// Retrograde analysis over every index of a table, in plies to mate
+// Conversions (captures and promotions) are looked up in tables generated earlier
+// Castling and en passant are ignored, so positions with either must not be probed
+class Generator {
+  public:
+    Generator(const std::string &directory, int threads);
+
+    bool generate(const std::string &code);
+
+    bool generate(int maxPieces);
+
+  private:
+    std::string _directory;
+
+    int _threads;
+
+    Tablebase _tablebase;
+
+    bool generateTable(uint64_t materialKey);
+
+    bool build(const Layout &layout);
+
+    bool write(const Layout &layout, const std::atomic<uint8_t> *values, int maxDistance);
+
+    uint64_t runParallel(uint64_t size, const std::function<uint64_t(uint64_t, uint64_t)> &function) const;
+
+    uint8_t getInitialValue(const Layout &layout, uint64_t index) const;
+
+    uint8_t getValue(const Layout &layout, const std::atomic<uint8_t> *values, uint64_t index, int distance) const;
+
+    int getChildValues(const Layout &layout, const std::atomic<uint8_t> *values, const Position &position, uint8_t childValues[MAX_MOVES]) const;
+
+    uint8_t getChildValue(const Layout &layout, const std::atomic<uint8_t> *values, const Position &child) const;
+
+    bool setPosition(Position &position, const Layout &layout, const int squares[MAX_PIECES], engine::board::ColourType side) const;
+
+    bool makeMove(const Position &position, Position &child, int from, int to, engine::board::PieceType piece, engine::board::PieceType promotionPiece) const;
+
+    bool isSquareAttacked(const Position &position, int square, engine::board::ColourType side) const;
+};
+
+} // namespace engine::tablebase
@@ -0,0 +1,288 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+
+#include "engine/board/Piece.hpp"
+#include "engine/board/Colour.hpp"
+
+#include "engine/evaluation/endgame/Endgame.hpp"
+
+#include "utility/BitUtility.hpp"
+#include "utility/BoardUtility.hpp"
+
+// Indexing shared by the tablebase generator and prober
+// https://www.chessprogramming.org/Endgame_Tablebases
+namespace engine::tablebase {
+
+// Kings included
+inline constexpr int MAX_PIECES = 5;
+
+// Values are relative to the side to move, mates are stored as MATE + distance in plies
+// Even distances are losses (0 is checkmated), odd distances are wins
+inline constexpr uint8_t UNKNOWN = 0;
+inline constexpr uint8_t INVALID = 1;
+inline constexpr uint8_t DRAW = 2;
+inline constexpr uint8_t MATE = 3;
+
+inline constexpr int MAX_DISTANCE = UINT8_MAX - MATE;
+
+// Pawns can only stand on a2-h7
+inline constexpr int PAWN_SQUARES = 48;
+inline constexpr int PAWN_SQUARE_OFFSET = 8;
+
+// The white king is restricted to the a1-d1-d4 triangle without pawns, and to files a-d with pawns
+inline constexpr int PAWNLESS_KING_SQUARES = 10;
+inline constexpr int PAWN_KING_SQUARES = 32;
+
+// clang-format off
+inline constexpr int8_t PAWNLESS_KING_INDEX[64] = {
+     0,  1,  2,  3, -1, -1, -1, -1,
+    -1,  4,  5,  6, -1, -1, -1, -1,
+    -1, -1,  7,  8, -1, -1, -1, -1,
+    -1, -1, -1,  9, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1,
+};
+
+inline constexpr int8_t PAWNLESS_KING_SQUARE[PAWNLESS_KING_SQUARES] = {
+    0, 1, 2, 3, 9, 10, 11, 18, 19, 27,
+};
+// clang-format on
+
+// Pieces besides the kings, white first and each colour in piece order
+struct Layout {
+    uint64_t materialKey;
+
+    int pieceCount;
+
+    engine::board::PieceType pieces[MAX_PIECES - 2];
+    engine::board::ColourType colours[MAX_PIECES - 2];
+
+    bool hasPawns;
+
+    uint64_t size;
+};
+
+[[nodiscard]] inline constexpr bool isWin(uint8_t value);
+
+[[nodiscard]] inline constexpr bool isLoss(uint8_t value);
+
+[[nodiscard]] inline constexpr int getDistance(uint8_t value);
+
+[[nodiscard]] inline constexpr uint8_t getValue(int distance);
+
+[[nodiscard]] inline constexpr int getPieceCount(uint64_t materialKey);
+
+[[nodiscard]] inline constexpr uint64_t getCanonicalMaterialKey(uint64_t materialKey, bool &isMirrored);
+
+[[nodiscard]] inline std::string getMaterialCode(uint64_t materialKey);
+
+[[nodiscard]] inline Layout getLayout(uint64_t materialKey);
+
+[[nodiscard]] inline constexpr int getTransposedSquare(int square);
+
+[[nodiscard]] inline constexpr int getKingIndex(int whiteKing, bool hasPawns);
+
+[[nodiscard]] inline uint64_t getIndex(const Layout &layout, const uint64_t bitboards[2][6], engine::board::ColourType side, bool isMirrored);
+
+[[nodiscard]] inline uint64_t getIndex(const Layout &layout, int squares[MAX_PIECES], engine::board::ColourType side);
+
+inline void getSquares(const Layout &layout, uint64_t index, int squares[MAX_PIECES], engine::board::ColourType &side);
+
+[[nodiscard]] inline constexpr bool isWin(uint8_t value) {
+    return value >= MATE && ((value - MATE) & 1);
+}
+
+[[nodiscard]] inline constexpr bool isLoss(uint8_t value) {
+    return value >= MATE && !((value - MATE) & 1);
+}
+
+[[nodiscard]] inline constexpr int getDistance(uint8_t value) {
+    return value - MATE;
+}
+
+[[nodiscard]] inline constexpr uint8_t getValue(int distance) {
+    return static_cast<uint8_t>(MATE + distance);
+}
+
+[[nodiscard]] inline constexpr int getPieceCount(uint64_t materialKey) {
+    int count = 2;
+
+    for (; materialKey != 0ULL; materialKey >>= engine::evaluation::endgame::MATERIAL_KEY_PIECE_OFFSET) {
+        count += materialKey & 0xF;
+    }
+
+    return count;
+}
+
+// The side with more of the most valuable piece is white on disk, so each material set has one table
+[[nodiscard]] inline constexpr uint64_t getCanonicalMaterialKey(uint64_t materialKey, bool &isMirrored) {
+    uint64_t white = materialKey & engine::evaluation::endgame::MATERIAL_KEY_SIDE_MASK;
+    uint64_t black = materialKey >> engine::evaluation::endgame::MATERIAL_KEY_SIDE_OFFSET;
+
+    isMirrored = black > white;
+
+    return isMirrored ? engine::evaluation::endgame::getMirroredMaterialKey(materialKey) : materialKey;
+}
+
+// Inverse of endgame::getMaterialKey, e.g. "KQKR"
+[[nodiscard]] inline std::string getMaterialCode(uint64_t materialKey) {
+    constexpr char LETTERS[5] = { 'P', 'N', 'B', 'R', 'Q' };
+
+    std::string code;
+
+    for (int side = 0; side < 2; ++side) {
+        code += 'K';
+
+        for (int piece = engine::board::PieceType::QUEEN; piece >= engine::board::PieceType::PAWN; --piece) {
+            int offset = side * engine::evaluation::endgame::MATERIAL_KEY_SIDE_OFFSET + piece * engine::evaluation::endgame::MATERIAL_KEY_PIECE_OFFSET;
+
+            int count = (materialKey >> offset) & 0xF;
+
+            code.append(count, LETTERS[piece]);
+        }
+    }
+
+    return code;
+}
+
+[[nodiscard]] inline Layout getLayout(uint64_t materialKey) {
+    Layout layout{};
+
+    layout.materialKey = materialKey;
+
+    for (int side = 0; side < 2; ++side) {
+        for (int piece = engine::board::PieceType::PAWN; piece < engine::board::PieceType::KING; ++piece) {
+            int offset = side * engine::evaluation::endgame::MATERIAL_KEY_SIDE_OFFSET + piece * engine::evaluation::endgame::MATERIAL_KEY_PIECE_OFFSET;
+
+            int count = (materialKey >> offset) & 0xF;
+
+            for (int i = 0; i < count && layout.pieceCount < MAX_PIECES - 2; ++i) {
+                layout.pieces[layout.pieceCount] = static_cast<engine::board::PieceType>(piece);
+                layout.colours[layout.pieceCount] = static_cast<engine::board::ColourType>(side);
+
+                ++layout.pieceCount;
+            }
+
+            layout.hasPawns |= (piece == engine::board::PieceType::PAWN && count > 0);
+        }
+    }
+
+    layout.size = 2ULL * (layout.hasPawns ? PAWN_KING_SQUARES : PAWNLESS_KING_SQUARES) * 64ULL;
+
+    for (int i = 0; i < layout.pieceCount; ++i) {
+        layout.size *= (layout.pieces[i] == engine::board::PieceType::PAWN) ? PAWN_SQUARES : 64ULL;
+    }
+
+    return layout;
+}
+
+[[nodiscard]] inline constexpr int getTransposedSquare(int square) {
+    return ((square & 7) << 3) | (square >> 3);
+}
+
+[[nodiscard]] inline constexpr int getKingIndex(int whiteKing, bool hasPawns) {
+    if (hasPawns) {
+        return (utility::BoardUtility::getRank(whiteKing) << 2) | utility::BoardUtility::getFile(whiteKing);
+    }
+
+    return PAWNLESS_KING_INDEX[whiteKing];
+}
+
+// Pieces are read in layout order, colours are swapped and ranks flipped if black is the stronger side
+[[nodiscard]] inline uint64_t getIndex(const Layout &layout, const uint64_t bitboards[2][6], engine::board::ColourType side, bool isMirrored) {
+    const engine::board::ColourType white = isMirrored ? engine::board::ColourType::BLACK : engine::board::ColourType::WHITE;
+    const engine::board::ColourType black = utility::BoardUtility::getOtherSide(white);
+
+    const int flip = isMirrored ? 56 : 0;
+
+    int squares[MAX_PIECES];
+
+    squares[0] = utility::BitUtility::getLSBIndex(bitboards[white][engine::board::PieceType::KING]) ^ flip;
+    squares[1] = utility::BitUtility::getLSBIndex(bitboards[black][engine::board::PieceType::KING]) ^ flip;
+
+    int count = 2;
+
+    for (engine::board::ColourType colour : { white, black }) {
+        for (int piece = engine::board::PieceType::PAWN; piece < engine::board::PieceType::KING; ++piece) {
+            uint64_t bitboard = bitboards[colour][piece];
+
+            while (bitboard && count < MAX_PIECES) {
+                squares[count++] = utility::BitUtility::popLSB(bitboard) ^ flip;
+            }
+        }
+    }
+
+    return getIndex(layout, squares, isMirrored ? utility::BoardUtility::getOtherSide(side) : side);
+}
+
+// Squares are in table colours and are reflected in place so the white king lands on an indexed square
+[[nodiscard]] inline uint64_t getIndex(const Layout &layout, int squares[MAX_PIECES], engine::board::ColourType side) {
+    const int count = layout.pieceCount + 2;
+
+    int flip = (utility::BoardUtility::getFile(squares[0]) > 3) ? 7 : 0;
+
+    if (!layout.hasPawns && utility::BoardUtility::getRank(squares[0]) > 3) {
+        flip |= 56;
+    }
+
+    for (int i = 0; i < count; ++i) {
+        squares[i] ^= flip;
+    }
+
+    if (!layout.hasPawns && utility::BoardUtility::getRank(squares[0]) > utility::BoardUtility::getFile(squares[0])) {
+        for (int i = 0; i < count; ++i) {
+            squares[i] = getTransposedSquare(squares[i]);
+        }
+    }
+
+    uint64_t index = side;
+
+    index = index * (layout.hasPawns ? PAWN_KING_SQUARES : PAWNLESS_KING_SQUARES) + getKingIndex(squares[0], layout.hasPawns);
+    index = index * 64 + squares[1];
+
+    for (int i = 0; i < layout.pieceCount; ++i) {
+        if (layout.pieces[i] == engine::board::PieceType::PAWN) {
+            index = index * PAWN_SQUARES + (squares[i + 2] - PAWN_SQUARE_OFFSET);
+        } else {
+            index = index * 64 + squares[i + 2];
+        }
+    }
+
+    return index;
+}
+
+inline void getSquares(const Layout &layout, uint64_t index, int squares[MAX_PIECES], engine::board::ColourType &side) {
+    for (int i = layout.pieceCount - 1; i >= 0; --i) {
+        if (layout.pieces[i] == engine::board::PieceType::PAWN) {
+            squares[i + 2] = static_cast<int>(index % PAWN_SQUARES) + PAWN_SQUARE_OFFSET;
+
+            index /= PAWN_SQUARES;
+        } else {
+            squares[i + 2] = static_cast<int>(index & 0x3F);
+
+            index >>= 6;
+        }
+    }
+
+    squares[1] = static_cast<int>(index & 0x3F);
+
+    index >>= 6;
+
+    if (layout.hasPawns) {
+        squares[0] = utility::BoardUtility::getSquare(static_cast<int>(index % PAWN_KING_SQUARES) >> 2, static_cast<int>(index % PAWN_KING_SQUARES) & 3);
+
+        index /= PAWN_KING_SQUARES;
+    } else {
+        squares[0] = PAWNLESS_KING_SQUARE[index % PAWNLESS_KING_SQUARES];
+
+        index /= PAWNLESS_KING_SQUARES;
+    }
+
+    side = static_cast<engine::board::ColourType>(index);
+}
+
+} // namespace engine::tablebase
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+#include "engine/tablebase/Index.hpp"
+
+#include "utility/MappedFile.hpp"
+
+namespace engine::tablebase {
+
+inline constexpr const char *TABLE_EXTENSION = ".tb";
+
+// "CTB1", little-endian
+inline constexpr uint32_t TABLE_MAGIC = 0x31425443;
+
+// Followed by one value per index, see Index.hpp
+struct Header {
+    uint32_t magic;
+    uint32_t maxDistance;
+
+    uint64_t materialKey;
+    uint64_t size;
+
+    uint64_t reserved;
+};
+
+static_assert(sizeof(Header) == 32, "Tablebase headers must be 32 bytes");
+
+class Table {
+  public:
+    Table();
+
+    Table(const Table &) = delete;
+
+    Table &operator=(const Table &) = delete;
+
+    bool open(const std::string &path);
+
+    void close();
+
+    bool isOpen() const;
+
+    uint64_t getMaterialKey() const;
+
+    int getMaxDistance() const;
+
+    const Layout &getLayout() const;
+
+    uint8_t getValue(uint64_t index) const;
+
+  private:
+    utility::MappedFile _file;
+
+    const Header *_header;
+
+    const uint8_t *_values;
+
+    Layout _layout;
+};
+
+} // namespace engine::tablebase
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+
+#include "engine/board/Colour.hpp"
+
+#include "engine/tablebase/Table.hpp"
+
+namespace engine::tablebase {
+
+inline constexpr const char *TABLEBASE_PATH = "resources/tablebases";
+
+// Every table found in a directory, keyed by canonical material
+class Tablebase {
+  public:
+    Tablebase();
+
+    bool load(const std::string &directory);
+
+    bool add(const std::string &path);
+
+    bool contains(uint64_t materialKey) const;
+
+    size_t size() const;
+
+    int getMaxPieces() const;
+
+    int getMaxDistance() const;
+
+    bool probe(const uint64_t bitboards[2][6], engine::board::ColourType side, uint8_t &value) const;
+
+  private:
+    std::unordered_map<uint64_t, std::unique_ptr<Table>> _tables;
+
+    int _maxPieces;
+
+    int _maxDistance;
+};
+
+} // namespace engine::tablebase
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <mutex>
+#include <atomic>
 #include <string>
 #include <vector>
 
@@ -17,6 +19,10 @@ class Logger {
 
     void log(Severity severity, const char *file, const char *function, int line, std::string message);
 
+    void setSeverity(Severity severity);
+
+    bool isEnabled(Severity severity) const;
+
     void addEntry(Entry entry);
 
     void save();
@@ -35,6 +41,12 @@ class Logger {
     std::vector<Entry> _entries;
 
     std::string _logPath;
+
+    // Entries below this severity are dropped
+    std::atomic<Severity> _severity;
+
+    // Engines may log from several threads at once
+    std::mutex _mutex;
 };
 
 } // namespace logger
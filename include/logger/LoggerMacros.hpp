@@ -4,9 +4,12 @@
 
 #include "logger/Logger.hpp"
 
+// Arguments are only formatted when the entry would be kept
 #define LOG__CALL(SEV, ...)                                                                                                                                                                            \
     do {                                                                                                                                                                                               \
-        logger::Logger::getInstance().log(logger::Severity::SEV, __FILE__, __func__, __LINE__, fmt::format(__VA_ARGS__));                                                                              \
+        if (logger::Logger::getInstance().isEnabled(logger::Severity::SEV)) {                                                                                                                          \
+            logger::Logger::getInstance().log(logger::Severity::SEV, __FILE__, __func__, __LINE__, fmt::format(__VA_ARGS__));                                                                          \
+        }                                                                                                                                                                                              \
     } while (0)
 
 // clang-format off
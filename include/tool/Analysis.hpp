@@ -0,0 +1,114 @@
+#pragma once
+
+#include <mutex>
+#include <deque>
+#include <thread>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <condition_variable>
+
+#include <nlohmann/json.hpp>
+
+#include "engine/Engine.hpp"
+
+namespace tool {
+
+struct AnalysisSettings {
+    // Search workers, each with its own engine and transposition table
+    int threads;
+
+    // Per worker
+    size_t hashSize;
+
+    // Requests waiting for a worker before clients stop being read
+    size_t queueSize;
+
+    // Most requests a worker takes from the queue at once
+    size_t batchSize;
+
+    // Used for whatever a request leaves out
+    engine::SearchLimits searchLimits;
+};
+
+// One connection, responses are written a whole line at a time by whichever worker finishes a request
+struct AnalysisClient {
+    // Standard output when negative
+    int descriptor;
+
+    std::mutex mutex;
+
+    explicit AnalysisClient(int descriptor);
+
+    AnalysisClient(const AnalysisClient &) = delete;
+
+    AnalysisClient &operator=(const AnalysisClient &) = delete;
+
+    ~AnalysisClient();
+};
+
+struct AnalysisRequest {
+    nlohmann::json json;
+
+    // Kept open until the last of its requests is answered
+    std::shared_ptr<AnalysisClient> client;
+};
+
+// Long running analysis over JSON lines, one request per line in and one response per line out, e.g.
+// {"id": 1, "fen": "<fen>", "depth": 12, "time": 1000, "nodes": 0, "multipv": 3}
+// {"id": 1, "bestmove": "e2e4", "score": 35, "depth": 12, "nodes": 81234, "time": 96, "pv": ["e2e4", "e7e5"], "lines": [...]}
+class Analysis {
+  public:
+    explicit Analysis(const AnalysisSettings &settings);
+
+    // Until standard input ends
+    bool run();
+
+    // Until the process is stopped, clients connect to a Unix domain socket at the path
+    bool run(const std::string &socketPath);
+
+  private:
+    AnalysisSettings _settings;
+
+    // Bounded, a full queue blocks the reading clients so their writes back up instead of memory
+    std::deque<AnalysisRequest> _requests;
+
+    std::mutex _mutex;
+
+    std::condition_variable _requestAdded;
+    std::condition_variable _requestTaken;
+    std::condition_variable _readerFinished;
+
+    // Connected socket clients still being read
+    int _readers;
+
+    bool _isClosed;
+
+    std::vector<std::thread> startWorkers();
+
+    void work();
+
+    void push(AnalysisRequest request);
+
+    bool takeBatch(std::vector<AnalysisRequest> &batch);
+
+    void close();
+
+    void read(const std::shared_ptr<AnalysisClient> &client);
+
+    void accept(const std::shared_ptr<AnalysisClient> &client, const std::string &line);
+
+    nlohmann::json analyse(engine::Engine &engine, const nlohmann::json &request) const;
+
+    static void respond(AnalysisClient &client, const nlohmann::json &response);
+
+    static nlohmann::json getError(const nlohmann::json &request, const std::string &message);
+
+    static int64_t getInteger(const nlohmann::json &request, const char *key, int64_t defaultValue);
+
+    static std::string getMoveString(uint16_t move);
+};
+
+} // namespace tool
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+#include <vector>
+#include <cstdint>
+
+#include "engine/Engine.hpp"
+
+namespace tool {
+
+struct BenchSettings {
+    int depth;
+
+    // Static evaluations per position
+    int evaluations;
+
+    // Transposition table size, large tables miss the cache on almost every probe
+    size_t hashSize;
+};
+
+// Single threaded evaluation and fixed depth search speed, the node total doubles as a search signature
+class Bench {
+  public:
+    explicit Bench(const BenchSettings &settings);
+
+    bool run(const std::string &path);
+
+  private:
+    // Records scored per batch evaluator call
+    static inline constexpr size_t _BATCH_SIZE = 1 << 16;
+
+    // Passes over the positions when timing FEN reading and writing
+    static inline constexpr int _FEN_PASSES = 2000;
+
+    // Lines per position when checking multi-PV scores against single line searches
+    static inline constexpr int _MULTI_PV_LINES = 3;
+
+    // Scores further apart than an aspiration window count as disagreeing
+    static inline constexpr int _MULTI_PV_MARGIN = 25;
+
+    BenchSettings _settings;
+
+    void runEvaluation(engine::Engine &engine, const std::vector<std::string> &positions) const;
+
+    void runBatchEvaluation(engine::Engine &engine, const std::vector<std::string> &positions) const;
+
+    void runFen(engine::Engine &engine, const std::vector<std::string> &positions) const;
+
+    void runSearch(engine::Engine &engine, const std::vector<std::string> &positions) const;
+
+    void runMultiPV(engine::Engine &engine, const std::vector<std::string> &positions) const;
+
+    static std::vector<std::string> loadPositions(const std::string &path);
+};
+
+} // namespace tool
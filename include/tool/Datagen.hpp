@@ -0,0 +1,74 @@
+#pragma once
+
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "engine/Engine.hpp"
+
+#include "engine/data/Record.hpp"
+#include "engine/data/Writer.hpp"
+
+namespace tool {
+
+struct DatagenSettings {
+    uint64_t positions;
+    uint64_t nodes;
+
+    int threads;
+
+    // Uniformly random moves before the engines take over, so games do not repeat
+    int randomPlies;
+};
+
+// Fixed node self-play on every core, keeping quiet positions labelled with the search score and the game result
+class Datagen {
+  public:
+    explicit Datagen(const DatagenSettings &settings);
+
+    bool run(const std::string &path);
+
+  private:
+    static inline constexpr int _FIFTY_MOVE_PLIES = 100;
+
+    static inline constexpr int _REPETITIONS = 3;
+
+    static inline constexpr int _MAX_PLIES = 400;
+
+    // Openings already decided after the random moves are thrown away
+    static inline constexpr int _MAX_OPENING_SCORE = 1000;
+
+    static inline constexpr int _WIN_SCORE = 2000;
+    static inline constexpr int _WIN_PLIES = 4;
+
+    static inline constexpr int _DRAW_SCORE = 10;
+    static inline constexpr int _DRAW_PLIES = 12;
+    static inline constexpr int _DRAW_MINIMUM_PLY = 80;
+
+    static inline constexpr uint64_t _REPORT_INTERVAL = 100000;
+
+    DatagenSettings _settings;
+
+    engine::data::Writer _writer;
+
+    std::mutex _writerMutex;
+
+    uint64_t _positions;
+    uint64_t _games;
+
+    std::atomic<bool> _isFinished;
+
+    std::chrono::steady_clock::time_point _start;
+
+    void play(engine::Engine &engine, std::mt19937_64 &generator, std::vector<engine::data::Record> &records);
+
+    bool playRandomMoves(engine::Engine &engine, std::mt19937_64 &generator);
+
+    void write(const std::vector<engine::data::Record> &records);
+};
+
+} // namespace tool
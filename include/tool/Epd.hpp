@@ -0,0 +1,66 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "engine/Engine.hpp"
+
+// https://www.chessprogramming.org/Extended_Position_Description
+namespace tool {
+
+struct EpdRecord {
+    std::string fen;
+    std::string id;
+
+    std::vector<std::string> bestMoves;
+    std::vector<std::string> avoidMoves;
+};
+
+struct EpdResult {
+    std::string id;
+    std::string fen;
+    std::string move;
+
+    // False when the engine refused the record's position, which is then not searched or counted
+    bool isValid;
+
+    bool isSolved;
+
+    int depth;
+    int score;
+
+    uint64_t nodes;
+
+    int64_t time;
+
+    // When the best move became correct and stayed correct, -1 if unsolved
+    int64_t solutionTime;
+
+    uint64_t solutionNodes;
+};
+
+// Streams a suite of bm/am records through a pool of engines, each with its own transposition table
+class Epd {
+  public:
+    Epd(int threads, const engine::SearchLimits &searchLimits);
+
+    bool run(const std::string &path, const std::string &reportPath);
+
+    static bool parseRecord(const std::string &line, EpdRecord &record);
+
+  private:
+    int _threads;
+
+    engine::SearchLimits _searchLimits;
+
+    EpdResult solve(engine::Engine &engine, const EpdRecord &record) const;
+
+    void writeReport(const std::string &path, const std::vector<EpdResult> &results) const;
+
+    static bool isCorrect(const EpdRecord &record, const std::string &san);
+
+    static std::string getNormalisedSan(std::string san);
+};
+
+} // namespace tool
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+
+namespace tool {
+
+struct ExplorerSettings {
+    // PGN parsing workers
+    int threads;
+
+    // Moves from the start of each game that go into the tree
+    int plies;
+
+    // Sorted in memory before spilling a run to disk
+    size_t memoryBytes;
+};
+
+// Builds opening trees from PGN databases and shows what was played from a position and how it scored
+class Explorer {
+  public:
+    explicit Explorer(const ExplorerSettings &settings);
+
+    bool build(const std::string &pgnPath, const std::string &treePath);
+
+    bool probe(const std::string &treePath, const std::string &fen) const;
+
+  private:
+    // Lookups timed per probe, a single one is below the clock's resolution
+    static inline constexpr int _TIMED_LOOKUPS = 10000;
+
+    ExplorerSettings _settings;
+};
+
+} // namespace tool
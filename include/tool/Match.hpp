@@ -0,0 +1,130 @@
+#pragma once
+
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include <utility>
+#include <fstream>
+#include <cstdint>
+
+#include <nlohmann/json.hpp>
+
+#include "engine/Engine.hpp"
+
+namespace tool {
+
+// One side of the match, engines differ only by their options since both run in this process
+struct MatchEngine {
+    std::string name;
+
+    engine::SearchLimits searchLimits;
+
+    std::string bookPath;
+    std::string tablebasePath;
+
+    // Search tunables, only settable in builds with TUNING defined
+    std::vector<std::pair<std::string, int>> tunables;
+};
+
+struct MatchSettings {
+    int games;
+    int threads;
+
+    // Resign once every score for this many plies is beyond the threshold
+    int resignScore;
+    int resignPlies;
+
+    // Draw once every score for this many plies is within the threshold, after the minimum ply
+    int drawScore;
+    int drawPlies;
+    int drawMinimumPly;
+
+    int maxPlies;
+
+    // SPRT of H0: elo = elo0 against H1: elo = elo1
+    double elo0;
+    double elo1;
+    double alpha;
+    double beta;
+
+    // Without SPRT every game is played, quiet matches only report through the result getters
+    bool isSprt;
+    bool isQuiet;
+};
+
+struct MatchGame {
+    std::string white;
+    std::string black;
+    std::string fen;
+    std::string result;
+    std::string termination;
+
+    std::vector<std::string> moves;
+
+    int round;
+};
+
+// Plays engine pairs over an opening file, both colours per opening, until the SPRT accepts a hypothesis
+class Match {
+  public:
+    Match(const MatchEngine &engine, const MatchEngine &otherEngine, const MatchSettings &settings);
+
+    bool run(const std::string &openingsPath, const std::string &pgnPath);
+
+    bool run(const std::vector<std::string> &openings, const std::string &pgnPath);
+
+    int getWins() const;
+
+    int getLosses() const;
+
+    int getDraws() const;
+
+    static bool parseConfig(const nlohmann::json &config, MatchEngine &engine, MatchEngine &otherEngine, MatchSettings &settings);
+
+    static MatchEngine parseEngine(const nlohmann::json &options, const std::string &name);
+
+    static MatchSettings parseSettings(const nlohmann::json &config);
+
+    static std::vector<std::string> loadOpenings(const std::string &path);
+
+  private:
+    static inline constexpr int _FIFTY_MOVE_PLIES = 100;
+
+    static inline constexpr int _REPETITIONS = 3;
+
+    MatchEngine _engines[2];
+
+    MatchSettings _settings;
+
+    // Results from the point of view of the first engine
+    int _wins;
+    int _losses;
+    int _draws;
+
+    std::atomic<int> _nextGame;
+    std::atomic<bool> _isFinished;
+
+    std::mutex _resultMutex;
+
+    std::ofstream _pgn;
+
+    MatchGame play(engine::Engine *engines[2], const std::string &fen, int round);
+
+    void record(const MatchGame &game);
+
+    void printResults();
+
+    std::string getPgn(const MatchGame &game);
+
+    std::string adjudicate(const std::vector<int> &scores, int ply, std::string &termination) const;
+
+    double getLlr() const;
+
+    static std::unique_ptr<engine::Engine> createEngine(const MatchEngine &matchEngine);
+
+    static double getElo(double score);
+};
+
+} // namespace tool
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <mutex>
+#include <deque>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string_view>
+#include <condition_variable>
+
+#include "engine/Engine.hpp"
+
+#include "engine/data/Record.hpp"
+#include "engine/data/Writer.hpp"
+
+#include "engine/book/Tree.hpp"
+#include "engine/book/TreeBuilder.hpp"
+
+namespace tool {
+
+struct PgnSettings {
+    // Parsing workers, each with its own engine to replay games on
+    int threads;
+
+    // Bytes of whole games handed to a worker at a time
+    size_t chunkSize;
+
+    // Moves from the start of each game added to an opening tree
+    int treePlies;
+};
+
+// Splits a PGN file into chunks of whole games while it is read and replays them on every core, every position before a move is kept labelled with the game result
+class Pgn {
+  public:
+    explicit Pgn(const PgnSettings &settings);
+
+    // Without an output path the games are only parsed, e.g. to time or check a database
+    bool run(const std::string &path, const std::string &outputPath);
+
+    // Every game's first moves with its result, the builder is finished by the caller
+    bool run(const std::string &path, engine::book::TreeBuilder &treeBuilder);
+
+  private:
+    // Read from the file at a time, chunks are cut from what has been read at the last game start
+    static inline constexpr size_t _READ_SIZE = 1 << 20;
+
+    // Chunks waiting for a worker per worker, so memory stays bounded however large the file is
+    static inline constexpr size_t _QUEUED_CHUNKS = 2;
+
+    static inline constexpr uint64_t _REPORT_INTERVAL = 100000;
+
+    PgnSettings _settings;
+
+    std::deque<std::string> _chunks;
+
+    std::mutex _mutex;
+
+    std::condition_variable _chunkAdded;
+    std::condition_variable _chunkTaken;
+
+    bool _isClosed;
+
+    engine::data::Writer _writer;
+
+    // Only set while building a tree
+    engine::book::TreeBuilder *_treeBuilder;
+
+    // Guards the writer and the tree builder
+    std::mutex _writerMutex;
+
+    std::atomic<uint64_t> _games;
+    std::atomic<uint64_t> _positions;
+
+    // Games with an unknown result or a variant, their positions can not be used
+    std::atomic<uint64_t> _skippedGames;
+
+    // Games with a move that is not legal or can not be read, their positions are dropped
+    std::atomic<uint64_t> _invalidGames;
+
+    // Set when the tree builder could not write a run
+    std::atomic<bool> _isFailed;
+
+    // Games reported so far, guarded by the writer mutex
+    uint64_t _reportedGames;
+
+    std::chrono::steady_clock::time_point _start;
+
+    bool parse(const std::string &path);
+
+    uint64_t read(std::ifstream &file);
+
+    void push(std::string chunk);
+
+    bool take(std::string &chunk);
+
+    void work();
+
+    void parseChunk(engine::Engine &engine, std::string_view chunk, std::vector<engine::data::Record> &records, std::vector<engine::book::TreeEntry> &treeEntries);
+
+    void write(const std::vector<engine::data::Record> &records, const std::vector<engine::book::TreeEntry> &treeEntries);
+
+    static size_t findGameStart(std::string_view text, size_t from);
+
+    static bool isTagLine(std::string_view text, size_t index);
+
+    static std::string_view getTagValue(std::string_view line, std::string_view name);
+
+    static bool isTermination(std::string_view token);
+
+    static bool parseResult(std::string_view text, engine::data::Result &result);
+};
+
+} // namespace tool
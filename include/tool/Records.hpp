@@ -0,0 +1,21 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+
+#include "engine/data/Dataset.hpp"
+
+namespace tool {
+
+// One pass over a record file through the dataset reader, checking every record decodes and packs back to the same bytes
+class Records {
+  public:
+    explicit Records(const engine::data::DatasetSettings &settings);
+
+    bool run(const std::string &path);
+
+  private:
+    engine::data::DatasetSettings _settings;
+};
+
+} // namespace tool
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "tool/Match.hpp"
+
+// https://www.chessprogramming.org/SPSA
+namespace tool {
+
+struct SpsaSettings {
+    int iterations;
+    int gamesPerIteration;
+
+    // Learning rate at the last iteration, relative to the squared step
+    double rEnd;
+
+    // Tunables to optimise, empty for all of them
+    std::vector<std::string> tunables;
+
+    std::string outputPath;
+};
+
+// Each iteration plays a short match between two engines perturbed in opposite directions and steps towards the winner
+class Spsa {
+  public:
+    Spsa(const MatchEngine &engine, const MatchSettings &matchSettings, const SpsaSettings &settings);
+
+    bool run(const std::string &openingsPath);
+
+  private:
+    // Standard exponents for the step and learning rate decay
+    static inline constexpr double _ALPHA = 0.602;
+    static inline constexpr double _GAMMA = 0.101;
+
+    // Stability constant, as a fraction of the iterations
+    static inline constexpr double _STABILITY = 0.1;
+
+    struct Parameter {
+        std::string name;
+
+        double value;
+
+        int minimum;
+        int maximum;
+
+        // Step and learning rate before decay
+        double c;
+        double a;
+    };
+
+    MatchEngine _engine;
+
+    MatchSettings _matchSettings;
+
+    SpsaSettings _settings;
+
+    std::vector<Parameter> _parameters;
+
+    void save(int iteration) const;
+};
+
+} // namespace tool
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+namespace tool {
+
+// Command line entry points that run without the GUI, e.g. `chess tablebase resources/tablebases 4`
+class Tool {
+  public:
+    static int run(int argc, char *argv[]);
+
+  private:
+    static int runTablebase(const std::vector<std::string> &arguments);
+
+    static int runEpd(const std::vector<std::string> &arguments);
+
+    static int runMatch(const std::vector<std::string> &arguments);
+
+    static int runDatagen(const std::vector<std::string> &arguments);
+
+    static int runTuner(const std::vector<std::string> &arguments);
+
+    static int runSpsa(const std::vector<std::string> &arguments);
+
+    static int runBench(const std::vector<std::string> &arguments);
+
+    static int runAnalysis(const std::vector<std::string> &arguments);
+
+    static int runRecords(const std::vector<std::string> &arguments);
+
+    static int runPgn(const std::vector<std::string> &arguments);
+
+    static int runTree(const std::vector<std::string> &arguments);
+
+    static int runExplore(const std::vector<std::string> &arguments);
+
+    static int printUsage();
+
+    // Leaves the number unchanged when the argument is absent, false when it is not a number of that type
+    template <typename Number>
+    static bool parseArgument(const std::vector<std::string> &arguments, size_t index, Number &number);
+};
+
+} // namespace tool
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#include "engine/data/Record.hpp"
+
+#include "utility/MappedFile.hpp"
+
+// https://www.chessprogramming.org/Texel%27s_Tuning_Method
+namespace tool {
+
+struct TunerSettings {
+    int epochs;
+    int threads;
+
+    // Target is lambda * result + (1 - lambda) * sigmoid(search score)
+    double lambda;
+
+    double learningRate;
+};
+
+// Every term of the evaluation is linear in its weight, so a position is a sparse list of
+// (opening weight, endgame weight, coefficient) and the evaluation is their sum tapered by phase
+struct TunerFeature {
+    uint16_t openingIndex;
+    uint16_t endgameIndex;
+
+    int16_t coefficient;
+};
+
+class Tuner {
+  public:
+    explicit Tuner(const TunerSettings &settings);
+
+    Tuner(const Tuner &) = delete;
+
+    Tuner &operator=(const Tuner &) = delete;
+
+    bool open(const std::string &path);
+
+    void close();
+
+    bool run(const std::string &outputDirectory);
+
+  private:
+    // Weight layout, shared terms use the same index for both phases
+    static inline constexpr int _MATERIAL_OFFSET = 0;
+    static inline constexpr int _POSITION_OFFSET = _MATERIAL_OFFSET + 2 * 6;
+    static inline constexpr int _STACKED_PAWN_OFFSET = _POSITION_OFFSET + 2 * 6 * 64;
+    static inline constexpr int _ISOLATED_PAWN_OFFSET = _STACKED_PAWN_OFFSET + 2;
+    static inline constexpr int _PASSED_PAWN_OFFSET = _ISOLATED_PAWN_OFFSET + 2;
+    static inline constexpr int _SEMI_OPEN_FILE_OFFSET = _PASSED_PAWN_OFFSET + 8;
+    static inline constexpr int _OPEN_FILE_OFFSET = _SEMI_OPEN_FILE_OFFSET + 1;
+    static inline constexpr int _BISHOP_MOBILITY_OFFSET = _OPEN_FILE_OFFSET + 1;
+    static inline constexpr int _QUEEN_MOBILITY_OFFSET = _BISHOP_MOBILITY_OFFSET + 2;
+    static inline constexpr int _KING_SAFETY_OFFSET = _QUEEN_MOBILITY_OFFSET + 2;
+    static inline constexpr int _WEIGHTS = _KING_SAFETY_OFFSET + 1;
+
+    // Positions handed to a thread at a time, small enough to balance, large enough to stay sequential
+    static inline constexpr size_t _CHUNK_SIZE = 1 << 16;
+
+    static inline constexpr int _REPORT_INTERVAL = 10;
+
+    // Adam
+    static inline constexpr double _BETA1 = 0.9;
+    static inline constexpr double _BETA2 = 0.999;
+    static inline constexpr double _EPSILON = 1e-8;
+
+    TunerSettings _settings;
+
+    utility::MappedFile _file;
+
+    const engine::data::Record *_records;
+
+    size_t _size;
+
+    // Records that pass data::isValid, the others are skipped and left out of the means
+    size_t _validSize;
+
+    std::vector<double> _weights;
+
+    // Sigmoid scale fitted to the initial weights, so the error is comparable between epochs
+    double _k;
+
+    void initialiseWeights();
+
+    double getError(double k, double lambda);
+
+    double getGradient(std::vector<double> &gradient);
+
+    double fitK();
+
+    double evaluate(const std::vector<TunerFeature> &features, double phase) const;
+
+    static double getSigmoid(double score, double k);
+
+    static double getPhase(const uint64_t bitboards[2][6]);
+
+    static void decode(const engine::data::Record &record, uint64_t bitboards[2][6]);
+
+    static void getFeatures(const uint64_t bitboards[2][6], std::vector<TunerFeature> &features);
+
+    static void addFeature(std::vector<TunerFeature> &features, int openingIndex, int endgameIndex, int coefficient);
+
+    template <typename Function>
+    void runParallel(Function function);
+
+    bool writeHeaders(const std::string &outputDirectory) const;
+
+    std::string getWeight(int index) const;
+};
+
+} // namespace tool
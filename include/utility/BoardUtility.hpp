@@ -19,6 +19,8 @@ inline constexpr engine::board::ColourType OTHER_SIDE[2] = {
 
 [[nodiscard]] inline constexpr int getFile(int square);
 
+[[nodiscard]] inline constexpr int getDistance(int square, int otherSquare);
+
 [[nodiscard]] inline constexpr int getPieceIndex(engine::board::PieceType piece, engine::board::ColourType colour);
 
 [[nodiscard]] inline int getSquareFromPosition(std::string &position);
@@ -47,6 +49,17 @@ inline void printBoard(uint64_t board[2][6]);
     return square & 7;
 }
 
+// Chebyshev distance, the number of king moves between the squares
+[[nodiscard]] inline constexpr int getDistance(int square, int otherSquare) {
+    int rankDistance = getRank(square) - getRank(otherSquare);
+    int fileDistance = getFile(square) - getFile(otherSquare);
+
+    rankDistance = (rankDistance < 0) ? -rankDistance : rankDistance;
+    fileDistance = (fileDistance < 0) ? -fileDistance : fileDistance;
+
+    return (rankDistance > fileDistance) ? rankDistance : fileDistance;
+}
+
 [[nodiscard]] inline constexpr int getPieceIndex(engine::board::PieceType piece, engine::board::ColourType colour) {
     return piece + 6 * colour;
 }
@@ -64,7 +77,7 @@ inline void printBoard(uint64_t board[2][6]);
     position[0] = getFile(square) + 'a';
     position[1] = getRank(square) + '1';
 
-    return position;
+    return std::string(position, 2);
 }
 
 [[nodiscard]] inline int getMirroredSquare(int square) {
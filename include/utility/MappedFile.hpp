@@ -0,0 +1,45 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+namespace utility {
+
+// Read-ahead hint for the kernel, by how the pages will be touched
+enum class MappedAccess : uint8_t {
+    NORMAL,
+    SEQUENTIAL,
+    RANDOM,
+};
+
+// A whole file mapped read-only, unmapped when closed or destroyed
+class MappedFile {
+  public:
+    MappedFile();
+
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    // Fails on a missing, unreadable or empty file, callers log with what the file was for
+    bool open(const std::string &path, MappedAccess access);
+
+    void close();
+
+    bool isOpen() const;
+
+    const void *data() const;
+
+    // In bytes
+    size_t size() const;
+
+  private:
+    void *_data;
+
+    size_t _size;
+};
+
+} // namespace utility
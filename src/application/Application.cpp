@@ -7,12 +7,20 @@
 
 #include "engine/board/Fen.hpp"
 
+#include "engine/book/Book.hpp"
+
+#include "engine/tablebase/Tablebase.hpp"
+
 #include "sound/SoundPlayer.hpp"
 
 #include "logger/LoggerMacros.hpp"
 
 using namespace engine::board;
 
+using namespace engine::book;
+
+using namespace engine::tablebase;
+
 using namespace application::manager;
 
 using namespace sound;
@@ -43,6 +51,10 @@ void Application::initialise() {
     // this->_engine.parse(PASSED_PAWN_POSITIONS[0]);
     // this->_engine.parse(SEMI_OPEN_FILE_POSITIONS[0]);
 
+    this->_engine.loadBook(BOOK_PATH);
+
+    this->_engine.loadTablebases(TABLEBASE_PATH);
+
     this->initialiseRenderer();
 
     SoundPlayer::getInstance().initialise();
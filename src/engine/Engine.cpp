@@ -1,37 +1,48 @@
+#include <mutex>
 #include <chrono>
+#include <algorithm>
 #include <cstring>
-#include <functional>
 
 #include "engine/Engine.hpp"
 
 #include "engine/board/Fen.hpp"
 #include "engine/board/Castle.hpp"
+#include "engine/board/FenCodec.hpp"
 #include "engine/board/Square.hpp"
 
 #include "engine/hash/Zobrist.hpp"
+#include "engine/hash/Cuckoo.hpp"
+#include "engine/hash/Polyglot.hpp"
 #include "engine/hash/Transposition.hpp"
 
 #include "engine/evaluation/Score.hpp"
+#include "engine/evaluation/Terms.hpp"
+#include "engine/evaluation/Tapered.hpp"
 #include "engine/evaluation/Material.hpp"
-#include "engine/evaluation/Position.hpp"
 
 #include "engine/evaluation/pesto/Phase.hpp"
-#include "engine/evaluation/pesto/Material.hpp"
-#include "engine/evaluation/pesto/Position.hpp"
+
+#include "engine/evaluation/endgame/Kpk.hpp"
+#include "engine/evaluation/endgame/Endgame.hpp"
 
 #include "engine/move/Move.hpp"
 
+#include "engine/data/Record.hpp"
+
+#include "engine/tablebase/Index.hpp"
+#include "engine/tablebase/Tablebase.hpp"
+
 #include "engine/piece/Pawn.hpp"
 #include "engine/piece/Knight.hpp"
 #include "engine/piece/Bishop.hpp"
 #include "engine/piece/Rook.hpp"
 #include "engine/piece/Queen.hpp"
 #include "engine/piece/King.hpp"
+#include "engine/piece/Between.hpp"
 
 #include "utility/BitUtility.hpp"
 #include "utility/BoardUtility.hpp"
 #include "utility/AttackUtility.hpp"
-#include "utility/StringUtility.hpp"
 
 using namespace engine::board;
 
@@ -47,29 +58,90 @@ using namespace engine::evaluation;
 
 using namespace engine::evaluation::pesto;
 
+using namespace engine::evaluation::endgame;
+
 using namespace utility;
 
 namespace engine {
 
-Engine::Engine() {
-    this->initialise();
+Engine::Engine() : _searchLimits{ _SEARCH_DEPTH, 0, 0ULL }, _multiPV(1), _searchNodes(0ULL), _isStopped(false) {
+    Engine::initialise();
+
+    this->initialiseReductions();
+
+    this->_continuationHistory.resize(engine::search::History::CONTINUATION_PLIES);
+
+    this->clearHistories();
+
+    this->setTranspositionTableSize(Transposition::TRANSPOSITION_TABLE_MEGABYTES);
+
+    this->_bookGenerator.seed(std::random_device{}());
 
     this->parse(INITIAL_POSITION);
 }
 
-void Engine::parse(const char *fen) {
+bool Engine::parse(std::string_view fen) {
+    FenCodec::FenPosition position;
+
+    FenCodec::FenResult result = FenCodec::parse(fen, position);
+
+    if (result.error != FenCodec::FenError::NONE) {
+        LOG_ERROR("Invalid {} at offset {} of FEN: {}", FenCodec::ERROR_NAMES[static_cast<int>(result.error)], result.offset, fen);
+
+        return false;
+    }
+
     this->reset();
 
-    std::vector<std::string> states = StringUtility::splitStringByWhiteSpace(fen);
+    std::memcpy(this->_bitboards, position.bitboards, sizeof(this->_bitboards));
 
-    this->parseFenPosition(states[0]);
-    this->parseFenSide(states[1]);
-    this->parseFenCastleRights(states[2]);
-    this->parseFenEnPassantSquare(states[3]);
-    this->parseFenHalfMove(states[4]);
-    this->parseFenFullMove(states[5]);
+    this->_castleRights = position.castleRights;
+    this->_enPassantSquare = position.enPassantSquare;
+    this->_side = position.side;
+    this->_halfMove = position.halfMove;
+    this->_fullMove = position.fullMove;
 
-    this->_zobrist = Zobrist::hash(this->_bitboards, this->_castleRights, this->_enPassantSquare, this->_side);
+    this->initialisePosition();
+
+    return true;
+}
+
+size_t Engine::toFen(char *buffer, size_t size) {
+    FenCodec::FenPosition position;
+
+    std::memcpy(position.bitboards, this->_bitboards, sizeof(position.bitboards));
+
+    position.castleRights = this->_castleRights;
+    position.enPassantSquare = this->_enPassantSquare;
+    position.side = this->_side;
+    position.halfMove = this->_halfMove;
+    position.fullMove = this->_fullMove;
+
+    return FenCodec::write(position, buffer, size);
+}
+
+bool Engine::loadBook(const std::string &path) {
+    std::shared_ptr<engine::book::Book> book = std::make_shared<engine::book::Book>();
+
+    if (!book->open(path)) {
+        return false;
+    }
+
+    this->_book = std::move(book);
+
+    return true;
+}
+
+bool Engine::loadTablebases(const std::string &directory) {
+    std::shared_ptr<engine::tablebase::Tablebase> tablebase = std::make_shared<engine::tablebase::Tablebase>();
+
+    if (!tablebase->load(directory)) {
+        return false;
+    }
+
+    this->_tablebase = std::move(tablebase);
+
+    return true;
 }
 
 void Engine::run() {
@@ -80,7 +152,22 @@ void Engine::run() {
 
 // FIX: Find out why there are no optimal moves even when there are
 uint16_t &Engine::getMove() {
-    this->searchIterative(this->_SEARCH_DEPTH);
+    // Book and tablebase moves have no iterations, callers must not see the previous search
+    this->_searchIterations.clear();
+    this->_principalVariations.clear();
+
+    // Both give a single move, analysis wants every line searched
+    if (this->_multiPV == 1) {
+        if (this->getBookMove(this->_searchResult.bestMove)) {
+            return this->_searchResult.bestMove;
+        }
+
+        if (this->getTablebaseMove(this->_searchResult.bestMove)) {
+            return this->_searchResult.bestMove;
+        }
+    }
+
+    this->searchIterative(this->_searchLimits.depth);
 
     // this->searchRoot(this->_SEARCH_DEPTH);
 
@@ -109,121 +196,376 @@ void Engine::runPerft(int depth) {
     LOG_INFO("Time: {} ms\nNodes: {}", elapsed.count(), nodes);
 }
 
-ColourType Engine::getSide() {
-    return this->_side;
+void Engine::setSearchLimits(const SearchLimits &searchLimits) {
+    this->_searchLimits = searchLimits;
+
+    this->_searchLimits.depth = std::clamp(searchLimits.depth, 1, this->_MAX_SEARCH_DEPTH);
 }
 
-void Engine::printBoard() {
-    BoardUtility::printBoard(this->_bitboards);
+int Engine::getMaxSearchDepth() {
+    return Engine::_MAX_SEARCH_DEPTH;
 }
 
-void Engine::initialise() {
-    Pawn::initialise();
-    Knight::initialise();
-    Bishop::initialise();
-    Rook::initialise();
-    King::initialise();
+void Engine::setMultiPV(int multiPV) {
+    this->_multiPV = std::clamp(multiPV, 1, this->_MAX_MULTI_PV);
+}
 
-    Zobrist::initialise();
+// Only takes effect in builds with TUNING defined, release builds keep the defaults as constants
+bool Engine::setTunable(const std::string &name, int value) {
+    if (!this->_tunables.set(name, value)) {
+        return false;
+    }
+
+    this->initialiseReductions();
+
+    return true;
 }
 
-void Engine::parseFenPosition(std::string &position) {
-    int rank = 7;
-    int file = 0;
+// Static evaluation from the side to move's point of view
+int Engine::getEvaluation() {
+    return this->evaluate(this->_side);
+}
 
-    for (const char letter : position) {
-        if (letter == '/') {
-            file = 0;
-            --rank;
-        } else {
-            if (StringUtility::isLetter(letter)) {
-                this->createFenPiece(rank, file, letter);
-                ++file;
-            } else {
-                file += letter - '0';
+const SearchStatistics &Engine::getSearchStatistics() const {
+    return this->_searchStatistics;
+}
+
+const std::vector<PrincipalVariation> &Engine::getPrincipalVariations() const {
+    return this->_principalVariations;
+}
+
+const std::vector<SearchIteration> &Engine::getSearchIterations() const {
+    return this->_searchIterations;
+}
+
+void Engine::clearTranspositionTable() {
+    std::fill(this->_transpositionTable.begin(), this->_transpositionTable.end(), Transposition::Entry());
+}
+
+void Engine::setTranspositionTableSize(size_t megabytes) {
+    const size_t entries = Transposition::getEntries(megabytes);
+
+    this->_transpositionTable.assign(entries, Transposition::Entry());
+
+    this->_transpositionTableMask = entries - 1;
+}
+
+// Standard algebraic notation, e.g. "Nbd7", "exd6", "e8=Q+", "O-O#"
+std::string Engine::getSan(uint16_t move) {
+    constexpr char LETTERS[6] = { 'P', 'N', 'B', 'R', 'Q', 'K' };
+
+    const int from = Move::getFrom(move);
+    const int to = Move::getTo(move);
+
+    const PieceType piece = this->getPiece(from, this->_side);
+
+    std::string san;
+
+    if (Move::isKingCastle(move)) {
+        san = "O-O";
+    } else if (Move::isQueenCastle(move)) {
+        san = "O-O-O";
+    } else if (piece == PieceType::PAWN) {
+        if (Move::isGeneralCapture(move)) {
+            san += static_cast<char>('a' + BoardUtility::getFile(from));
+            san += 'x';
+        }
+
+        san += BoardUtility::getPositionFromSquare(to);
+
+        if (Move::isGeneralPromotion(move)) {
+            san += '=';
+            san += LETTERS[Move::getPromotionPiece(move)];
+        }
+    } else {
+        san += LETTERS[piece];
+
+        // Disambiguate by file, then rank, then both
+        bool isAmbiguous = false;
+        bool isFileShared = false;
+        bool isRankShared = false;
+
+        MoveList moves = this->generateMoves(this->_side);
+
+        for (int i = 0; i < moves.size; ++i) {
+            uint16_t &candidate = moves.moves[i];
+
+            int candidateFrom = Move::getFrom(candidate);
+
+            if (candidateFrom == from || Move::getTo(candidate) != to || this->getPiece(candidateFrom, this->_side) != piece || !this->isMoveLegal(candidate, this->_side)) {
+                continue;
             }
+
+            isAmbiguous = true;
+
+            isFileShared |= BoardUtility::getFile(candidateFrom) == BoardUtility::getFile(from);
+            isRankShared |= BoardUtility::getRank(candidateFrom) == BoardUtility::getRank(from);
+        }
+
+        if (isAmbiguous && (!isFileShared || isRankShared)) {
+            san += static_cast<char>('a' + BoardUtility::getFile(from));
         }
+
+        if (isAmbiguous && isFileShared) {
+            san += static_cast<char>('1' + BoardUtility::getRank(from));
+        }
+
+        if (Move::isGeneralCapture(move)) {
+            san += 'x';
+        }
+
+        san += BoardUtility::getPositionFromSquare(to);
     }
-}
 
-void Engine::parseFenSide(std::string &side) {
-    this->_side = (side == "w") ? ColourType::WHITE : ColourType::BLACK;
-}
+    this->makeMove(move, false);
+
+    if (this->isInCheck(this->_side)) {
+        bool isLegalMoveFound = false;
 
-void Engine::parseFenCastleRights(std::string &castleRights) {
-    this->_castleRights = 0;
+        MoveList replies = this->generateMoves(this->_side);
 
-    if (castleRights == "-") {
-        return;
+        for (int i = 0; i < replies.size && !isLegalMoveFound; ++i) {
+            isLegalMoveFound = this->isMoveLegal(replies.moves[i], this->_side);
+        }
+
+        san += isLegalMoveFound ? '+' : '#';
     }
 
-    for (char c : castleRights) {
-        switch (c) {
-        case 'K':
-            this->_castleRights |= CASTLE_MASK[Castle::WHITE_KING];
+    this->unmakeMove(move);
+
+    return san;
+}
+
+// Tolerates check marks, annotations, "0-0" castles, a missing "=" before the promotion piece and long algebraic "Ng1-f3"
+uint16_t Engine::getMoveFromSan(std::string_view san) {
+    while (!san.empty() && (san.back() == '+' || san.back() == '#' || san.back() == '!' || san.back() == '?')) {
+        san.remove_suffix(1);
+    }
+
+    const bool isKingCastle = (san == "O-O" || san == "0-0");
+    const bool isQueenCastle = (san == "O-O-O" || san == "0-0-0");
+
+    PieceType piece = PieceType::PAWN;
+    PieceType promotion = PieceType::EMPTY;
+
+    int fromFile = -1;
+    int fromRank = -1;
+
+    int to = -1;
+
+    if (!isKingCastle && !isQueenCastle) {
+        if (san.empty()) {
+            return 0;
+        }
+
+        switch (san.front()) {
+        case 'N':
+            piece = PieceType::KNIGHT;
             break;
-        case 'Q':
-            this->_castleRights |= CASTLE_MASK[Castle::WHITE_QUEEN];
+        case 'B':
+            piece = PieceType::BISHOP;
+            break;
+        case 'R':
+            piece = PieceType::ROOK;
             break;
-        case 'k':
-            this->_castleRights |= CASTLE_MASK[Castle::BLACK_KING];
+        case 'Q':
+            piece = PieceType::QUEEN;
             break;
-        case 'q':
-            this->_castleRights |= CASTLE_MASK[Castle::BLACK_QUEEN];
+        case 'K':
+            piece = PieceType::KING;
             break;
         default:
             break;
         }
+
+        if (piece != PieceType::PAWN) {
+            san.remove_prefix(1);
+        }
+
+        if (piece == PieceType::PAWN && !san.empty()) {
+            switch (san.back()) {
+            case 'N':
+                promotion = PieceType::KNIGHT;
+                break;
+            case 'B':
+                promotion = PieceType::BISHOP;
+                break;
+            case 'R':
+                promotion = PieceType::ROOK;
+                break;
+            case 'Q':
+                promotion = PieceType::QUEEN;
+                break;
+            default:
+                break;
+            }
+
+            if (promotion != PieceType::EMPTY) {
+                san.remove_suffix(1);
+
+                if (!san.empty() && san.back() == '=') {
+                    san.remove_suffix(1);
+                }
+            }
+        }
+
+        if (san.size() < 2 || san[san.size() - 2] < 'a' || san[san.size() - 2] > 'h' || san.back() < '1' || san.back() > '8') {
+            return 0;
+        }
+
+        to = BoardUtility::getSquare(san.back() - '1', san[san.size() - 2] - 'a');
+
+        // Whatever is left between the piece and the destination disambiguates
+        for (size_t i = 0; i + 2 < san.size(); ++i) {
+            if (san[i] >= 'a' && san[i] <= 'h') {
+                fromFile = san[i] - 'a';
+            } else if (san[i] >= '1' && san[i] <= '8') {
+                fromRank = san[i] - '1';
+            } else if (san[i] != 'x' && san[i] != '-') {
+                return 0;
+            }
+        }
+    }
+
+    MoveList moves = this->generateMoves(this->_side);
+
+    uint16_t found = 0;
+
+    int matches = 0;
+
+    for (int i = 0; i < moves.size; ++i) {
+        uint16_t &move = moves.moves[i];
+
+        const int from = Move::getFrom(move);
+
+        if (isKingCastle || isQueenCastle) {
+            if ((isKingCastle ? !Move::isKingCastle(move) : !Move::isQueenCastle(move)) || !this->isMoveLegal(move, this->_side)) {
+                continue;
+            }
+        } else {
+            if (Move::getTo(move) != to || Move::isKingCastle(move) || Move::isQueenCastle(move) || this->getPiece(from, this->_side) != piece) {
+                continue;
+            }
+
+            if ((fromFile != -1 && BoardUtility::getFile(from) != fromFile) || (fromRank != -1 && BoardUtility::getRank(from) != fromRank)) {
+                continue;
+            }
+
+            if (Move::isGeneralPromotion(move) ? Move::getPromotionPiece(move) != promotion : promotion != PieceType::EMPTY) {
+                continue;
+            }
+
+            if (!this->isMoveLegal(move, this->_side)) {
+                continue;
+            }
+        }
+
+        found = move;
+
+        ++matches;
     }
+
+    return (matches == 1) ? found : 0;
+}
+
+ColourType Engine::getSide() {
+    return this->_side;
+}
+
+uint16_t Engine::getHalfMove() {
+    return this->_halfMove;
 }
 
-void Engine::parseFenEnPassantSquare(std::string &enPassantSquare) {
-    this->_enPassantSquare = (enPassantSquare == "-") ? -1 : BoardUtility::getSquareFromPosition(enPassantSquare);
+uint64_t Engine::getPolyglotKey() {
+    return Polyglot::hash(this->_bitboards, this->_castleRights, this->_enPassantSquare, this->_side);
 }
 
-void Engine::parseFenHalfMove(std::string &halfMove) {
-    this->_halfMove = (halfMove == "-") ? 1 : std::stoi(halfMove);
+void Engine::pack(engine::data::Record &record) {
+    engine::data::encode(record, this->_bitboards, this->_castleRights, this->_enPassantSquare, this->_side, this->_halfMove, this->_fullMove);
 }
 
-void Engine::parseFenFullMove(std::string &fullMove) {
-    this->_fullMove = (fullMove == "-") ? 1 : std::stoi(fullMove);
+void Engine::unpack(const engine::data::Record &record) {
+    this->reset();
+
+    engine::data::decode(record, this->_bitboards, this->_castleRights, this->_enPassantSquare, this->_side, this->_halfMove, this->_fullMove);
+
+    this->initialisePosition();
 }
 
-void Engine::createFenPiece(int rank, int file, char letter) {
-    ColourType side = isupper(letter) ? ColourType::WHITE : ColourType::BLACK;
-    PieceType piece = PieceType::EMPTY;
+void Engine::initialisePosition() {
+    for (int side = ColourType::WHITE; side <= ColourType::BLACK; ++side) {
+        for (int piece = PieceType::PAWN; piece <= PieceType::KING; ++piece) {
+            uint64_t pieces = this->_bitboards[side][piece];
 
-    letter = tolower(letter);
+            this->_occupancies[side] |= pieces;
 
-    switch (letter) {
-    case 'p':
-        piece = PieceType::PAWN;
-        break;
-    case 'n':
-        piece = PieceType::KNIGHT;
-        break;
-    case 'b':
-        piece = PieceType::BISHOP;
-        break;
-    case 'r':
-        piece = PieceType::ROOK;
-        break;
-    case 'q':
-        piece = PieceType::QUEEN;
-        break;
-    case 'k':
-        piece = PieceType::KING;
-        break;
-    default:
-        piece = PieceType::EMPTY;
-        break;
+            while (pieces) {
+                int square = BitUtility::popLSB(pieces);
+
+                this->_phase += GAME_PHASE_VALUES[piece];
+                this->_pieceSquareScore += PIECE_SQUARE_SCORES.scores[side][piece][square];
+            }
+        }
     }
 
-    if (piece == PieceType::EMPTY) {
-        return;
+    this->_occupancyBoth = this->_occupancies[ColourType::WHITE] | this->_occupancies[ColourType::BLACK];
+
+    this->_zobrist = Zobrist::hash(this->_bitboards, this->_castleRights, this->_enPassantSquare, this->_side);
+}
+
+bool Engine::hasLegalMove() {
+    MoveList moves = this->generateMoves(this->_side);
+
+    for (int i = 0; i < moves.size; ++i) {
+        if (this->isMoveLegal(moves.moves[i], this->_side)) {
+            return true;
+        }
     }
 
-    this->createPiece(rank, file, piece, side);
+    return false;
+}
+
+// Bare kings, or a single minor piece against a bare king
+bool Engine::isInsufficientMaterial() {
+    uint64_t kings = this->_bitboards[ColourType::WHITE][PieceType::KING] | this->_bitboards[ColourType::BLACK][PieceType::KING];
+    uint64_t minors = this->_bitboards[ColourType::WHITE][PieceType::KNIGHT] | this->_bitboards[ColourType::WHITE][PieceType::BISHOP] | this->_bitboards[ColourType::BLACK][PieceType::KNIGHT] | this->_bitboards[ColourType::BLACK][PieceType::BISHOP];
+
+    uint64_t pieces = this->_occupancyBoth ^ kings;
+
+    return pieces == 0ULL || (BitUtility::popCount(pieces) == 1 && (pieces & minors));
+}
+
+void Engine::printBoard() {
+    BoardUtility::printBoard(this->_bitboards);
+}
+
+// Shared tables are built once, so engines on other threads never see them change
+void Engine::initialise() {
+    static std::once_flag flag;
+
+    std::call_once(flag, []() {
+        Pawn::initialise();
+        Knight::initialise();
+        Bishop::initialise();
+        Rook::initialise();
+        King::initialise();
+
+        Between::initialise();
+
+        Zobrist::initialise();
+
+        Cuckoo::initialise();
+
+        Kpk::initialise();
+    });
+}
+
+void Engine::initialiseReductions() {
+    for (int depth = 0; depth <= this->_MAX_SEARCH_DEPTH; ++depth) {
+        for (int moveNumber = 0; moveNumber < engine::search::Reduction::MAX_MOVES; ++moveNumber) {
+            this->_reductions[depth][moveNumber] = engine::search::Reduction::getReduction(depth, moveNumber, this->_tunables.LMR_BASE, this->_tunables.LMR_DIVISOR);
+        }
+    }
 }
 
 void Engine::createPiece(int rank, int file, ColourType side) {
@@ -255,6 +597,9 @@ void Engine::createPiece(int square, PieceType piece, ColourType side) {
 
     // PERF: Optimise if too slow
     this->_zobrist ^= Zobrist::pieceKeys[side][piece][square];
+
+    this->_phase += GAME_PHASE_VALUES[piece];
+    this->_pieceSquareScore += PIECE_SQUARE_SCORES.scores[side][piece][square];
 }
 
 void Engine::removePiece(int rank, int file, ColourType side) {
@@ -286,6 +631,9 @@ void Engine::removePiece(int square, PieceType piece, ColourType side) {
 
     // PERF: Optimise if too slow
     this->_zobrist ^= Zobrist::pieceKeys[side][piece][square];
+
+    this->_phase -= GAME_PHASE_VALUES[piece];
+    this->_pieceSquareScore -= PIECE_SQUARE_SCORES.scores[side][piece][square];
 }
 
 MoveList Engine::generateMoves(ColourType side) {
@@ -704,60 +1052,169 @@ void Engine::generateKingCaptures(MoveList &captures, ColourType side) {
     }
 }
 
-bool Engine::isMoveLegal(uint16_t &move, ColourType side) {
-    this->makeMove(move);
-
-    bool isInCheck = this->isInCheck(side);
+// Only king moves, captures of a lone checker and blocks of its line can answer a check, pins are left to isMoveLegal
+MoveList Engine::generateEvasions(ColourType side) {
+    MoveList evasions;
 
-    this->unmakeMove(move);
+    ColourType otherSide = BoardUtility::getOtherSide(side);
 
-    return !isInCheck;
-}
+    int kingSquare = BitUtility::getLSBIndex(this->_bitboards[side][PieceType::KING]);
 
-bool Engine::isInCheck() {
-    return this->isInCheck(this->_side);
-}
+    uint64_t kingMoves = King::ATTACKS[kingSquare] & ~this->_occupancies[side];
 
-bool Engine::isInCheck(ColourType side) {
-    const uint64_t king = this->_bitboards[side][PieceType::KING];
+    while (kingMoves) {
+        int to = BitUtility::popLSB(kingMoves);
 
-    if (this->_bitboards[side][PieceType::KING] == 0ULL) {
-        return false;
+        evasions.add(kingSquare, to, (this->_occupancies[otherSide] & BITBOARD_SQUARES[to]) ? MoveType::CAPTURE : MoveType::QUIET);
     }
 
-    int kingSquare = BitUtility::getLSBIndex(king);
+    uint64_t checkers = AttackUtility::getAttackersToSquare(kingSquare, this->_bitboards, this->_occupancyBoth, otherSide);
 
-    return this->isSquareAttacked(kingSquare, side);
-}
+    // Double check, only the king can move
+    if (BitUtility::popCount(checkers) > 1) {
+        return evasions;
+    }
 
-bool Engine::isSquareAttacked(int square, ColourType side) {
-    ColourType otherSide = BoardUtility::getOtherSide(side);
+    // Empty for knight and pawn checks
+    uint64_t blocks = Between::SQUARES[kingSquare][BitUtility::getLSBIndex(checkers)];
 
-    if (Pawn::ATTACKS[side][square] & this->_bitboards[otherSide][PieceType::PAWN]) {
-        return true;
-    }
+    uint64_t empty = ~this->_occupancyBoth;
 
-    if (Knight::ATTACKS[square] & this->_bitboards[otherSide][PieceType::KNIGHT]) {
-        return true;
-    }
+    uint64_t pawns = this->_bitboards[side][PieceType::PAWN];
 
-    if (King::ATTACKS[square] & this->_bitboards[otherSide][PieceType::KING]) {
-        return true;
-    }
+    while (pawns) {
+        int from = BitUtility::popLSB(pawns);
 
-    uint64_t bishopAttacks = Bishop::getAttacks(square, this->_occupancyBoth);
+        if (Pawn::canSinglePush(from, side, empty)) {
+            int to = Pawn::singlePush(from, side);
 
-    if (bishopAttacks & (this->_bitboards[otherSide][PieceType::BISHOP] | this->_bitboards[otherSide][PieceType::QUEEN])) {
-        return true;
-    }
+            if ((blocks & BITBOARD_SQUARES[to]) && (Pawn::ENEMY_BACK_RANK[side] & BITBOARD_SQUARES[to])) {
+                evasions.add(from, to, MoveType::KNIGHT_PROMOTION);
+                evasions.add(from, to, MoveType::BISHOP_PROMOTION);
+                evasions.add(from, to, MoveType::ROOK_PROMOTION);
+                evasions.add(from, to, MoveType::QUEEN_PROMOTION);
+            } else if (blocks & BITBOARD_SQUARES[to]) {
+                evasions.add(from, to, MoveType::QUIET);
+            }
+        }
 
-    uint64_t rookAttacks = Rook::getAttacks(square, this->_occupancyBoth);
+        if (Pawn::canDoublePush(from, side, empty) && (blocks & BITBOARD_SQUARES[Pawn::doublePush(from, side)])) {
+            evasions.add(from, Pawn::doublePush(from, side), MoveType::DOUBLE_PAWN);
+        }
 
-    if (rookAttacks & (this->_bitboards[otherSide][PieceType::ROOK] | this->_bitboards[otherSide][PieceType::QUEEN])) {
-        return true;
-    }
+        uint64_t captureMoves = Pawn::ATTACKS[side][from] & checkers;
 
-    return false;
+        while (captureMoves) {
+            int to = BitUtility::popLSB(captureMoves);
+
+            if (Pawn::ENEMY_BACK_RANK[side] & BITBOARD_SQUARES[to]) {
+                evasions.add(from, to, MoveType::KNIGHT_PROMOTION_CAPTURE);
+                evasions.add(from, to, MoveType::BISHOP_PROMOTION_CAPTURE);
+                evasions.add(from, to, MoveType::ROOK_PROMOTION_CAPTURE);
+                evasions.add(from, to, MoveType::QUEEN_PROMOTION_CAPTURE);
+            } else {
+                evasions.add(from, to, MoveType::CAPTURE);
+            }
+        }
+
+        // Either removes a checking pawn or blocks a diagonal, the rest fail the legality check
+        if (this->_enPassantSquare != -1 && (Pawn::ATTACKS[side][from] & BITBOARD_SQUARES[this->_enPassantSquare])) {
+            evasions.add(from, this->_enPassantSquare, MoveType::EN_PASSANT);
+        }
+    }
+
+    for (int piece = PieceType::KNIGHT; piece <= PieceType::QUEEN; ++piece) {
+        uint64_t pieces = this->_bitboards[side][piece];
+
+        while (pieces) {
+            int from = BitUtility::popLSB(pieces);
+
+            uint64_t attacks = 0ULL;
+
+            switch (piece) {
+            case PieceType::KNIGHT:
+                attacks = Knight::ATTACKS[from];
+                break;
+            case PieceType::BISHOP:
+                attacks = Bishop::getAttacks(from, this->_occupancyBoth);
+                break;
+            case PieceType::ROOK:
+                attacks = Rook::getAttacks(from, this->_occupancyBoth);
+                break;
+            default:
+                attacks = Queen::getAttacks(from, this->_occupancyBoth);
+                break;
+            }
+
+            uint64_t blockMoves = attacks & blocks;
+
+            while (blockMoves) {
+                evasions.add(from, BitUtility::popLSB(blockMoves), MoveType::QUIET);
+            }
+
+            if (attacks & checkers) {
+                evasions.add(from, BitUtility::getLSBIndex(checkers), MoveType::CAPTURE);
+            }
+        }
+    }
+
+    return evasions;
+}
+
+bool Engine::isMoveLegal(uint16_t &move, ColourType side) {
+    this->makeMove(move, false);
+
+    bool isInCheck = this->isInCheck(side);
+
+    this->unmakeMove(move);
+
+    return !isInCheck;
+}
+
+bool Engine::isInCheck() {
+    return this->isInCheck(this->_side);
+}
+
+bool Engine::isInCheck(ColourType side) {
+    const uint64_t king = this->_bitboards[side][PieceType::KING];
+
+    if (this->_bitboards[side][PieceType::KING] == 0ULL) {
+        return false;
+    }
+
+    int kingSquare = BitUtility::getLSBIndex(king);
+
+    return this->isSquareAttacked(kingSquare, side);
+}
+
+bool Engine::isSquareAttacked(int square, ColourType side) {
+    ColourType otherSide = BoardUtility::getOtherSide(side);
+
+    if (Pawn::ATTACKS[side][square] & this->_bitboards[otherSide][PieceType::PAWN]) {
+        return true;
+    }
+
+    if (Knight::ATTACKS[square] & this->_bitboards[otherSide][PieceType::KNIGHT]) {
+        return true;
+    }
+
+    if (King::ATTACKS[square] & this->_bitboards[otherSide][PieceType::KING]) {
+        return true;
+    }
+
+    uint64_t bishopAttacks = Bishop::getAttacks(square, this->_occupancyBoth);
+
+    if (bishopAttacks & (this->_bitboards[otherSide][PieceType::BISHOP] | this->_bitboards[otherSide][PieceType::QUEEN])) {
+        return true;
+    }
+
+    uint64_t rookAttacks = Rook::getAttacks(square, this->_occupancyBoth);
+
+    if (rookAttacks & (this->_bitboards[otherSide][PieceType::ROOK] | this->_bitboards[otherSide][PieceType::QUEEN])) {
+        return true;
+    }
+
+    return false;
 }
 
 bool Engine::areSquaresAttacked(uint64_t squares, ColourType side) {
@@ -802,8 +1259,14 @@ void Engine::updateCastleRights(ColourType side) {
     }
 }
 
-// PERF: Make hash local variable since it's more efficient for the compiler
 void Engine::makeMove(uint16_t &move) {
+    this->makeMove(move, true);
+}
+
+// PERF: Make hash local variable since it's more efficient for the compiler
+void Engine::makeMove(uint16_t &move, bool isPrefetched) {
+    this->_repetitionTable[this->_repetitionIndex++ & (_REPETITION_TABLE_SIZE - 1)] = this->_zobrist;
+
     Undo undo;
 
     undo.castleRights = this->_castleRights;
@@ -823,12 +1286,32 @@ void Engine::makeMove(uint16_t &move) {
 
     PieceType fromPiece = BoardUtility::getPiece(this->_bitboards, from, this->_side);
 
+    PieceType capturedPiece = (Move::isCapture(move) || Move::isPromotionCapture(move)) ? BoardUtility::getPiece(this->_bitboards, to, otherSide) : PieceType::EMPTY;
+
+    // The child's key is known before the board is touched, so its bucket loads while the pieces move.
+    // Castling and castle right changes are left out, their prefetch is only a wasted hint
+    if (isPrefetched) {
+        uint64_t key = this->_zobrist ^ Zobrist::sideKey ^ Zobrist::pieceKeys[this->_side][fromPiece][from];
+
+        key ^= Zobrist::pieceKeys[this->_side][Move::isGeneralPromotion(move) ? promotionPiece : fromPiece][to];
+
+        if (capturedPiece != PieceType::EMPTY) {
+            key ^= Zobrist::pieceKeys[otherSide][capturedPiece][to];
+        }
+
+        if (Move::isDoublePawn(move)) {
+            key ^= Zobrist::enPassantKeys[EN_PASSANT_SQUARES[this->_side][BoardUtility::getFile(from)]];
+        }
+
+        PREFETCH(&this->_transpositionTable[key & this->_transpositionTableMask]);
+    }
+
     bool isCapture = false;
 
     if (Move::isQuiet(move)) {
         this->makeQuietMove(from, to, fromPiece);
     } else if (Move::isCapture(move)) {
-        this->makeCaptureMove(from, to, undo, fromPiece, otherSide);
+        this->makeCaptureMove(from, to, undo, fromPiece, capturedPiece, otherSide);
 
         isCapture = true;
     } else if (Move::isDoublePawn(move)) {
@@ -842,7 +1325,7 @@ void Engine::makeMove(uint16_t &move) {
     } else if (Move::isPromotionQuiet(move)) {
         this->makePromotionQuietMove(from, to, promotionPiece);
     } else if (Move::isPromotionCapture(move)) {
-        this->makePromotionCaptureMove(from, to, promotionPiece, undo, otherSide);
+        this->makePromotionCaptureMove(from, to, promotionPiece, undo, capturedPiece, otherSide);
     }
 
     this->updateCastleRights();
@@ -862,6 +1345,8 @@ void Engine::makeMove(uint16_t &move) {
 
     this->_zobrist ^= Zobrist::sideKey;
 
+    this->_fullMove += (this->_side == ColourType::BLACK);
+
     this->switchSide();
 }
 
@@ -869,8 +1354,13 @@ void Engine::makeNullMove() {
     // TODO: remember to update zobrist if we have TT
     Undo undo;
 
-    // Only need to copy the en passant square
+    this->_repetitionTable[this->_repetitionIndex++ & (_REPETITION_TABLE_SIZE - 1)] = this->_zobrist;
+
+    // Only need to copy the en passant square, the half move clock is cleared so repetitions never span a null move
     undo.enPassantSquare = this->_enPassantSquare;
+    undo.halfMove = this->_halfMove;
+
+    this->_halfMove = 0;
 
     if (this->_enPassantSquare != -1) {
         this->_zobrist ^= Zobrist::enPassantKeys[this->_enPassantSquare];
@@ -881,6 +1371,8 @@ void Engine::makeNullMove() {
 
     this->_zobrist ^= Zobrist::sideKey;
 
+    PREFETCH(&this->_transpositionTable[this->_zobrist & this->_transpositionTableMask]);
+
     this->switchSide();
 }
 
@@ -900,8 +1392,11 @@ void Engine::unmakeNullMove() {
     }
 
     this->_enPassantSquare = undo.enPassantSquare;
+    this->_halfMove = undo.halfMove;
 
     this->_undoStack.pop_back();
+
+    --this->_repetitionIndex;
 }
 
 void Engine::unmakeMove(uint16_t &move) {
@@ -952,7 +1447,11 @@ void Engine::unmakeMove(uint16_t &move) {
     this->_enPassantSquare = undo.enPassantSquare;
     this->_halfMove = undo.halfMove;
 
+    this->_fullMove -= (this->_side == ColourType::BLACK);
+
     this->_undoStack.pop_back();
+
+    --this->_repetitionIndex;
 }
 
 void Engine::makeQuietMove(int from, int to, PieceType fromPiece) {
@@ -961,9 +1460,7 @@ void Engine::makeQuietMove(int from, int to, PieceType fromPiece) {
     this->createPiece(to, fromPiece, this->_side);
 }
 
-void Engine::makeCaptureMove(int from, int to, Undo &undo, PieceType fromPiece, ColourType otherSide) {
-    PieceType capturedPiece = BoardUtility::getPiece(this->_bitboards, to, otherSide);
-
+void Engine::makeCaptureMove(int from, int to, Undo &undo, PieceType fromPiece, PieceType capturedPiece, ColourType otherSide) {
     this->removePiece(from, fromPiece, this->_side);
 
     this->removePiece(to, capturedPiece, otherSide);
@@ -1025,9 +1522,7 @@ void Engine::makePromotionQuietMove(int from, int to, PieceType promotionPiece)
     this->createPiece(to, promotionPiece, this->_side);
 }
 
-void Engine::makePromotionCaptureMove(int from, int to, PieceType promotionPiece, Undo &undo, ColourType otherSide) {
-    PieceType capturedPiece = BoardUtility::getPiece(this->_bitboards, to, otherSide);
-
+void Engine::makePromotionCaptureMove(int from, int to, PieceType promotionPiece, Undo &undo, PieceType capturedPiece, ColourType otherSide) {
     this->removePiece(from, PieceType::PAWN, this->_side);
 
     this->removePiece(to, capturedPiece, otherSide);
@@ -1112,17 +1607,101 @@ void Engine::storeKillerMove(const uint16_t move, int ply) {
     this->_killerMoves[0][ply] = move;
 }
 
-void Engine::storeHistoryMove(const uint16_t move, ColourType side, int depth) {
-    if (!Move::isHistory(move)) {
-        return;
+void Engine::clearHistories() {
+    std::memset(this->_killerMoves, 0, sizeof(this->_killerMoves));
+    std::memset(this->_historyMoves, 0, sizeof(this->_historyMoves));
+    std::memset(this->_captureHistory, 0, sizeof(this->_captureHistory));
+    std::memset(this->_counterMoves, 0, sizeof(this->_counterMoves));
+
+    for (engine::search::History::ContinuationHistory &continuationHistory : this->_continuationHistory) {
+        std::memset(continuationHistory.scores, 0, sizeof(continuationHistory.scores));
     }
+}
 
-    int from = Move::getFrom(move);
-    int to = Move::getTo(move);
+void Engine::ageHistories() {
+    engine::search::History::age(&this->_historyMoves[0][0][0], sizeof(this->_historyMoves) / sizeof(int16_t));
+    engine::search::History::age(&this->_captureHistory[0][0][0][0], sizeof(this->_captureHistory) / sizeof(int16_t));
+
+    for (engine::search::History::ContinuationHistory &continuationHistory : this->_continuationHistory) {
+        engine::search::History::age(&continuationHistory.scores[0][0][0][0][0], sizeof(continuationHistory.scores) / sizeof(int16_t));
+    }
+
+    // Plies played since the last search root, two against an opponent but one when a single engine plays both sides, negative after taking moves back
+    const int plies = this->_repetitionIndex - this->_searchRootIndex;
+
+    // Killers of the old ply at that distance are killers of the new root
+    for (int killer = 0; killer < MAX_KILLER_MOVES; ++killer) {
+        for (int ply = 0; ply < MAX_PLY; ++ply) {
+            this->_killerMoves[killer][ply] = (plies >= 0 && ply + plies < MAX_PLY) ? this->_killerMoves[killer][ply + plies] : 0U;
+        }
+    }
+}
+
+// Butterfly history plus the continuation histories of the moves one and two plies earlier
+int Engine::getQuietHistory(ColourType side, PieceType piece, int to, int ply) {
+    int score = this->_historyMoves[side][piece][to];
+
+    for (int plies = 1; plies <= engine::search::History::CONTINUATION_PLIES && plies <= ply; ++plies) {
+        const uint16_t previousMove = this->_searchMoves[ply - plies];
+
+        if (previousMove != 0U) {
+            score += this->_continuationHistory[plies - 1].scores[this->_searchPieces[ply - plies]][Move::getTo(previousMove)][side][piece][to];
+        }
+    }
+
+    return score;
+}
+
+void Engine::updateQuietHistory(ColourType side, PieceType piece, int to, int ply, int bonus) {
+    engine::search::History::update(this->_historyMoves[side][piece][to], bonus);
+
+    for (int plies = 1; plies <= engine::search::History::CONTINUATION_PLIES && plies <= ply; ++plies) {
+        const uint16_t previousMove = this->_searchMoves[ply - plies];
+
+        if (previousMove != 0U) {
+            engine::search::History::update(this->_continuationHistory[plies - 1].scores[this->_searchPieces[ply - plies]][Move::getTo(previousMove)][side][piece][to], bonus);
+        }
+    }
+}
+
+// Called on a beta cutoff with the position restored, the moves searched before the cutoff move get the bonus as a malus
+void Engine::updateHistories(const uint16_t bestMove, int depth, int ply, const MoveList &quiets, const MoveList &captures) {
+    ColourType otherSide = BoardUtility::getOtherSide(this->_side);
+
+    int bonus = engine::search::History::getBonus(depth);
+
+    int bestTo = Move::getTo(bestMove);
+
+    PieceType bestPiece = BoardUtility::getPiece(this->_bitboards, Move::getFrom(bestMove), this->_side);
+
+    if (Move::isHistory(bestMove)) {
+        this->updateQuietHistory(this->_side, bestPiece, bestTo, ply, bonus);
+
+        for (int i = 0; i < quiets.size; ++i) {
+            const uint16_t quiet = quiets.moves[i];
+
+            this->updateQuietHistory(this->_side, BoardUtility::getPiece(this->_bitboards, Move::getFrom(quiet), this->_side), Move::getTo(quiet), ply, -bonus);
+        }
+
+        if (ply > 0 && this->_searchMoves[ply - 1] != 0U) {
+            this->_counterMoves[otherSide][this->_searchPieces[ply - 1]][Move::getTo(this->_searchMoves[ply - 1])] = bestMove;
+        }
+    } else if (Move::isGeneralCapture(bestMove)) {
+        PieceType bestToPiece = Move::isEnPassant(bestMove) ? PieceType::PAWN : BoardUtility::getPiece(this->_bitboards, bestTo, otherSide);
+
+        engine::search::History::update(this->_captureHistory[this->_side][bestPiece][bestTo][bestToPiece], bonus);
+    }
 
-    PieceType fromPiece = BoardUtility::getPiece(this->_bitboards, from, side);
+    // A capture searched first that did not cut is worse than its MVV-LVA rank suggests
+    for (int i = 0; i < captures.size; ++i) {
+        const uint16_t capture = captures.moves[i];
+
+        int to = Move::getTo(capture);
 
-    this->_historyMoves[side][fromPiece][to] += depth;
+        PieceType toPiece = Move::isEnPassant(capture) ? PieceType::PAWN : BoardUtility::getPiece(this->_bitboards, to, otherSide);
+
+        engine::search::History::update(this->_captureHistory[this->_side][BoardUtility::getPiece(this->_bitboards, Move::getFrom(capture), this->_side)][to][toPiece], -bonus);
+    }
 }
 
 void Engine::storePVMove(const uint16_t move, int ply) {
@@ -1138,7 +1717,7 @@ void Engine::storePVMove(const uint16_t move, int ply) {
 // TODO: Sort moves
 // TT hash moves [+]
 // PV moves [+]
-// Refutation Table [-]
+// Refutation Table [+]
 // MVV-LVA captures + (SEE?) [+][-]
 // Killer Moves [+]
 // History [+]
@@ -1150,6 +1729,12 @@ void Engine::orderMoves(Move::MoveList &moves, uint16_t ttMove, ColourType side,
     // WARN: Potential bug [ply][ply] or [0][ply]
     uint16_t pvMove = this->_pvTable[0][ply];
 
+    uint16_t counterMove = 0U;
+
+    if (ply > 0 && this->_searchMoves[ply - 1] != 0U) {
+        counterMove = this->_counterMoves[otherSide][this->_searchPieces[ply - 1]][Move::getTo(this->_searchMoves[ply - 1])];
+    }
+
     for (int i = 0; i < moves.size; ++i) {
         const uint16_t move = moves.moves[i];
 
@@ -1172,15 +1757,17 @@ void Engine::orderMoves(Move::MoveList &moves, uint16_t ttMove, ColourType side,
                 toPiece = PieceType::PAWN;
             }
 
-            score = MVV_LVA[fromPiece][toPiece] + MVV_LVA_OFFSET;
+            score = MVV_LVA[fromPiece][toPiece] * MVV_LVA_SCALE + this->_captureHistory[side][fromPiece][to][toPiece] / CAPTURE_HISTORY_DIVISOR + MVV_LVA_OFFSET;
             // scores[i] += this->seeMove(from, to, toPiece, side);
         } else {
             if (this->_killerMoves[0][ply] == move) {
-                score = MVV_LVA_OFFSET - KILLER_VALUE;
+                score = MVV_LVA_OFFSET - this->_tunables.KILLER_VALUE;
             } else if (this->_killerMoves[1][ply] == move) {
-                score = MVV_LVA_OFFSET - (KILLER_VALUE << 1);
+                score = MVV_LVA_OFFSET - (this->_tunables.KILLER_VALUE << 1);
+            } else if (counterMove == move) {
+                score = MVV_LVA_OFFSET - this->_tunables.KILLER_VALUE * 3;
             } else {
-                score = this->_historyMoves[side][fromPiece][to];
+                score = this->getQuietHistory(side, fromPiece, to, ply);
             }
         }
 
@@ -1202,61 +1789,111 @@ void Engine::orderMoves(Move::MoveList &moves, uint16_t ttMove, ColourType side,
     }
 }
 
+// Material balance of the exchange started by this capture, each side may stop capturing when it would lose more
 int Engine::seeMove(int from, int to, PieceType toPiece, ColourType side) {
-    return this->see(to, toPiece, side);
-}
-
-int Engine::see(int to, PieceType toPiece, ColourType side) {
     uint64_t bitboards[2][6];
 
+    std::memcpy(bitboards, this->_bitboards, sizeof(this->_bitboards));
+
     uint64_t occupancyBoth = this->_occupancyBoth;
 
-    std::memcpy(bitboards, this->_bitboards, sizeof(this->_bitboards));
+    PieceType fromPiece = BoardUtility::getPiece(bitboards, from, side);
 
-    std::function<int(int, uint64_t[2][6], uint64_t, ColourType, int)> seeUtil = [&](int _square, uint64_t _bitboards[2][6], uint64_t _occupancyBoth, ColourType _side, int _seeScore) -> int {
-        int _from;
+    // Longest possible exchange, every piece on the board takes once
+    int gains[32];
 
-        PieceType _fromPiece;
+    int depth = 0;
 
-        if (!AttackUtility::getLeastValuableAttacker(_square, _bitboards, _occupancyBoth, _side, _from, _fromPiece)) {
-            return 0;
-        }
+    gains[0] = MATERIAL_TABLE[toPiece];
+
+    bitboards[side][fromPiece] &= INVERTED_BITBOARD_SQUARES[from];
+    occupancyBoth &= INVERTED_BITBOARD_SQUARES[from];
+
+    // Removing each capturer from the occupancy uncovers the sliders behind it
+    PieceType squarePiece = fromPiece;
 
-        const uint64_t invertedFromMask = INVERTED_BITBOARD_SQUARES[_from];
+    ColourType attackerSide = BoardUtility::getOtherSide(side);
 
-        _bitboards[_side][_fromPiece] &= invertedFromMask;
-        _occupancyBoth &= invertedFromMask;
+    int attackerSquare;
 
-        ColourType otherSide = BoardUtility::getOtherSide(_side);
+    PieceType attackerPiece;
 
-        int gain = _seeScore - seeUtil(_square, _bitboards, _occupancyBoth, otherSide, MATERIAL_TABLE[_fromPiece]);
+    while (AttackUtility::getLeastValuableAttacker(to, bitboards, occupancyBoth, attackerSide, attackerSquare, attackerPiece)) {
+        ++depth;
 
-        return (gain > 0) ? gain : 0;
-    };
+        gains[depth] = MATERIAL_TABLE[squarePiece] - gains[depth - 1];
 
-    return seeUtil(to, bitboards, occupancyBoth, side, MATERIAL_TABLE[toPiece]);
+        bitboards[attackerSide][attackerPiece] &= INVERTED_BITBOARD_SQUARES[attackerSquare];
+        occupancyBoth &= INVERTED_BITBOARD_SQUARES[attackerSquare];
+
+        squarePiece = attackerPiece;
+
+        attackerSide = BoardUtility::getOtherSide(attackerSide);
+    }
+
+    while (depth > 0) {
+        gains[depth - 1] = -std::max(-gains[depth - 1], gains[depth]);
+
+        --depth;
+    }
+
+    return gains[0];
 }
 
 bool Engine::isNMP(bool isPVNode, bool isParentInCheck, int depth, int ply) {
-    return depth >= 3 && !isPVNode && !isParentInCheck && ply > 0;
+    return depth >= this->_tunables.NMP_DEPTH && !isPVNode && !isParentInCheck && ply > 0;
 }
 
 bool Engine::isRazoring(bool isPVNode, bool isParentInCheck, int depth) {
-    return depth <= 3 && !isPVNode && !isParentInCheck;
+    return depth <= this->_tunables.RAZOR_DEPTH && !isPVNode && !isParentInCheck;
+}
+
+// Far enough above beta that no reply is expected to bring the score back, unless beta is a mate score
+bool Engine::isReverseFutility(bool isPVNode, bool isParentInCheck, int depth, int staticEvaluation, int beta, bool isImproving) {
+    return depth <= this->_tunables.RFP_DEPTH && !isPVNode && !isParentInCheck && std::abs(beta) < Score::CHECKMATE_THRESHOLD && staticEvaluation - this->_tunables.RFP_MARGIN * (depth - isImproving) >= beta;
+}
+
+// Quiet moves cannot raise a score this far below alpha at the frontier, unless alpha is a mated score
+bool Engine::isFutility(bool isPVNode, bool isParentInCheck, int depth, int staticEvaluation, int alpha) {
+    return depth <= this->_tunables.FUTILITY_DEPTH && !isPVNode && !isParentInCheck && alpha > -Score::CHECKMATE_THRESHOLD && staticEvaluation + this->_tunables.FUTILITY_MARGIN * depth <= alpha;
+}
+
+// Quiet moves this late in the ordering rarely raise alpha at low depth
+bool Engine::isLateMovePrune(bool isPVNode, bool isParentInCheck, int depth, int legalMoves, int alpha, bool isImproving) {
+    return depth <= this->_tunables.LMP_DEPTH && !isPVNode && !isParentInCheck && alpha > -Score::CHECKMATE_THRESHOLD && legalMoves >= (this->_tunables.LMP_BASE + depth * depth) / (2 - isImproving);
 }
 
 // Assume called after move is made
 // DO NOT reduce if we are in check, or we are giving checks or move is tactical
-bool Engine::isLMR(const uint16_t move, bool isPVNode, bool isParentInCheck) {
+bool Engine::isLMR(const uint16_t move, bool isParentInCheck) {
     bool isChildInCheck = this->isInCheck(this->_side);
 
-    return !(isPVNode || isParentInCheck || isChildInCheck || Move::isLMR(move));
+    return !(isParentInCheck || isChildInCheck || !Move::isLMR(move));
+}
+
+// Assume called after move is made
+// PV nodes and moves with good history are reduced less, expected cut nodes and positions getting worse more
+int Engine::getLMRDepth(const uint16_t move, int depth, int ply, int moveNumber, bool isPVNode, bool isCutNode, bool isImproving) {
+    int reduction = this->_reductions[depth][std::min(moveNumber, engine::search::Reduction::MAX_MOVES - 1)];
+
+    ColourType otherSide = BoardUtility::getOtherSide(this->_side);
+
+    int to = Move::getTo(move);
+
+    PieceType toPiece = BoardUtility::getPiece(this->_bitboards, to, otherSide);
+
+    reduction -= isPVNode;
+    reduction += isCutNode;
+    reduction += !isImproving;
+    reduction -= this->getQuietHistory(otherSide, toPiece, to, ply) / this->_tunables.LMR_HISTORY;
+
+    // Never extend, and never drop straight into quiescence
+    return std::clamp(depth - 1 - reduction, 1, depth - 1);
 }
 
 // PERF: performing large mod operations could be costly, use fast mod if needed
 int Engine::probeTranspositionTable(int alpha, int beta, int depth, int ply, uint16_t &bestMove) {
-    const size_t index = this->_zobrist & Transposition::TRANSPOSITION_TABLE_MASK;
-    // const size_t index = this->_zobrist % Transposition::TRANSPOSITION_TABLE_ENTRIES;
+    const size_t index = this->_zobrist & this->_transpositionTableMask;
 
     Transposition::Entry *entry = &this->_transpositionTable[index];
 
@@ -1292,13 +1929,28 @@ int Engine::probeTranspositionTable(int alpha, int beta, int depth, int ply, uin
     return -1;
 }
 
+const Transposition::Entry *Engine::getTranspositionTableEntry() {
+    const Transposition::Entry *entry = &this->_transpositionTable[this->_zobrist & this->_transpositionTableMask];
+
+    return (entry->zobrist == this->_zobrist) ? entry : nullptr;
+}
+
+// The TT move needs a lower bound from nearly this depth, extensions stop before lines outgrow the ply indexed tables
+bool Engine::isSingularExtension(const Transposition::Entry *entry, uint16_t ttMove, int depth, int ply) {
+    return entry != nullptr && ply > 0 && ply + depth < this->_MAX_SEARCH_DEPTH && entry->bestMove == ttMove && entry->depth >= depth - 3 && entry->nodeType != Transposition::NodeType::ALPHA && std::abs(entry->score) < Score::CHECKMATE_THRESHOLD;
+}
+
 // PERF: Try deeper replacement policy
 void Engine::recordTranspositionTableEntry(int score, int depth, Transposition::NodeType nodeType, int ply, uint16_t bestMove) {
-    const size_t index = this->_zobrist & Transposition::TRANSPOSITION_TABLE_MASK;
-    // const size_t index = this->_zobrist % Transposition::TRANSPOSITION_TABLE_ENTRIES;
+    const size_t index = this->_zobrist & this->_transpositionTableMask;
 
     Transposition::Entry *entry = &this->_transpositionTable[index];
 
+    // Quiescence results only fill empty or quiescence slots, evicting a searched entry would throw away far more work than they hold
+    if (depth == 0 && entry->depth > 0) {
+        return;
+    }
+
     // Write the mating score (Bruce Mo), this side is mating- distance from root to mate
     if (score > Score::CHECKMATE_THRESHOLD) {
         score += ply;
@@ -1319,18 +1971,23 @@ void Engine::recordTranspositionTableEntry(int score, int depth, Transposition::
     entry->nodeType = nodeType;
 }
 
-bool Engine::isRepetition(int ply) {
-    // BUG: This harms the performance of the engine for some reason
-    // if (this->_halfMove >= 100) {
-    //     return true;
-    // }
+uint64_t Engine::getPreviousKey(int plies) {
+    return this->_repetitionTable[(this->_repetitionIndex - plies) & (_REPETITION_TABLE_SIZE - 1)];
+}
 
-    if (ply == 0) {
-        return false;
-    }
+// Only positions since the last irreversible move can repeat, and only every other ply with the same side to move
+bool Engine::isRepetition() {
+    const int end = std::min({ static_cast<int>(this->_halfMove), this->_repetitionIndex, _REPETITION_TABLE_SIZE });
+
+    int repetitions = 0;
 
-    for (int i = 0; i < this->_repetitionIndex; ++i) {
-        if (this->_repetitionTable[i] == this->_zobrist) {
+    for (int plies = 4; plies <= end; plies += 2) {
+        if (this->getPreviousKey(plies) != this->_zobrist) {
+            continue;
+        }
+
+        // Repeating a position of the search is enough, a played position needs to have occurred twice
+        if (this->_repetitionIndex - plies >= this->_searchRootIndex || ++repetitions == 2) {
             return true;
         }
     }
@@ -1338,711 +1995,902 @@ bool Engine::isRepetition(int ply) {
     return false;
 }
 
-// TODO: Search extension
-// Low mobility [-]
-// In-check [+]
-// Last move is capturing [-]
-// Current best score is much lower than the value of previous ply [-]
-void Engine::searchIterative(int depth) {
-    LOG_INFO("Score for white: {}", this->evaluate(ColourType::WHITE));
-    LOG_INFO("Score for black: {}", this->evaluate(ColourType::BLACK));
+// True when one reversible move leads back to a position of the search, so the side to move can force a draw
+bool Engine::hasUpcomingRepetition(int ply) {
+    const int end = std::min({ static_cast<int>(this->_halfMove), this->_repetitionIndex, _REPETITION_TABLE_SIZE - 1 });
 
-    std::memset(this->_killerMoves, 0, sizeof(this->_killerMoves));
-    std::memset(this->_historyMoves, 0, sizeof(this->_historyMoves));
-    std::memset(this->_pvLength, 0, sizeof(this->_pvLength));
-    std::memset(this->_pvTable, 0, sizeof(this->_pvTable));
+    if (end < 3) {
+        return false;
+    }
 
-    int alpha = -Score::INF;
-    int beta = Score::INF;
+    const uint64_t originalKey = this->_zobrist;
 
-    int currentDepth = 1;
+    // Zero once the other side's moves since then cancel out
+    uint64_t otherKey = originalKey ^ this->getPreviousKey(1) ^ Zobrist::sideKey;
 
-    while (currentDepth <= depth) {
-        this->_searchResult.nodes = 0;
+    for (int plies = 3; plies <= end && plies < ply; plies += 2) {
+        otherKey ^= this->getPreviousKey(plies - 1) ^ this->getPreviousKey(plies) ^ Zobrist::sideKey;
 
-        int score = this->search(alpha, beta, currentDepth, 0);
+        if (otherKey != 0ULL) {
+            continue;
+        }
 
-        if ((score <= alpha) || (score >= beta)) {
-            LOG_INFO("Re-searching depth {} again for alpha: {} beta: {} best score: {}", currentDepth, alpha, beta, score);
+        const uint64_t moveKey = originalKey ^ this->getPreviousKey(plies);
 
-            alpha = -Score::INF;
-            beta = Score::INF;
+        int index = Cuckoo::getFirstIndex(moveKey);
 
-            continue;
-        }
+        if (Cuckoo::keys[index] != moveKey) {
+            index = Cuckoo::getSecondIndex(moveKey);
 
-        alpha = score - this->_ASPIRATION_WINDOW_VALUE;
-        beta = score + this->_ASPIRATION_WINDOW_VALUE;
+            if (Cuckoo::keys[index] != moveKey) {
+                continue;
+            }
+        }
 
-        LOG_INFO("Number of nodes at depth {}: {}", currentDepth, this->_searchResult.nodes);
+        const uint16_t move = Cuckoo::moves[index];
 
-        ++currentDepth;
+        if ((Between::SQUARES[move & 0x3F][move >> 6] & this->_occupancyBoth) == 0ULL) {
+            return true;
+        }
     }
 
-    this->_searchResult.bestMove = this->_pvTable[0][0];
+    return false;
+}
 
-    if (this->_searchResult.bestMove == 0U) {
-        // throw std::runtime_error("Engine could not find move...");
-        LOG_ERROR("Engine could not find a move...");
+// Mate on the hundredth ply still counts
+bool Engine::isFiftyMoveDraw() {
+    return this->_halfMove >= 2 * _MAX_HALF_MOVES && (!this->isInCheck(this->_side) || this->hasLegalMove());
+}
+
+// Recognised endgames that are a dead draw, the whole subtree can be cut
+bool Engine::isDrawnEndgame() {
+    if (BitUtility::popCount(this->_occupancyBoth) > endgame::MAX_PIECES) {
+        return false;
     }
+
+    int score = 0;
+
+    return endgame::evaluate(this->_bitboards, this->_side, score) && score == 0;
 }
 
-void Engine::searchRoot(int depth) {
-    std::memset(this->_killerMoves, 0, sizeof(this->_killerMoves));
-    std::memset(this->_historyMoves, 0, sizeof(this->_historyMoves));
-    std::memset(this->_pvLength, 0, sizeof(this->_pvLength));
-    std::memset(this->_pvTable, 0, sizeof(this->_pvTable));
+// Exact distance to mate, tables ignore castling and en passant so those positions are searched normally
+bool Engine::probeTablebase(int ply, int &score) {
+    if (this->_tablebase == nullptr || this->_castleRights != 0 || this->_enPassantSquare != -1) {
+        return false;
+    }
 
-    this->search(-Score::INF, Score::INF, depth, 0);
+    if (BitUtility::popCount(this->_occupancyBoth) > this->_tablebase->getMaxPieces()) {
+        return false;
+    }
 
-    this->_searchResult.bestMove = this->_pvTable[0][0];
+    uint8_t value = engine::tablebase::UNKNOWN;
 
-    if (this->_searchResult.bestMove == 0U) {
-        // throw std::runtime_error("Engine could not find move...");
-        LOG_ERROR("Engine could not find a move...");
+    if (!this->_tablebase->probe(this->_bitboards, this->_side, value)) {
+        return false;
     }
-}
 
-// PERF: Includes:
-// Null move pruning [+]
-// Late move reduction [+]
-// Razoring [-]
-// WARN: Always probing the TT
-int Engine::search(int alpha, int beta, int depth, int ply) {
-    ++this->_searchResult.nodes;
-
-    // Initialise pv length
-    this->_pvLength[ply] = ply;
-
-    // TODO: Return contempt
-    // if (this->isRepetition(ply)) {
-    //     this->recordTranspositionTableEntry(0, depth, Transposition::NodeType::EXACT, ply);
-    //
-    //     return 0;
-    // }
-
-    uint16_t ttMove = 0U;
+    if (engine::tablebase::isWin(value)) {
+        score = Score::CHECKMATE_SCORE - ply - engine::tablebase::getDistance(value);
+    } else if (engine::tablebase::isLoss(value)) {
+        score = -Score::CHECKMATE_SCORE + ply + engine::tablebase::getDistance(value);
+    } else {
+        score = 0;
+    }
 
-    int transpositionTableScore = this->probeTranspositionTable(alpha, beta, depth, ply, ttMove);
+    return true;
+}
 
-    if (transpositionTableScore != -1) {
-        return transpositionTableScore;
+// Polyglot encodes castling as the king capturing its own rook
+bool Engine::getBookMove(uint16_t &move) {
+    if (this->_book == nullptr) {
+        return false;
     }
 
-    if (depth == 0) {
-        return this->quiescence(alpha, beta, ply);
+    uint16_t bookMove = this->_book->getMove(this->getPolyglotKey(), this->_bookGenerator);
+
+    if (bookMove == 0U) {
+        return false;
     }
 
-    bool isPVNode = (beta - alpha > 1);
+    int bookFrom = engine::book::getFrom(bookMove);
+    int bookTo = engine::book::getTo(bookMove);
 
-    bool isParentInCheck = this->isInCheck(this->_side);
+    PieceType bookPromotionPiece = engine::book::getPromotionPiece(bookMove);
 
-    // Search extension for parent in check
-    // if (isParentInCheck) {
-    //     ++depth;
-    // }
+    MoveList moves = this->generateMoves(this->_side);
 
-    // NMP
-    if (this->isNMP(isPVNode, isParentInCheck, depth, ply)) {
-        this->_repetitionTable[this->_repetitionIndex++] = this->_zobrist;
+    for (int i = 0; i < moves.size; ++i) {
+        uint16_t &candidate = moves.moves[i];
 
-        this->makeNullMove();
+        int to = Move::getTo(candidate);
 
-        int score = -this->search(-beta, -beta + 1, depth - 1 - this->_NMP_REDUCTION, ply + 1);
+        if (Move::isKingCastle(candidate)) {
+            to = ROOK_ORIGIN_SQUARES[(this->_side == ColourType::WHITE) ? Castle::WHITE_KING : Castle::BLACK_KING];
+        } else if (Move::isQueenCastle(candidate)) {
+            to = ROOK_ORIGIN_SQUARES[(this->_side == ColourType::WHITE) ? Castle::WHITE_QUEEN : Castle::BLACK_QUEEN];
+        }
 
-        this->unmakeNullMove();
+        PieceType promotionPiece = Move::isGeneralPromotion(candidate) ? Move::getPromotionPiece(candidate) : PieceType::EMPTY;
 
-        --this->_repetitionIndex;
+        if (Move::getFrom(candidate) != bookFrom || to != bookTo || promotionPiece != bookPromotionPiece) {
+            continue;
+        }
 
-        if (score >= beta) {
-            return beta;
+        if (!this->isMoveLegal(candidate, this->_side)) {
+            break;
         }
+
+        move = candidate;
+
+        LOG_INFO("Playing book move {}{}", BoardUtility::getPositionFromSquare(bookFrom), BoardUtility::getPositionFromSquare(Move::getTo(candidate)));
+
+        return true;
     }
 
-    // Razoring- check how "bad" we are doing, and if bad enough, all is lost lol
-    if (this->isRazoring(isPVNode, isParentInCheck, depth)) {
-        int score = this->evaluate(this->_side) + 125;
+    LOG_WARN("Ignoring illegal book move for key {:#018x}", this->getPolyglotKey());
 
-        if (score < beta) {
-            score += 175;
+    return false;
+}
 
-            if (depth == 1) {
-                return std::max(score, this->quiescence(alpha, beta, ply));
-            }
+// Only polled every few thousand nodes, and never before the first depth completes so there is always a move
+bool Engine::isSearchStopped() {
+    if (this->_isStopped) {
+        return true;
+    }
 
-            if (score < beta && depth <= 2) {
-                return std::max(score, this->quiescence(alpha, beta, ply));
-            }
+    if ((this->_searchResult.nodes & this->_STOP_CHECK_MASK) != 0 || this->_searchIterations.empty()) {
+        return false;
+    }
+
+    const uint64_t nodes = this->_searchNodes + this->_searchResult.nodes;
+
+    if (this->_searchLimits.nodes != 0ULL && nodes >= this->_searchLimits.nodes) {
+        this->_isStopped = true;
+    }
+
+    if (this->_searchLimits.time != 0 && this->getElapsedTime() >= this->_searchLimits.time) {
+        this->_isStopped = true;
+    }
+
+    return this->_isStopped;
+}
+
+bool Engine::isRootExcluded(const uint16_t move, int ply) {
+    if (ply > 0) {
+        return false;
+    }
+
+    for (int i = 0; i < this->_rootExcludedMoves.size; ++i) {
+        if (this->_rootExcludedMoves.moves[i] == move) {
+            return true;
         }
     }
 
-    bool isLegalMoveFound = false;
+    return false;
+}
 
-    MoveList moves = this->generateMoves(this->_side);
+int64_t Engine::getElapsedTime() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - this->_searchStart).count();
+}
 
-    Transposition::NodeType transpositionTableNodeType = Transposition::NodeType::ALPHA;
+// Fastest mate when winning, slowest when losing, and any drawing move otherwise
+bool Engine::getTablebaseMove(uint16_t &move) {
+    int score = 0;
 
-    this->orderMoves(moves, ttMove, this->_side, ply);
+    if (!this->probeTablebase(0, score)) {
+        return false;
+    }
+
+    int bestScore = -Score::INF;
+
+    uint16_t bestMove = 0U;
+
+    MoveList moves = this->generateMoves(this->_side);
 
     for (int i = 0; i < moves.size; ++i) {
-        uint16_t &move = moves.moves[i];
+        uint16_t &candidate = moves.moves[i];
 
-        if (!this->isMoveLegal(move, this->_side)) {
+        if (!this->isMoveLegal(candidate, this->_side)) {
             continue;
         }
 
-        isLegalMoveFound = true;
+        this->makeMove(candidate);
 
-        this->_repetitionTable[this->_repetitionIndex++] = this->_zobrist;
+        bool isProbed = this->probeTablebase(1, score);
 
-        this->makeMove(move);
+        this->unmakeMove(candidate);
 
-        int score;
+        if (!isProbed) {
+            return false;
+        }
 
-        // Full search first (number of moves searched = i)
-        if (i == 0) {
-            score = -this->search(-beta, -alpha, depth - 1, ply + 1);
-        } else {
-            // PERF: LMR tuning
-            if (i >= this->_FULL_DEPTH && depth >= this->_REDUCTION_LIMIT && this->isLMR(move, isPVNode, isParentInCheck)) {
-                score = -this->search(-alpha - 1, -alpha, depth - this->_REDUCTION_DEPTH, ply + 1);
-            } else {
-                score = alpha + 1;
+        if (-score > bestScore) {
+            bestScore = -score;
+            bestMove = candidate;
+        }
+    }
+
+    if (bestMove == 0U) {
+        return false;
+    }
+
+    move = bestMove;
+
+    LOG_INFO("Playing tablebase move {}{} with score {}", BoardUtility::getPositionFromSquare(Move::getFrom(move)), BoardUtility::getPositionFromSquare(Move::getTo(move)), bestScore);
+
+    return true;
+}
+
+// TODO: Search extension
+// Low mobility [-]
+// In-check [+]
+// Singular [+]
+// Last move is capturing [-]
+// Current best score is much lower than the value of previous ply [-]
+void Engine::searchIterative(int depth) {
+    LOG_INFO("Score for white: {}", this->evaluate(ColourType::WHITE));
+    LOG_INFO("Score for black: {}", this->evaluate(ColourType::BLACK));
+
+    this->ageHistories();
+
+    std::memset(this->_pvLength, 0, sizeof(this->_pvLength));
+    std::memset(this->_pvTable, 0, sizeof(this->_pvTable));
+    std::memset(this->_excludedMoves, 0, sizeof(this->_excludedMoves));
+
+    this->_searchIterations.clear();
+
+    this->_searchStart = std::chrono::steady_clock::now();
+    this->_searchNodes = 0ULL;
+
+    this->_searchStatistics = SearchStatistics{};
+
+    this->_searchRootIndex = this->_repetitionIndex;
+
+    this->_isStopped = false;
+
+    this->_searchResult.bestMove = 0U;
+
+    this->_principalVariations.clear();
+
+    // Fewer lines than asked for when there are fewer legal moves, a mated or stalemated root still searches one
+    int legalMoves = 0;
+
+    MoveList rootMoves = this->generateMoves(this->_side);
+
+    for (int i = 0; i < rootMoves.size; ++i) {
+        legalMoves += this->isMoveLegal(rootMoves.moves[i], this->_side);
+    }
+
+    const int lines = std::clamp(legalMoves, 1, this->_multiPV);
+
+    int currentDepth = 1;
+
+    while (currentDepth <= depth) {
+        std::vector<PrincipalVariation> principalVariations;
+
+        this->_rootExcludedMoves.size = 0;
+
+        int researches = 0;
+
+        uint64_t depthNodes = this->_searchNodes;
+
+        for (int line = 0; line < lines; ++line) {
+            int previousScore = 0;
+
+            // Each line starts from its own PV of the previous depth, so the root orders that line's move first
+            if (line < static_cast<int>(this->_principalVariations.size())) {
+                const std::vector<uint16_t> &moves = this->_principalVariations[line].moves;
+
+                std::copy(moves.begin(), moves.end(), this->_pvTable[0]);
+
+                previousScore = this->_principalVariations[line].score;
             }
 
-            // PERF: Bruce mo's bad move proof
-            if (score > alpha) {
-                score = -this->search(-alpha - 1, -alpha, depth - 1, ply + 1);
+            uint64_t lineNodes = this->_searchNodes;
 
-                // PV node cannot both be between alpha and beta
-                if ((score > alpha) && (score < beta)) {
-                    score = -this->search(-beta, -alpha, depth - 1, ply + 1);
-                }
+            int score = this->searchAspiration(currentDepth, previousScore, researches);
+
+            // The unfinished depth may have overwritten the PV, keep the last completed one
+            if (this->_isStopped) {
+                break;
+            }
+
+            if (line == 0) {
+                this->_searchResult.bestMove = this->_pvTable[0][0];
             }
+
+            principalVariations.push_back({ currentDepth, score, this->_searchNodes - lineNodes, this->getElapsedTime(), std::vector<uint16_t>(this->_pvTable[0], this->_pvTable[0] + this->_pvLength[0]) });
+
+            this->_rootExcludedMoves.add(this->_pvTable[0][0]);
         }
 
-        this->unmakeMove(move);
+        this->_rootExcludedMoves.size = 0;
 
-        --this->_repetitionIndex;
+        if (this->_isStopped) {
+            break;
+        }
 
-        // If we return fail hard beta cutoff first, we lose information about the search,
-        // therefore, check alpha then beta
-        if (score > alpha) {
-            this->storeHistoryMove(move, this->_side, depth);
+        // A later line can come back above an earlier one, its window and ordering differ
+        std::stable_sort(principalVariations.begin(), principalVariations.end(), [](const PrincipalVariation &first, const PrincipalVariation &second) { return first.score > second.score; });
 
-            this->storePVMove(move, ply);
+        this->_principalVariations = std::move(principalVariations);
 
-            transpositionTableNodeType = Transposition::NodeType::EXACT;
+        // A mated or stalemated root has an empty PV
+        const std::vector<uint16_t> &bestLine = this->_principalVariations.front().moves;
 
-            ttMove = move;
+        this->_searchResult.bestMove = bestLine.empty() ? 0U : bestLine.front();
 
-            alpha = score;
+        const PrincipalVariation &principalVariation = this->_principalVariations.front();
 
-            if (score >= beta) {
-                this->storeKillerMove(move, ply);
+        this->_searchIterations.push_back({ currentDepth, principalVariation.score, this->_searchResult.bestMove, this->_searchNodes, this->getElapsedTime(), researches });
 
-                this->recordTranspositionTableEntry(beta, depth, Transposition::NodeType::BETA, ply, ttMove);
+        LOG_INFO("Number of nodes at depth {}: {} with {} re-searches", currentDepth, this->_searchNodes - depthNodes, researches);
 
-                return beta;
+        if (lines > 1) {
+            for (size_t line = 0; line < this->_principalVariations.size(); ++line) {
+                const PrincipalVariation &variation = this->_principalVariations[line];
+
+                LOG_INFO("Line {} at depth {}: score {}, nodes {}, time {} ms, pv {}", line + 1, variation.depth, variation.score, variation.nodes, variation.time, this->getPVString(variation.moves));
             }
         }
+
+        ++currentDepth;
     }
 
-    if (!isLegalMoveFound) {
-        if (this->isInCheck(this->_side)) {
-            return Score::getCheckMateScore(ply);
+    if (this->_searchResult.bestMove == 0U) {
+        // throw std::runtime_error("Engine could not find move...");
+        LOG_ERROR("Engine could not find a move...");
+    }
+}
+
+// Re-searched until the score is inside the window, the first depth and mate scores use the full window
+int Engine::searchAspiration(int depth, int previousScore, int &researches) {
+    int alpha = -Score::INF;
+    int beta = Score::INF;
+
+    // Scores far from zero swing more between depths
+    int delta = this->_tunables.ASPIRATION_WINDOW + std::abs(previousScore) / this->_tunables.ASPIRATION_SCALE;
+
+    if (depth > 1 && std::abs(previousScore) < Score::CHECKMATE_THRESHOLD) {
+        alpha = std::max(previousScore - delta, -Score::INF);
+        beta = std::min(previousScore + delta, Score::INF);
+    }
+
+    while (true) {
+        this->_searchResult.nodes = 0;
+
+        int score = this->search(alpha, beta, depth, 0, false);
+
+        this->_searchNodes += this->_searchResult.nodes;
+
+        if (this->_isStopped) {
+            return score;
         }
 
-        return 0;
+        // Only the failing bound moves, twice as far each time, so a volatile score costs a few narrow searches
+        if (score <= alpha) {
+            LOG_INFO("Re-searching depth {} after failing low for alpha: {} beta: {}", depth, alpha, beta);
+
+            delta *= 2;
+
+            alpha = std::max(alpha - delta, -Score::INF);
+        } else if (score >= beta) {
+            LOG_INFO("Re-searching depth {} after failing high for alpha: {} beta: {}", depth, alpha, beta);
+
+            delta *= 2;
+
+            beta = std::min(beta + delta, Score::INF);
+
+            // The move that failed high stays first in the PV, and is played if time runs out before the re-search ends
+            if (this->_rootExcludedMoves.size == 0) {
+                this->_searchResult.bestMove = this->_pvTable[0][0];
+            }
+        } else {
+            return score;
+        }
+
+        ++researches;
     }
+}
 
-    this->recordTranspositionTableEntry(alpha, depth, transpositionTableNodeType, ply, ttMove);
+// Standard algebraic notation of a line from the current position
+std::string Engine::getPVString(const std::vector<uint16_t> &moves) {
+    std::string pv;
 
-    return alpha;
+    std::vector<uint16_t> played;
+
+    for (uint16_t move : moves) {
+        if (!pv.empty()) {
+            pv += ' ';
+        }
+
+        pv += this->getSan(move);
+
+        this->makeMove(move);
+
+        played.push_back(move);
+    }
+
+    for (auto move = played.rbegin(); move != played.rend(); ++move) {
+        this->unmakeMove(*move);
+    }
+
+    return pv;
 }
 
-// WARN: Don't use TT in quiescence? Cannot prove
-int Engine::quiescence(int alpha, int beta, int ply) {
+void Engine::searchRoot(int depth) {
+    this->ageHistories();
+
+    this->_searchRootIndex = this->_repetitionIndex;
+
+    std::memset(this->_pvLength, 0, sizeof(this->_pvLength));
+    std::memset(this->_pvTable, 0, sizeof(this->_pvTable));
+    std::memset(this->_excludedMoves, 0, sizeof(this->_excludedMoves));
+
+    this->search(-Score::INF, Score::INF, depth, 0, false);
+
+    this->_searchResult.bestMove = this->_pvTable[0][0];
+
+    if (this->_searchResult.bestMove == 0U) {
+        // throw std::runtime_error("Engine could not find move...");
+        LOG_ERROR("Engine could not find a move...");
+    }
+}
+
+// PERF: Includes:
+// Null move pruning [+]
+// Late move reduction [+]
+// Razoring [-]
+// WARN: Always probing the TT
+int Engine::search(int alpha, int beta, int depth, int ply, bool isCutNode) {
     ++this->_searchResult.nodes;
 
-    // Standing pat is illegal if king is in check
-    if (this->isInCheck(this->_side)) {
-        bool isLegalMovesFound = false;
+    // Initialise pv length
+    this->_pvLength[ply] = ply;
 
-        Move::MoveList moves = this->generateMoves(this->_side);
+    if (this->isSearchStopped()) {
+        return 0;
+    }
 
-        this->orderMoves(moves, 0U, this->_side, ply);
+    // Extensions can keep the depth from running out, the ply indexed tables end here
+    if (ply >= MAX_PLY - 1) {
+        return this->evaluate(this->_side);
+    }
 
-        for (int i = 0; i < moves.size; ++i) {
-            uint16_t move = moves.moves[i];
+    // TODO: Return contempt
+    if (ply > 0 && (this->isRepetition() || this->isFiftyMoveDraw())) {
+        return 0;
+    }
 
-            if (!this->isMoveLegal(move, this->_side)) {
-                continue;
-            }
+    // A draw is in reach, so lines scoring below it can be cut early
+    if (ply > 0 && alpha < 0 && this->hasUpcomingRepetition(ply)) {
+        alpha = 0;
 
-            isLegalMovesFound = true;
+        if (alpha >= beta) {
+            return alpha;
+        }
+    }
 
-            this->_repetitionTable[this->_repetitionIndex++] = this->_zobrist;
+    int tablebaseScore = 0;
 
-            this->makeMove(move);
+    if (ply > 0 && this->probeTablebase(ply, tablebaseScore)) {
+        return tablebaseScore;
+    }
 
-            int score = -this->quiescence(-beta, -alpha, ply + 1);
+    if (ply > 0 && this->isDrawnEndgame()) {
+        return 0;
+    }
 
-            this->unmakeMove(move);
+    uint16_t ttMove = 0U;
 
-            --this->_repetitionIndex;
+    // Searching without one move, so neither the stored result nor the one found here describes this node
+    uint16_t excludedMove = this->_excludedMoves[ply];
 
-            if (score > alpha) {
-                alpha = score;
+    // Later multi-PV lines search the root without the earlier lines' moves
+    bool isPartialNode = excludedMove != 0U || (ply == 0 && this->_rootExcludedMoves.size > 0);
 
-                if (score >= beta) {
-                    return beta;
-                }
-            }
-        }
+    int transpositionTableScore = this->probeTranspositionTable(alpha, beta, depth, ply, ttMove);
 
-        if (!isLegalMovesFound) {
-            return Score::getCheckMateScore(ply);
-        }
+    // A cutoff at the root would leave no PV, and with it no move to play
+    if (ply > 0 && excludedMove == 0U && transpositionTableScore != -1) {
+        return transpositionTableScore;
+    }
 
-        return alpha;
+    if (depth <= 0) {
+        return this->quiescence(alpha, beta, ply);
     }
 
-    int standingPat = this->evaluate(this->_side);
-    // int standingPat = this->evaluatePesto(this->_side);
+    bool isPVNode = (beta - alpha > 1);
+
+    bool isParentInCheck = this->isInCheck(this->_side);
+
+    // Search extension for parent in check
+    // if (isParentInCheck) {
+    //     ++depth;
+    // }
+
+    int staticEvaluation = isParentInCheck ? -Score::INF : this->evaluate(this->_side);
+
+    this->_staticEvaluations[ply] = staticEvaluation;
+
+    // Compared with our last position, a position after a check counts as improved on
+    bool isImproving = !isParentInCheck && ply >= 2 && staticEvaluation > this->_staticEvaluations[ply - 2];
+
+    if (excludedMove == 0U && this->isReverseFutility(isPVNode, isParentInCheck, depth, staticEvaluation, beta, isImproving)) {
+        ++this->_searchStatistics.reverseFutility;
 
-    if (standingPat >= beta) {
         return beta;
     }
 
-    if (standingPat > alpha) {
-        alpha = standingPat;
+    // NMP
+    if (excludedMove == 0U && this->isNMP(isPVNode, isParentInCheck, depth, ply)) {
+        this->_searchMoves[ply] = 0U;
+
+        this->makeNullMove();
+
+        int score = -this->search(-beta, -beta + 1, std::max(depth - 1 - this->_tunables.NMP_REDUCTION, 0), ply + 1, !isCutNode);
+
+        this->unmakeNullMove();
+
+        if (score >= beta) {
+            ++this->_searchStatistics.nullMove;
+
+            return beta;
+        }
     }
 
-    MoveList captures = this->generateCaptures(this->_side);
+    // Razoring- check how "bad" we are doing, and if bad enough, all is lost lol
+    if (excludedMove == 0U && this->isRazoring(isPVNode, isParentInCheck, depth)) {
+        int score = staticEvaluation + this->_tunables.RAZOR_MARGIN;
 
-    this->orderMoves(captures, 0U, this->_side, ply);
+        if (score < beta) {
+            score += this->_tunables.RAZOR_SECOND_MARGIN;
 
-    for (int i = 0; i < captures.size; ++i) {
-        uint16_t &capture = captures.moves[i];
+            if (depth == 1) {
+                ++this->_searchStatistics.razoring;
 
-        if (!this->isMoveLegal(capture, this->_side)) {
-            continue;
+                return std::max(score, this->quiescence(alpha, beta, ply));
+            }
+
+            if (score < beta && depth <= 2) {
+                ++this->_searchStatistics.razoring;
+
+                return std::max(score, this->quiescence(alpha, beta, ply));
+            }
         }
+    }
 
-        this->_repetitionTable[this->_repetitionIndex++] = this->_zobrist;
+    // The TT move is extended by a ply when every other move fails low against a margin below its score
+    uint16_t extendedMove = 0U;
 
-        this->makeMove(capture);
+    if (excludedMove == 0U && ttMove != 0U && depth >= this->_tunables.SE_DEPTH) {
+        const Transposition::Entry *entry = this->getTranspositionTableEntry();
 
-        int score = -this->quiescence(-beta, -alpha, ply + 1);
+        if (this->isSingularExtension(entry, ttMove, depth, ply)) {
+            int singularBeta = entry->score - this->_tunables.SE_MARGIN * depth;
 
-        this->unmakeMove(capture);
+            this->_excludedMoves[ply] = ttMove;
 
-        --this->_repetitionIndex;
+            int score = this->search(singularBeta - 1, singularBeta, (depth - 1) / 2, ply, isCutNode);
 
-        if (score > alpha) {
-            alpha = score;
+            this->_excludedMoves[ply] = 0U;
+
+            if (this->_isStopped) {
+                return 0;
+            }
+
+            if (score < singularBeta) {
+                extendedMove = ttMove;
+            } else if (singularBeta >= beta) {
+                // Multi-cut, another move also beats beta so one of them is expected to hold
+                ++this->_searchStatistics.multiCut;
 
-            if (score >= beta) {
                 return beta;
             }
         }
     }
 
-    return alpha;
-}
+    int legalMoves = 0;
 
-// TODO: implement mobility score
-int Engine::evaluate(ColourType side) {
-    int score = 0;
+    // Moves searched before the current one, excluded and pruned moves do not count
+    int searchedMoves = 0;
 
-    const uint64_t whitePawns = this->_bitboards[ColourType::WHITE][PieceType::PAWN];
-    const uint64_t blackPawns = this->_bitboards[ColourType::BLACK][PieceType::PAWN];
+    // Searched moves that did not cut, penalised when a later move does
+    MoveList quiets;
+    MoveList captures;
 
-    const uint64_t bothPawns = whitePawns | blackPawns;
+    bool isFutile = this->isFutility(isPVNode, isParentInCheck, depth, staticEvaluation, alpha);
 
-    for (uint8_t piece = PieceType::PAWN; piece <= PieceType::KING; ++piece) {
-        uint64_t whitePieces = this->_bitboards[ColourType::WHITE][piece];
+    MoveList moves = isParentInCheck ? this->generateEvasions(this->_side) : this->generateMoves(this->_side);
 
-        while (whitePieces) {
-            int square = BitUtility::popLSB(whitePieces);
+    Transposition::NodeType transpositionTableNodeType = Transposition::NodeType::ALPHA;
 
-            int file = FILE_FROM_SQUARE[square];
-            int rank = RANK_FROM_SQUARE[square];
+    this->orderMoves(moves, ttMove, this->_side, ply);
 
-            // Pawn penalties and bonuses
-            if (piece == PieceType::PAWN) {
-                // Check if pawn on file is isolated
-                if ((whitePawns & ISOLATED_FILE_MASKS[file]) == 0ULL) {
-                    score += ISOLATED_PAWN_PENALTY;
-                }
+    for (int i = 0; i < moves.size; ++i) {
+        uint16_t &move = moves.moves[i];
 
-                // Check if black pawns blocking path
-                if ((blackPawns & PASSED_PAWN_MASKS[ColourType::WHITE][square]) == 0ULL) {
-                    score += PASSED_PAWN_BONUS[rank];
-                }
-            }
+        if (move == excludedMove || this->isRootExcluded(move, ply) || !this->isMoveLegal(move, this->_side)) {
+            continue;
+        }
 
-            // Check knight mobility
-            if (piece == PieceType::KNIGHT) {
-                score += BitUtility::popCount(Knight::ATTACKS[square]);
-            }
+        ++legalMoves;
+
+        // The first move is always searched, so a fully pruned node still has a score
+        if (legalMoves > 1 && Move::isHistory(move)) {
+            if (isFutile) {
+                ++this->_searchStatistics.futility;
 
-            // Check bishop mobility
-            if (piece == PieceType::BISHOP) {
-                score += BitUtility::popCount(Bishop::getAttacks(square, this->_occupancyBoth));
+                continue;
             }
 
-            // Check rook semi and full open files
-            if (piece == PieceType::ROOK) {
-                if ((whitePawns & FILE_MASKS[file]) == 0ULL) {
-                    score += SEMI_OPEN_FILE_SCORE;
-                }
+            if (this->isLateMovePrune(isPVNode, isParentInCheck, depth, legalMoves, alpha, isImproving)) {
+                ++this->_searchStatistics.lateMove;
 
-                if ((bothPawns & FILE_MASKS[file]) == 0ULL) {
-                    score += OPEN_FILE_SCORE;
-                }
+                continue;
             }
+        }
 
-            // Check queen mobility
-            if (piece == PieceType::QUEEN) {
-                score += BitUtility::popCount(Queen::getAttacks(square, this->_occupancyBoth));
-            }
+        int childDepth = depth - 1 + (move == extendedMove);
 
-            // We don't want king open files apply penalty
-            if (piece == PieceType::KING) {
-                if ((whitePawns & FILE_MASKS[file]) == 0ULL) {
-                    score -= SEMI_OPEN_FILE_SCORE;
-                }
+        this->_searchMoves[ply] = move;
+        this->_searchPieces[ply] = BoardUtility::getPiece(this->_bitboards, Move::getFrom(move), this->_side);
 
-                if ((bothPawns & FILE_MASKS[file]) == 0ULL) {
-                    score -= OPEN_FILE_SCORE;
-                }
+        this->makeMove(move);
 
-                // Apply king safety factor
-                score += KING_SAFETY_FACTOR * BitUtility::popCount(King::ATTACKS[square] & this->_occupancies[ColourType::WHITE]);
+        int score;
+
+        // The first legal move is never pruned, so it is the first searched and gets the full window
+        if (legalMoves == 1) {
+            score = -this->search(-beta, -alpha, childDepth, ply + 1, !isPVNode && !isCutNode);
+        } else {
+            // PERF: LMR tuning
+            if (searchedMoves >= this->_tunables.FULL_DEPTH && depth >= this->_tunables.REDUCTION_LIMIT && this->isLMR(move, isParentInCheck)) {
+                score = -this->search(-alpha - 1, -alpha, this->getLMRDepth(move, depth, ply, searchedMoves, isPVNode, isCutNode, isImproving), ply + 1, true);
+            } else {
+                score = alpha + 1;
             }
 
-            // LOG_INFO("File: {}, Rank: {}", BoardUtility::getFile(square), BoardUtility::getRank(square));
+            // PERF: Bruce mo's bad move proof
+            if (score > alpha) {
+                score = -this->search(-alpha - 1, -alpha, childDepth, ply + 1, !isCutNode);
 
-            score += POSITION_TABLES[piece][square];
+                // PV node cannot both be between alpha and beta
+                if ((score > alpha) && (score < beta)) {
+                    score = -this->search(-beta, -alpha, childDepth, ply + 1, false);
+                }
+            }
         }
 
-        uint64_t blackPieces = this->_bitboards[ColourType::BLACK][piece];
-
-        while (blackPieces) {
-            int square = BitUtility::popLSB(blackPieces);
+        this->unmakeMove(move);
 
-            const int mirrorSquare = MIRROR[square];
+        // Scores from a stopped search are meaningless, so nothing is stored
+        if (this->_isStopped) {
+            return 0;
+        }
 
-            int file = FILE_FROM_SQUARE[mirrorSquare];
-            int rank = RANK_FROM_SQUARE[mirrorSquare];
+        ++searchedMoves;
 
-            if (piece == PieceType::PAWN) {
-                if ((blackPawns & ISOLATED_FILE_MASKS[file]) == 0ULL) {
-                    score -= ISOLATED_PAWN_PENALTY;
-                }
+        // If we return fail hard beta cutoff first, we lose information about the search,
+        // therefore, check alpha then beta
+        if (score > alpha) {
+            this->storePVMove(move, ply);
 
-                if ((whitePawns & PASSED_PAWN_MASKS[ColourType::BLACK][square]) == 0ULL) {
-                    score -= PASSED_PAWN_BONUS[rank];
-                }
-            }
+            transpositionTableNodeType = Transposition::NodeType::EXACT;
 
-            if (piece == PieceType::KNIGHT) {
-                score -= BitUtility::popCount(Knight::ATTACKS[square]);
-            }
+            ttMove = move;
 
-            if (piece == PieceType::BISHOP) {
-                score -= BitUtility::popCount(Bishop::getAttacks(square, this->_occupancyBoth));
-            }
+            alpha = score;
 
-            if (piece == PieceType::ROOK) {
-                if ((blackPawns & FILE_MASKS[file]) == 0ULL) {
-                    score -= SEMI_OPEN_FILE_SCORE;
-                }
+            if (score >= beta) {
+                this->storeKillerMove(move, ply);
 
-                if ((bothPawns & FILE_MASKS[file]) == 0ULL) {
-                    score -= OPEN_FILE_SCORE;
-                }
-            }
+                this->updateHistories(move, depth, ply, quiets, captures);
 
-            if (piece == PieceType::QUEEN) {
-                score -= BitUtility::popCount(Queen::getAttacks(square, this->_occupancyBoth));
-            }
+                ++this->_searchStatistics.betaCutoffs;
 
-            if (piece == PieceType::KING) {
-                if ((blackPawns & FILE_MASKS[file]) == 0ULL) {
-                    score += SEMI_OPEN_FILE_SCORE;
+                // The first legal move is never pruned, so this is the first move searched
+                if (legalMoves == 1) {
+                    ++this->_searchStatistics.firstMoveCutoffs;
                 }
 
-                if ((bothPawns & FILE_MASKS[file]) == 0ULL) {
-                    score += OPEN_FILE_SCORE;
+                if (!isPartialNode) {
+                    this->recordTranspositionTableEntry(beta, depth, Transposition::NodeType::BETA, ply, ttMove);
                 }
 
-                score -= KING_SAFETY_FACTOR * BitUtility::popCount(King::ATTACKS[square] & this->_occupancies[ColourType::BLACK]);
+                return beta;
             }
-
-            score -= POSITION_TABLES[piece][mirrorSquare];
         }
 
-        int materialDifference = BitUtility::popCount(this->_bitboards[ColourType::WHITE][piece]) - BitUtility::popCount(this->_bitboards[ColourType::BLACK][piece]);
-
-        score += MATERIAL_TABLE[piece] * materialDifference;
+        if (Move::isHistory(move)) {
+            quiets.add(move);
+        } else if (Move::isGeneralCapture(move)) {
+            captures.add(move);
+        }
     }
 
-    // Check how many stacked pawns there are
-    for (int file = 0; file < 8; ++file) {
-        uint64_t stackedPawns = whitePawns & FILE_MASKS[file];
-
-        int numberOfStackedPawns = BitUtility::popCount(stackedPawns);
+    // Only the excluded move was legal, so it is singular
+    if (legalMoves == 0 && excludedMove != 0U) {
+        return alpha;
+    }
 
-        // Penalty is < 0 so should be fine just adding- white stacked pawns
-        if (numberOfStackedPawns > 1) {
-            score += (numberOfStackedPawns - 1) * STACKED_PAWN_PENALTY;
+    if (legalMoves == 0) {
+        if (this->isInCheck(this->_side)) {
+            return Score::getCheckMateScore(ply);
         }
 
-        stackedPawns = blackPawns & FILE_MASKS[file];
-
-        numberOfStackedPawns = BitUtility::popCount(stackedPawns);
+        return 0;
+    }
 
-        // Black stacked pawns
-        if (numberOfStackedPawns > 1) {
-            score -= (numberOfStackedPawns - 1) * STACKED_PAWN_PENALTY;
-        }
+    if (!isPartialNode) {
+        this->recordTranspositionTableEntry(alpha, depth, transpositionTableNodeType, ply, ttMove);
     }
 
-    return (side == ColourType::WHITE) ? score : -score;
+    return alpha;
 }
 
-// s = (so * gps + se * (ops - gps)) / ops
-// NOTE: CMK Pesto implementation
-int Engine::evaluatePesto(ColourType side) {
-    GamePhase gamePhase = GamePhase::MIDDLEGAME;
+// Results are stored at depth zero, so they never cut off a real search
+int Engine::quiescence(int alpha, int beta, int ply) {
+    ++this->_searchResult.nodes;
 
-    int gamePhaseScore = this->getGamePhaseScore();
+    // Captures here are not quiet history context for the plies below
+    this->_searchMoves[ply] = 0U;
 
-    if (gamePhaseScore > OPENING_SCORE) {
-        gamePhase = GamePhase::OPENING;
-    } else if (gamePhaseScore < ENDGAME_SCORE) {
-        gamePhase = GamePhase::ENDGAME;
+    if (this->isSearchStopped()) {
+        return 0;
     }
 
-    const int gamePhaseScoreDifference = OPENING_SCORE - gamePhaseScore;
-
-    const uint64_t whitePawns = this->_bitboards[ColourType::WHITE][PieceType::PAWN];
-    const uint64_t blackPawns = this->_bitboards[ColourType::BLACK][PieceType::PAWN];
+    // Long check sequences would run past the ply indexed tables
+    if (ply >= MAX_PLY - 1) {
+        return this->evaluate(this->_side);
+    }
 
-    const uint64_t bothPawns = whitePawns | blackPawns;
+    uint16_t ttMove = 0U;
 
-    int scoreOpening = 0;
-    int scoreEndgame = 0;
+    int transpositionTableScore = this->probeTranspositionTable(alpha, beta, 0, ply, ttMove);
 
-    for (uint8_t piece = PieceType::PAWN; piece <= PieceType::KING; ++piece) {
-        uint64_t whitePieces = this->_bitboards[ColourType::WHITE][piece];
+    if (transpositionTableScore != -1) {
+        return transpositionTableScore;
+    }
 
-        while (whitePieces) {
-            int square = BitUtility::popLSB(whitePieces);
+    Transposition::NodeType transpositionTableNodeType = Transposition::NodeType::ALPHA;
 
-            scoreOpening += MATERIAL_VALUES[GamePhase::OPENING][piece];
-            scoreEndgame += MATERIAL_VALUES[GamePhase::ENDGAME][piece];
+    // Standing pat is illegal if king is in check
+    if (this->isInCheck(this->_side)) {
+        bool isLegalMovesFound = false;
 
-            scoreOpening += POSITION_VALUES[GamePhase::OPENING][piece][square];
-            scoreEndgame += POSITION_VALUES[GamePhase::ENDGAME][piece][square];
+        Move::MoveList evasions = this->generateEvasions(this->_side);
 
-            int file = FILE_FROM_SQUARE[square];
-            int rank = RANK_FROM_SQUARE[square];
+        this->orderMoves(evasions, ttMove, this->_side, ply);
 
-            // Pawn penalties and bonuses
-            if (piece == PieceType::PAWN) {
-                // Check if pawn on file is isolated
-                if ((whitePawns & ISOLATED_FILE_MASKS[file]) == 0ULL) {
-                    scoreOpening += ISOLATED_PAWN_PENALTY_PESTO[GamePhase::OPENING];
-                    scoreEndgame += ISOLATED_PAWN_PENALTY_PESTO[GamePhase::ENDGAME];
-                }
+        for (int i = 0; i < evasions.size; ++i) {
+            uint16_t &evasion = evasions.moves[i];
 
-                // Check if black pawns blocking path
-                if ((blackPawns & PASSED_PAWN_MASKS[ColourType::WHITE][square]) == 0ULL) {
-                    scoreOpening += PASSED_PAWN_BONUS_PESTO[rank];
-                    scoreEndgame += PASSED_PAWN_BONUS_PESTO[rank];
-                }
+            if (!this->isMoveLegal(evasion, this->_side)) {
+                continue;
+            }
 
-                // Check stacked pawns
-                const uint64_t stackedPawns = whitePawns & FILE_MASKS[file];
+            isLegalMovesFound = true;
 
-                int numberOfStackedPawns = BitUtility::popCount(stackedPawns);
+            this->makeMove(evasion, true);
 
-                // Penalty is < 0 so should be fine just adding- white stacked pawns
-                if (numberOfStackedPawns > 1) {
-                    scoreOpening += (numberOfStackedPawns - 1) * STACKED_PAWN_PENALTY_PESTO[GamePhase::OPENING];
-                    scoreEndgame += (numberOfStackedPawns - 1) * STACKED_PAWN_PENALTY_PESTO[GamePhase::ENDGAME];
-                }
-            }
+            int score = -this->quiescence(-beta, -alpha, ply + 1);
 
-            // Check bishop mobility
-            if (piece == PieceType::BISHOP) {
-                int bishopAttackValue = BitUtility::popCount(Bishop::getAttacks(square, this->_occupancyBoth)) - BISHOP_OFFSET_VALUE;
+            this->unmakeMove(evasion);
 
-                scoreOpening += bishopAttackValue * BISHOP_MOBILITY_WEIGHT[GamePhase::OPENING];
-                scoreEndgame += bishopAttackValue * BISHOP_MOBILITY_WEIGHT[GamePhase::ENDGAME];
+            if (this->_isStopped) {
+                return 0;
             }
 
-            // Check rook semi and full open files
-            if (piece == PieceType::ROOK) {
-                if ((whitePawns & FILE_MASKS[file]) == 0ULL) {
-                    scoreOpening += SEMI_OPEN_FILE_SCORE_PESTO;
-                    scoreEndgame += SEMI_OPEN_FILE_SCORE_PESTO;
-                }
+            if (score > alpha) {
+                transpositionTableNodeType = Transposition::NodeType::EXACT;
 
-                if ((bothPawns & FILE_MASKS[file]) == 0ULL) {
-                    scoreOpening += OPEN_FILE_SCORE_PESTO;
-                    scoreEndgame += OPEN_FILE_SCORE_PESTO;
-                }
-            }
+                ttMove = evasion;
 
-            // Check queen mobility
-            if (piece == PieceType::QUEEN) {
-                int queenAttackValue = BitUtility::popCount(Queen::getAttacks(square, this->_occupancyBoth)) - QUEEN_OFFSET_VALUE;
+                alpha = score;
 
-                scoreOpening += queenAttackValue * QUEEN_MOBILITY_WEIGHT[GamePhase::OPENING];
-                scoreEndgame += queenAttackValue * QUEEN_MOBILITY_WEIGHT[GamePhase::ENDGAME];
-            }
+                if (score >= beta) {
+                    this->recordTranspositionTableEntry(beta, 0, Transposition::NodeType::BETA, ply, ttMove);
 
-            // We don't want king open files apply penalty
-            if (piece == PieceType::KING) {
-                if ((whitePawns & FILE_MASKS[file]) == 0ULL) {
-                    scoreOpening -= SEMI_OPEN_FILE_SCORE_PESTO;
-                    scoreEndgame -= SEMI_OPEN_FILE_SCORE_PESTO;
+                    return beta;
                 }
+            }
+        }
 
-                if ((bothPawns & FILE_MASKS[file]) == 0ULL) {
-                    scoreOpening -= OPEN_FILE_SCORE_PESTO;
-                    scoreEndgame -= OPEN_FILE_SCORE_PESTO;
-                }
+        if (!isLegalMovesFound) {
+            return Score::getCheckMateScore(ply);
+        }
 
-                // Apply king safety factor
-                int kingAttacks = BitUtility::popCount(King::ATTACKS[square] & this->_occupancies[ColourType::WHITE]);
+        this->recordTranspositionTableEntry(alpha, 0, transpositionTableNodeType, ply, ttMove);
 
-                int kingSafetyBonus = KING_SAFETY_WEIGHT_PESTO * kingAttacks;
+        return alpha;
+    }
 
-                scoreOpening += kingSafetyBonus;
-                scoreEndgame += kingSafetyBonus;
-            }
-        }
+    int standingPat = this->evaluate(this->_side);
 
-        uint64_t blackPieces = this->_bitboards[ColourType::BLACK][piece];
+    if (standingPat >= beta) {
+        return beta;
+    }
 
-        while (blackPieces) {
-            int square = BitUtility::popLSB(blackPieces);
+    if (standingPat > alpha) {
+        transpositionTableNodeType = Transposition::NodeType::EXACT;
 
-            const int mirrorSquare = MIRROR[square];
+        alpha = standingPat;
+    }
 
-            scoreOpening -= MATERIAL_VALUES[GamePhase::OPENING][piece];
-            scoreEndgame -= MATERIAL_VALUES[GamePhase::ENDGAME][piece];
+    MoveList captures = this->generateCaptures(this->_side);
 
-            scoreOpening -= POSITION_VALUES[GamePhase::OPENING][piece][mirrorSquare];
-            scoreEndgame -= POSITION_VALUES[GamePhase::ENDGAME][piece][mirrorSquare];
+    this->orderMoves(captures, ttMove, this->_side, ply);
 
-            int file = FILE_FROM_SQUARE[mirrorSquare];
-            int rank = RANK_FROM_SQUARE[mirrorSquare];
+    ColourType otherSide = BoardUtility::getOtherSide(this->_side);
 
-            if (piece == PieceType::PAWN) {
-                if ((blackPawns & ISOLATED_FILE_MASKS[file]) == 0ULL) {
-                    scoreOpening -= ISOLATED_PAWN_PENALTY_PESTO[GamePhase::OPENING];
-                    scoreEndgame -= ISOLATED_PAWN_PENALTY_PESTO[GamePhase::ENDGAME];
-                }
+    for (int i = 0; i < captures.size; ++i) {
+        uint16_t &capture = captures.moves[i];
 
-                if ((whitePawns & PASSED_PAWN_MASKS[ColourType::BLACK][square]) == 0ULL) {
-                    scoreOpening -= PASSED_PAWN_BONUS_PESTO[rank];
-                    scoreEndgame -= PASSED_PAWN_BONUS_PESTO[rank];
-                }
+        int from = Move::getFrom(capture);
+        int to = Move::getTo(capture);
 
-                const uint64_t stackedPawns = blackPawns & FILE_MASKS[file];
+        PieceType toPiece = Move::isCapture(capture) || Move::isPromotionCapture(capture) ? BoardUtility::getPiece(this->_bitboards, to, otherSide) : PieceType::PAWN;
 
-                int numberOfStackedPawns = BitUtility::popCount(stackedPawns);
+        // Even winning the piece for free leaves the score below alpha, promotions add too much to tell
+        if (!Move::isGeneralPromotion(capture) && standingPat + MATERIAL_TABLE[toPiece] + this->_tunables.DELTA_MARGIN <= alpha) {
+            ++this->_searchStatistics.delta;
 
-                if (numberOfStackedPawns > 1) {
-                    scoreOpening -= (numberOfStackedPawns - 1) * STACKED_PAWN_PENALTY_PESTO[GamePhase::OPENING];
-                    scoreEndgame -= (numberOfStackedPawns - 1) * STACKED_PAWN_PENALTY_PESTO[GamePhase::ENDGAME];
-                }
-            }
+            continue;
+        }
 
-            if (piece == PieceType::BISHOP) {
-                int bishopAttackValue = BitUtility::popCount(Bishop::getAttacks(square, this->_occupancyBoth)) - BISHOP_OFFSET_VALUE;
+        // Taking a piece worth at least the capturer cannot lose material, the exchange is only played out otherwise
+        if (MATERIAL_TABLE[toPiece] < MATERIAL_TABLE[BoardUtility::getPiece(this->_bitboards, from, this->_side)] && this->seeMove(from, to, toPiece, this->_side) < 0) {
+            ++this->_searchStatistics.see;
 
-                scoreOpening -= bishopAttackValue * BISHOP_MOBILITY_WEIGHT[GamePhase::OPENING];
-                scoreEndgame -= bishopAttackValue * BISHOP_MOBILITY_WEIGHT[GamePhase::ENDGAME];
-            }
+            continue;
+        }
 
-            if (piece == PieceType::ROOK) {
-                if ((blackPawns & FILE_MASKS[file]) == 0ULL) {
-                    scoreOpening -= SEMI_OPEN_FILE_SCORE_PESTO;
-                    scoreEndgame -= SEMI_OPEN_FILE_SCORE_PESTO;
-                }
+        if (!this->isMoveLegal(capture, this->_side)) {
+            continue;
+        }
 
-                if ((bothPawns & FILE_MASKS[file]) == 0ULL) {
-                    scoreOpening -= OPEN_FILE_SCORE_PESTO;
-                    scoreEndgame -= OPEN_FILE_SCORE_PESTO;
-                }
-            }
+        this->makeMove(capture, true);
 
-            if (piece == PieceType::QUEEN) {
-                int queenAttackValue = BitUtility::popCount(Queen::getAttacks(square, this->_occupancyBoth)) - QUEEN_OFFSET_VALUE;
+        int score = -this->quiescence(-beta, -alpha, ply + 1);
 
-                scoreOpening -= queenAttackValue * QUEEN_MOBILITY_WEIGHT[GamePhase::OPENING];
-                scoreEndgame -= queenAttackValue * QUEEN_MOBILITY_WEIGHT[GamePhase::ENDGAME];
-            }
+        this->unmakeMove(capture);
 
-            if (piece == PieceType::KING) {
-                if ((blackPawns & FILE_MASKS[file]) == 0ULL) {
-                    scoreOpening += SEMI_OPEN_FILE_SCORE_PESTO;
-                    scoreEndgame += SEMI_OPEN_FILE_SCORE_PESTO;
-                }
+        if (this->_isStopped) {
+            return 0;
+        }
 
-                if ((bothPawns & FILE_MASKS[file]) == 0ULL) {
-                    scoreOpening += OPEN_FILE_SCORE_PESTO;
-                    scoreEndgame += OPEN_FILE_SCORE_PESTO;
-                }
+        if (score > alpha) {
+            transpositionTableNodeType = Transposition::NodeType::EXACT;
+
+            ttMove = capture;
 
-                // Apply king safety factor
-                int kingAttacks = BitUtility::popCount(King::ATTACKS[square] & this->_occupancies[ColourType::BLACK]);
+            alpha = score;
 
-                int kingSafetyBonus = KING_SAFETY_WEIGHT_PESTO * kingAttacks;
+            if (score >= beta) {
+                this->recordTranspositionTableEntry(beta, 0, Transposition::NodeType::BETA, ply, ttMove);
 
-                scoreOpening -= kingSafetyBonus;
-                scoreEndgame -= kingSafetyBonus;
+                return beta;
             }
         }
     }
 
-    int score = 0;
-
-    switch (gamePhase) {
-    case GamePhase::OPENING:
-        score = scoreOpening;
-        break;
-    case GamePhase::ENDGAME:
-        score = scoreEndgame;
-        break;
-    case GamePhase::MIDDLEGAME:
-        score = (scoreOpening * gamePhaseScore + scoreEndgame * gamePhaseScoreDifference) / OPENING_SCORE;
-        break;
-    }
+    this->recordTranspositionTableEntry(alpha, 0, transpositionTableNodeType, ply, ttMove);
 
-    return (side == ColourType::WHITE) ? score : -score;
+    return alpha;
 }
 
-// gps = cnt(wPiece) * material(piece) + cnt(bPiece) * material(piece)
-// gps = material(piece) * (cnt(wPiece) + cnt(bPiece))
-int Engine::getGamePhaseScore() {
+int Engine::evaluate(ColourType side) {
     int score = 0;
 
-    for (uint8_t piece = PieceType::KNIGHT; piece <= PieceType::QUEEN; ++piece) {
-        int numberOfPieces = BitUtility::popCount(this->_bitboards[ColourType::WHITE][piece]) + BitUtility::popCount(this->_bitboards[ColourType::BLACK][piece]);
-
-        score += MATERIAL_VALUES[GamePhase::OPENING][piece] * numberOfPieces;
+    // Specialised evaluators know these endgames better than the general terms below
+    if (BitUtility::popCount(this->_occupancyBoth) <= endgame::MAX_PIECES && endgame::evaluate(this->_bitboards, side, score)) {
+        return score;
     }
 
-    return score;
+    const int taperedScore = taper(this->_pieceSquareScore + getTermScore(this->_bitboards, this->_occupancies, this->_occupancyBoth), this->_phase);
+
+    return (side == ColourType::WHITE) ? taperedScore : -taperedScore;
 }
 
 uint64_t Engine::perft(int depth) {
@@ -2061,7 +2909,7 @@ uint64_t Engine::perft(int depth) {
             continue;
         }
 
-        this->makeMove(move);
+        this->makeMove(move, false);
 
         nodes += this->perft(depth - 1);
 
@@ -2079,11 +2927,14 @@ void Engine::reset() {
     std::memset(this->_repetitionTable, 0ULL, sizeof(this->_repetitionTable));
 
     this->_occupancyBoth = 0ULL;
+    this->_phase = 0;
+    this->_pieceSquareScore = 0;
     this->_castleRights = this->_INITIAL_CASTLE_RIGHTS;
     this->_side = this->_INITIAL_SIDE;
     this->_enPassantSquare = -1;
 
     this->_repetitionIndex = 0;
+    this->_searchRootIndex = 0;
 
     this->_undoStack.clear();
 }
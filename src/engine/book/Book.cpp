@@ -0,0 +1,123 @@
+#include "engine/book/Book.hpp"
+
+#include "logger/LoggerMacros.hpp"
+
+namespace engine::book {
+
+Book::Book() : _entries(nullptr), _size(0) {
+}
+
+// Map the whole book read-only, pages are only touched by the binary search
+bool Book::open(const std::string &path) {
+    this->close();
+
+    if (!this->_file.open(path, utility::MappedAccess::RANDOM)) {
+        LOG_WARN("Could not map opening book: {}", path);
+
+        return false;
+    }
+
+    if (this->_file.size() < sizeof(Entry)) {
+        LOG_WARN("Opening book is empty: {}", path);
+
+        this->_file.close();
+
+        return false;
+    }
+
+    this->_entries = static_cast<const Entry *>(this->_file.data());
+    this->_size = this->_file.size() / sizeof(Entry);
+
+    LOG_INFO("Loaded opening book {} with {} entries", path, this->_size);
+
+    return true;
+}
+
+void Book::close() {
+    this->_file.close();
+
+    this->_entries = nullptr;
+    this->_size = 0;
+}
+
+bool Book::isOpen() const {
+    return this->_entries != nullptr;
+}
+
+size_t Book::size() const {
+    return this->_size;
+}
+
+// Pick one of the book moves for this key, proportional to its weight
+uint16_t Book::getMove(uint64_t key, std::mt19937 &generator) const {
+    if (!this->isOpen()) {
+        return 0U;
+    }
+
+    size_t first = this->getFirstIndex(key);
+
+    uint32_t totalWeight = 0U;
+
+    size_t last = first;
+
+    while (last < this->_size && this->getKey(last) == key) {
+        totalWeight += this->getWeight(last);
+
+        ++last;
+    }
+
+    if (first == last) {
+        return 0U;
+    }
+
+    // All zero weights, still playable, so fall back to uniform
+    if (totalWeight == 0U) {
+        std::uniform_int_distribution<size_t> distribution(first, last - 1);
+
+        return __builtin_bswap16(this->_entries[distribution(generator)].move);
+    }
+
+    std::uniform_int_distribution<uint32_t> distribution(0U, totalWeight - 1);
+
+    uint32_t pick = distribution(generator);
+
+    for (size_t index = first; index < last; ++index) {
+        uint32_t weight = this->getWeight(index);
+
+        if (pick < weight) {
+            return __builtin_bswap16(this->_entries[index].move);
+        }
+
+        pick -= weight;
+    }
+
+    return __builtin_bswap16(this->_entries[last - 1].move);
+}
+
+// Lower bound on the sorted keys
+size_t Book::getFirstIndex(uint64_t key) const {
+    size_t low = 0;
+    size_t high = this->_size;
+
+    while (low < high) {
+        size_t middle = low + ((high - low) >> 1);
+
+        if (this->getKey(middle) < key) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+
+    return low;
+}
+
+uint64_t Book::getKey(size_t index) const {
+    return __builtin_bswap64(this->_entries[index].key);
+}
+
+uint16_t Book::getWeight(size_t index) const {
+    return __builtin_bswap16(this->_entries[index].weight);
+}
+
+} // namespace engine::book
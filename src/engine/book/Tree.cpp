@@ -0,0 +1,105 @@
+#include <algorithm>
+
+#include "engine/book/Tree.hpp"
+
+#include "logger/LoggerMacros.hpp"
+
+namespace engine::book {
+
+Tree::Tree() : _entries(nullptr), _size(0) {
+}
+
+bool Tree::open(const std::string &path) {
+    this->close();
+
+    if (!this->_file.open(path, utility::MappedAccess::RANDOM)) {
+        LOG_WARN("Could not map opening tree: {}", path);
+
+        return false;
+    }
+
+    if (this->_file.size() < sizeof(TreeEntry)) {
+        LOG_WARN("Opening tree is empty: {}", path);
+
+        this->_file.close();
+
+        return false;
+    }
+
+    // The whole entries before a cut off write are still sorted, so they stay usable
+    if (this->_file.size() % sizeof(TreeEntry) != 0) {
+        LOG_WARN("Opening tree {} has a truncated last entry", path);
+    }
+
+    this->_entries = static_cast<const TreeEntry *>(this->_file.data());
+    this->_size = this->_file.size() / sizeof(TreeEntry);
+
+    LOG_INFO("Loaded opening tree {} with {} entries", path, this->_size);
+
+    return true;
+}
+
+void Tree::close() {
+    this->_file.close();
+
+    this->_entries = nullptr;
+    this->_size = 0;
+}
+
+bool Tree::isOpen() const {
+    return this->_entries != nullptr;
+}
+
+size_t Tree::size() const {
+    return this->_size;
+}
+
+std::vector<TreeEntry> Tree::getEntries(uint64_t key) const {
+    std::vector<TreeEntry> entries;
+
+    if (!this->isOpen()) {
+        return entries;
+    }
+
+    for (size_t index = this->getFirstIndex(key); index < this->_size && this->_entries[index].key == key; ++index) {
+        entries.push_back(this->_entries[index]);
+    }
+
+    std::stable_sort(entries.begin(), entries.end(), [](const TreeEntry &entry, const TreeEntry &otherEntry) { return getTreeGames(entry) > getTreeGames(otherEntry); });
+
+    return entries;
+}
+
+// Lower bound on the sorted keys. Zobrist keys are uniform, so interpolating lands within a page of the answer in a step or two where bisection would fault in a page per step
+size_t Tree::getFirstIndex(uint64_t key) const {
+    size_t low = 0;
+    size_t high = this->_size;
+
+    // Bounds on the keys in [low, high), the key itself always lies between them
+    uint64_t lowKey = 0ULL;
+    uint64_t highKey = UINT64_MAX;
+
+    for (int step = 0; low < high; ++step) {
+        size_t middle = low + ((high - low) >> 1);
+
+        if (step < this->_INTERPOLATION_STEPS) {
+            unsigned __int128 offset = static_cast<unsigned __int128>(key - lowKey) * (high - low) / (static_cast<unsigned __int128>(highKey - lowKey) + 1);
+
+            middle = low + static_cast<size_t>(offset);
+        }
+
+        uint64_t middleKey = this->_entries[middle].key;
+
+        if (middleKey < key) {
+            low = middle + 1;
+            lowKey = middleKey;
+        } else {
+            high = middle;
+            highKey = middleKey;
+        }
+    }
+
+    return low;
+}
+
+} // namespace engine::book
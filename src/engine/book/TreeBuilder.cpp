@@ -0,0 +1,290 @@
+#include <queue>
+#include <utility>
+#include <algorithm>
+#include <filesystem>
+
+#include <fmt/format.h>
+
+#include "engine/book/TreeBuilder.hpp"
+
+#include "logger/LoggerMacros.hpp"
+
+namespace engine::book {
+
+TreeBuilder::TreeBuilder(const std::string &path, size_t memoryBytes) : _path(path), _capacity(std::max<size_t>(memoryBytes / sizeof(TreeEntry), 1)), _nextRun(0), _size(0ULL), _isFailed(false) {
+    this->_buffer.reserve(this->_capacity);
+}
+
+TreeBuilder::~TreeBuilder() {
+    this->removeRuns();
+}
+
+bool TreeBuilder::add(const TreeEntry *entries, size_t count) {
+    for (size_t i = 0; i < count && !this->_isFailed; ++i) {
+        if (this->_buffer.size() == this->_capacity && !this->flush()) {
+            this->_isFailed = true;
+
+            break;
+        }
+
+        this->_buffer.push_back(entries[i]);
+    }
+
+    return !this->_isFailed;
+}
+
+bool TreeBuilder::finish() {
+    if (this->_isFailed) {
+        return false;
+    }
+
+    TreeBuilder::aggregate(this->_buffer);
+
+    if (!this->_runPaths.empty()) {
+        if (!this->writeRun()) {
+            return false;
+        }
+
+        // The merge gets the whole budget for its read blocks
+        std::vector<TreeEntry>().swap(this->_buffer);
+
+        return this->merge();
+    }
+
+    std::ofstream file(this->_path, std::ios::binary | std::ios::trunc);
+
+    if (!file.is_open()) {
+        LOG_ERROR("Could not write opening tree: {}", this->_path);
+
+        return false;
+    }
+
+    file.write(reinterpret_cast<const char *>(this->_buffer.data()), static_cast<std::streamsize>(this->_buffer.size() * sizeof(TreeEntry)));
+
+    this->_size = this->_buffer.size();
+
+    this->_buffer.clear();
+
+    return static_cast<bool>(file);
+}
+
+uint64_t TreeBuilder::size() const {
+    return this->_size;
+}
+
+size_t TreeBuilder::runs() const {
+    return this->_runPaths.size();
+}
+
+// Early plies repeat across games, so aggregating often frees most of the buffer and saves a run
+bool TreeBuilder::flush() {
+    TreeBuilder::aggregate(this->_buffer);
+
+    if (this->_buffer.size() <= this->_capacity / 2) {
+        return true;
+    }
+
+    return this->writeRun();
+}
+
+bool TreeBuilder::writeRun() {
+    std::string path = this->getRunPath();
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+
+    if (!file.is_open()) {
+        LOG_ERROR("Could not write opening tree run: {}", path);
+
+        return false;
+    }
+
+    this->_runPaths.push_back(path);
+
+    file.write(reinterpret_cast<const char *>(this->_buffer.data()), static_cast<std::streamsize>(this->_buffer.size() * sizeof(TreeEntry)));
+
+    this->_buffer.clear();
+
+    return static_cast<bool>(file);
+}
+
+// The oldest runs are merged into a new run until few enough are left to merge into the index at once
+bool TreeBuilder::merge() {
+    while (this->_runPaths.size() > this->_MAX_FAN_IN) {
+        std::vector<std::string> paths(this->_runPaths.begin(), this->_runPaths.begin() + this->_MAX_FAN_IN);
+
+        std::string path = this->getRunPath();
+
+        // Listed first, so a failed pass still removes it
+        this->_runPaths.push_back(path);
+
+        uint64_t size = 0ULL;
+
+        if (!this->mergeRuns(paths, path, size)) {
+            return false;
+        }
+
+        std::error_code error;
+
+        for (const std::string &mergedPath : paths) {
+            std::filesystem::remove(mergedPath, error);
+        }
+
+        this->_runPaths.erase(this->_runPaths.begin(), this->_runPaths.begin() + this->_MAX_FAN_IN);
+    }
+
+    if (!this->mergeRuns(this->_runPaths, this->_path, this->_size)) {
+        return false;
+    }
+
+    this->removeRuns();
+
+    return true;
+}
+
+// k-way merge of sorted runs, equal (key, move) pairs from different runs are summed on the way out
+bool TreeBuilder::mergeRuns(const std::vector<std::string> &paths, const std::string &outputPath, uint64_t &size) {
+    std::vector<TreeRun> runs(paths.size());
+
+    const size_t blockEntries = std::max(this->_capacity / (runs.size() + 1), this->_MIN_BLOCK_ENTRIES);
+
+    using HeapEntry = std::pair<TreeEntry, size_t>;
+
+    auto isAfter = [](const HeapEntry &entry, const HeapEntry &otherEntry) { return isTreeEntryBefore(otherEntry.first, entry.first); };
+
+    std::priority_queue<HeapEntry, std::vector<HeapEntry>, decltype(isAfter)> heap(isAfter);
+
+    for (size_t i = 0; i < runs.size(); ++i) {
+        runs[i].file.open(paths[i], std::ios::binary);
+        runs[i].blockEntries = blockEntries;
+        runs[i].index = 0;
+
+        if (!runs[i].file.is_open()) {
+            LOG_ERROR("Could not read opening tree run: {}", paths[i]);
+
+            return false;
+        }
+
+        TreeEntry entry;
+
+        if (TreeBuilder::readRun(runs[i], entry)) {
+            heap.emplace(entry, i);
+        }
+    }
+
+    std::ofstream file(outputPath, std::ios::binary | std::ios::trunc);
+
+    if (!file.is_open()) {
+        LOG_ERROR("Could not write opening tree: {}", outputPath);
+
+        return false;
+    }
+
+    std::vector<TreeEntry> output;
+
+    output.reserve(blockEntries);
+
+    size = 0ULL;
+
+    while (!heap.empty()) {
+        auto [entry, run] = heap.top();
+
+        heap.pop();
+
+        TreeEntry next;
+
+        if (TreeBuilder::readRun(runs[run], next)) {
+            heap.emplace(next, run);
+        }
+
+        if (!output.empty() && output.back().key == entry.key && output.back().move == entry.move) {
+            TreeBuilder::addCounts(output.back(), entry);
+
+            continue;
+        }
+
+        // The last entry may still grow, so only those before it are written
+        if (output.size() == output.capacity()) {
+            file.write(reinterpret_cast<const char *>(output.data()), static_cast<std::streamsize>((output.size() - 1) * sizeof(TreeEntry)));
+
+            size += output.size() - 1;
+
+            output.erase(output.begin(), output.end() - 1);
+        }
+
+        output.push_back(entry);
+    }
+
+    file.write(reinterpret_cast<const char *>(output.data()), static_cast<std::streamsize>(output.size() * sizeof(TreeEntry)));
+
+    size += output.size();
+
+    // A read error ends a run early like its end of file would
+    for (size_t i = 0; i < runs.size(); ++i) {
+        if (runs[i].file.bad()) {
+            LOG_ERROR("Could not read opening tree run: {}", paths[i]);
+
+            return false;
+        }
+    }
+
+    return static_cast<bool>(file);
+}
+
+std::string TreeBuilder::getRunPath() {
+    return fmt::format("{}.run{}", this->_path, this->_nextRun++);
+}
+
+void TreeBuilder::removeRuns() {
+    std::error_code error;
+
+    for (const std::string &path : this->_runPaths) {
+        std::filesystem::remove(path, error);
+    }
+
+    this->_runPaths.clear();
+}
+
+void TreeBuilder::aggregate(std::vector<TreeEntry> &entries) {
+    std::sort(entries.begin(), entries.end(), isTreeEntryBefore);
+
+    size_t size = 0;
+
+    for (size_t i = 0; i < entries.size(); ++i) {
+        if (size > 0 && entries[size - 1].key == entries[i].key && entries[size - 1].move == entries[i].move) {
+            TreeBuilder::addCounts(entries[size - 1], entries[i]);
+        } else {
+            entries[size++] = entries[i];
+        }
+    }
+
+    entries.resize(size);
+}
+
+// Saturating, the most played opening moves of a large database can pass 32 bits
+void TreeBuilder::addCounts(TreeEntry &entry, const TreeEntry &otherEntry) {
+    entry.whiteWins = static_cast<uint32_t>(std::min<uint64_t>(static_cast<uint64_t>(entry.whiteWins) + otherEntry.whiteWins, UINT32_MAX));
+    entry.draws = static_cast<uint32_t>(std::min<uint64_t>(static_cast<uint64_t>(entry.draws) + otherEntry.draws, UINT32_MAX));
+    entry.blackWins = static_cast<uint32_t>(std::min<uint64_t>(static_cast<uint64_t>(entry.blackWins) + otherEntry.blackWins, UINT32_MAX));
+}
+
+bool TreeBuilder::readRun(TreeRun &run, TreeEntry &entry) {
+    if (run.index >= run.buffer.size()) {
+        run.buffer.resize(run.blockEntries);
+
+        run.file.read(reinterpret_cast<char *>(run.buffer.data()), static_cast<std::streamsize>(run.buffer.size() * sizeof(TreeEntry)));
+
+        run.buffer.resize(static_cast<size_t>(run.file.gcount()) / sizeof(TreeEntry));
+
+        run.index = 0;
+
+        if (run.buffer.empty()) {
+            return false;
+        }
+    }
+
+    entry = run.buffer[run.index++];
+
+    return true;
+}
+
+} // namespace engine::book
@@ -0,0 +1,187 @@
+#include <numeric>
+#include <algorithm>
+
+#include "engine/data/Dataset.hpp"
+
+#include "logger/LoggerMacros.hpp"
+
+namespace engine::data {
+
+Dataset::Dataset(const DatasetSettings &settings) : _settings(settings), _records(nullptr), _size(0), _generator(settings.seed), _nextChunk(0), _isStopped(false) {
+    this->_settings.chunkSize = std::max<size_t>(this->_settings.chunkSize, 1);
+}
+
+Dataset::~Dataset() {
+    this->close();
+}
+
+bool Dataset::open(const std::string &path) {
+    this->close();
+
+    // Chunks are contiguous, read-ahead helps even when their order is shuffled
+    if (!this->_file.open(path, this->_settings.isShuffled ? utility::MappedAccess::NORMAL : utility::MappedAccess::SEQUENTIAL)) {
+        LOG_ERROR("Could not map record file: {}", path);
+
+        return false;
+    }
+
+    if (this->_file.size() < sizeof(Record)) {
+        LOG_ERROR("Record file is empty: {}", path);
+
+        this->_file.close();
+
+        return false;
+    }
+
+    if (this->_file.size() % sizeof(Record) != 0) {
+        LOG_WARN("Record file {} has a truncated last record", path);
+    }
+
+    this->_records = static_cast<const Record *>(this->_file.data());
+    this->_size = this->_file.size() / sizeof(Record);
+
+    this->rewind();
+
+    return true;
+}
+
+void Dataset::close() {
+    this->stopPrefetch();
+
+    this->_file.close();
+
+    this->_records = nullptr;
+    this->_size = 0;
+
+    this->_order.clear();
+}
+
+bool Dataset::isOpen() const {
+    return this->_records != nullptr;
+}
+
+bool Dataset::next(std::vector<Record> &chunk) {
+    if (this->_records == nullptr) {
+        return false;
+    }
+
+    if (this->_settings.prefetchChunks == 0) {
+        if (this->_nextChunk >= this->_order.size()) {
+            return false;
+        }
+
+        this->load(this->_order[this->_nextChunk++], chunk, this->_generator);
+
+        return true;
+    }
+
+    std::unique_lock<std::mutex> lock(this->_mutex);
+
+    this->_chunkReady.wait(lock, [this]() { return !this->_ready.empty() || this->_nextChunk >= this->_order.size(); });
+
+    if (this->_ready.empty()) {
+        return false;
+    }
+
+    chunk = std::move(this->_ready.front());
+
+    this->_ready.pop_front();
+
+    this->_chunkTaken.notify_one();
+
+    return true;
+}
+
+void Dataset::rewind() {
+    this->stopPrefetch();
+
+    if (this->_records == nullptr) {
+        return;
+    }
+
+    this->_order.resize((this->_size + this->_settings.chunkSize - 1) / this->_settings.chunkSize);
+
+    std::iota(this->_order.begin(), this->_order.end(), 0);
+
+    if (this->_settings.isShuffled) {
+        std::shuffle(this->_order.begin(), this->_order.end(), this->_generator);
+    }
+
+    this->_nextChunk = 0;
+
+    if (this->_settings.prefetchChunks > 0) {
+        this->_isStopped = false;
+
+        this->_prefetcher = std::thread(&Dataset::prefetch, this, this->_generator());
+    }
+}
+
+// Total records in the file
+size_t Dataset::size() const {
+    return this->_size;
+}
+
+// Per pass
+size_t Dataset::chunks() const {
+    return this->_order.size();
+}
+
+// Loads outside the lock so the consumer only ever waits when it is ahead of the disk
+void Dataset::prefetch(uint64_t seed) {
+    std::mt19937_64 generator(seed);
+
+    std::unique_lock<std::mutex> lock(this->_mutex);
+
+    while (!this->_isStopped && this->_nextChunk < this->_order.size()) {
+        this->_chunkTaken.wait(lock, [this]() { return this->_ready.size() < this->_settings.prefetchChunks || this->_isStopped; });
+
+        if (this->_isStopped) {
+            break;
+        }
+
+        size_t chunk = this->_order[this->_nextChunk];
+
+        lock.unlock();
+
+        std::vector<Record> records;
+
+        this->load(chunk, records, generator);
+
+        lock.lock();
+
+        this->_ready.push_back(std::move(records));
+
+        ++this->_nextChunk;
+
+        this->_chunkReady.notify_one();
+    }
+}
+
+void Dataset::stopPrefetch() {
+    {
+        std::lock_guard<std::mutex> lock(this->_mutex);
+
+        this->_isStopped = true;
+
+        this->_chunkTaken.notify_all();
+    }
+
+    if (this->_prefetcher.joinable()) {
+        this->_prefetcher.join();
+    }
+
+    this->_ready.clear();
+}
+
+void Dataset::load(size_t chunk, std::vector<Record> &records, std::mt19937_64 &generator) const {
+    size_t first = chunk * this->_settings.chunkSize;
+    size_t last = std::min(first + this->_settings.chunkSize, this->_size);
+
+    records.assign(this->_records + first, this->_records + last);
+
+    if (this->_settings.isShuffled) {
+        std::shuffle(records.begin(), records.end(), generator);
+    }
+}
+
+} // namespace engine::data
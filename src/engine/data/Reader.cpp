@@ -0,0 +1,95 @@
+#include "engine/data/Reader.hpp"
+
+#include "logger/LoggerMacros.hpp"
+
+namespace engine::data {
+
+Reader::Reader() : _index(0), _size(0) {
+}
+
+bool Reader::open(const std::string &path) {
+    this->close();
+
+    this->_file.open(path, std::ios::binary | std::ios::ate);
+
+    if (!this->_file.is_open()) {
+        LOG_ERROR("Could not open record file: {}", path);
+
+        return false;
+    }
+
+    std::streamoff bytes = this->_file.tellg();
+
+    if (bytes % static_cast<std::streamoff>(sizeof(Record)) != 0) {
+        LOG_WARN("Record file {} has a truncated last record", path);
+    }
+
+    this->_size = static_cast<size_t>(bytes) / sizeof(Record);
+
+    this->rewind();
+
+    return true;
+}
+
+void Reader::close() {
+    if (this->_file.is_open()) {
+        this->_file.close();
+    }
+
+    this->_buffer.clear();
+
+    this->_index = 0;
+    this->_size = 0;
+}
+
+bool Reader::isOpen() const {
+    return this->_file.is_open();
+}
+
+bool Reader::read(Record &record) {
+    if (this->_index >= this->_buffer.size() && !this->fill()) {
+        return false;
+    }
+
+    record = this->_buffer[this->_index++];
+
+    return true;
+}
+
+size_t Reader::read(Record *records, size_t count) {
+    size_t read = 0;
+
+    while (read < count && this->read(records[read])) {
+        ++read;
+    }
+
+    return read;
+}
+
+void Reader::rewind() {
+    this->_file.clear();
+    this->_file.seekg(0);
+
+    this->_buffer.clear();
+
+    this->_index = 0;
+}
+
+// Total records in the file
+size_t Reader::size() const {
+    return this->_size;
+}
+
+bool Reader::fill() {
+    this->_buffer.resize(this->_BUFFER_RECORDS);
+
+    this->_file.read(reinterpret_cast<char *>(this->_buffer.data()), static_cast<std::streamsize>(this->_BUFFER_RECORDS * sizeof(Record)));
+
+    this->_buffer.resize(static_cast<size_t>(this->_file.gcount()) / sizeof(Record));
+
+    this->_index = 0;
+
+    return !this->_buffer.empty();
+}
+
+} // namespace engine::data
@@ -0,0 +1,74 @@
+#include "engine/data/Writer.hpp"
+
+#include "logger/LoggerMacros.hpp"
+
+namespace engine::data {
+
+Writer::Writer() : _size(0) {
+    this->_buffer.reserve(this->_BUFFER_RECORDS);
+}
+
+Writer::~Writer() {
+    this->close();
+}
+
+bool Writer::open(const std::string &path) {
+    this->close();
+
+    this->_file.open(path, std::ios::binary | std::ios::app);
+
+    if (!this->_file.is_open()) {
+        LOG_ERROR("Could not open record file: {}", path);
+
+        return false;
+    }
+
+    return true;
+}
+
+void Writer::close() {
+    if (!this->_file.is_open()) {
+        return;
+    }
+
+    this->flush();
+
+    this->_file.close();
+}
+
+bool Writer::isOpen() const {
+    return this->_file.is_open();
+}
+
+void Writer::write(const Record &record) {
+    this->_buffer.push_back(record);
+
+    ++this->_size;
+
+    if (this->_buffer.size() >= this->_BUFFER_RECORDS) {
+        this->flush();
+    }
+}
+
+void Writer::write(const Record *records, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        this->write(records[i]);
+    }
+}
+
+void Writer::flush() {
+    if (!this->_buffer.empty()) {
+        this->_file.write(reinterpret_cast<const char *>(this->_buffer.data()), static_cast<std::streamsize>(this->_buffer.size() * sizeof(Record)));
+
+        this->_buffer.clear();
+    }
+
+    this->_file.flush();
+}
+
+// Records written since the file was opened
+size_t Writer::size() const {
+    return this->_size;
+}
+
+} // namespace engine::data
@@ -0,0 +1,157 @@
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+#include "engine/evaluation/BatchEvaluator.hpp"
+
+#include "engine/Engine.hpp"
+
+#include "engine/evaluation/Terms.hpp"
+#include "engine/evaluation/Tapered.hpp"
+
+#include "engine/evaluation/pesto/Phase.hpp"
+
+#include "engine/evaluation/endgame/Endgame.hpp"
+
+#include "utility/BitUtility.hpp"
+
+using namespace engine::data;
+using namespace engine::board;
+using namespace engine::evaluation::pesto;
+
+using namespace utility;
+
+namespace engine::evaluation {
+
+BatchEvaluator::BatchEvaluator(int threads) : _threads(threads) {
+    if (this->_threads <= 0) {
+        this->_threads = std::max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+    }
+
+    // The mobility terms look up the shared attack tables
+    Engine::initialise();
+}
+
+// Workers take chunks in order, each chunk writes only its own scores
+void BatchEvaluator::evaluate(const Record *records, size_t count, int *scores) const {
+    std::atomic<size_t> nextChunk(0);
+
+    auto worker = [&]() {
+        while (true) {
+            size_t first = nextChunk.fetch_add(1) * this->_CHUNK_SIZE;
+
+            if (first >= count) {
+                return;
+            }
+
+            size_t last = std::min(first + this->_CHUNK_SIZE, count);
+
+            for (size_t block = first; block < last; block += this->_BLOCK_SIZE) {
+                BatchEvaluator::evaluateBlock(records + block, std::min(this->_BLOCK_SIZE, last - block), scores + block);
+            }
+        }
+    };
+
+    int threads = static_cast<int>(std::min<size_t>(this->_threads, (count + this->_CHUNK_SIZE - 1) / this->_CHUNK_SIZE));
+
+    if (threads <= 1) {
+        worker();
+
+        return;
+    }
+
+    std::vector<std::thread> workers;
+
+    for (int thread = 0; thread < threads; ++thread) {
+        workers.emplace_back(worker);
+    }
+
+    for (std::thread &thread : workers) {
+        thread.join();
+    }
+}
+
+// The bitboard terms are gathered position by position, then tapering and the side to move run over flat arrays so the compiler vectorises them
+void BatchEvaluator::evaluateBlock(const Record *records, size_t count, int *scores) {
+    int packedScores[_BLOCK_SIZE];
+    int phases[_BLOCK_SIZE];
+    int signs[_BLOCK_SIZE];
+    int endgameScores[_BLOCK_SIZE];
+    int isEndgames[_BLOCK_SIZE];
+    int isValids[_BLOCK_SIZE];
+
+    for (size_t i = 0; i < count; ++i) {
+        const Record &record = records[i];
+
+        uint64_t bitboards[2][6] = {};
+
+        int packedScore = 0;
+        int phase = 0;
+
+        uint64_t occupancy = record.occupancy;
+
+        isValids[i] = 1;
+
+        for (int j = 0; occupancy && j < 32; ++j) {
+            int square = BitUtility::popLSB(occupancy);
+
+            uint8_t code = (record.pieces[j >> 1] >> ((j & 1) << 2)) & 0xF;
+
+            int colour = code >> 3;
+            int piece = code & 0x7;
+
+            // A corrupt code would index past the bitboards
+            if (piece > PieceType::KING) {
+                isValids[i] = 0;
+
+                break;
+            }
+
+            BitUtility::setBit(bitboards[colour][piece], square);
+
+            packedScore += PIECE_SQUARE_SCORES.scores[colour][piece][square];
+            phase += GAME_PHASE_VALUES[piece];
+        }
+
+        // The king terms assume one king a side
+        isValids[i] = isValids[i] && BitUtility::popCount(bitboards[ColourType::WHITE][PieceType::KING]) == 1 && BitUtility::popCount(bitboards[ColourType::BLACK][PieceType::KING]) == 1;
+
+        if (!isValids[i]) {
+            packedScores[i] = 0;
+            phases[i] = 0;
+            signs[i] = 1;
+            endgameScores[i] = 0;
+            isEndgames[i] = 0;
+
+            continue;
+        }
+
+        uint64_t occupancies[2] = { 0ULL, 0ULL };
+
+        for (int colour = ColourType::WHITE; colour <= ColourType::BLACK; ++colour) {
+            for (int piece = PieceType::PAWN; piece <= PieceType::KING; ++piece) {
+                occupancies[colour] |= bitboards[colour][piece];
+            }
+        }
+
+        ColourType side = static_cast<ColourType>(record.flags >> 7);
+
+        int endgameScore = 0;
+
+        isEndgames[i] = BitUtility::popCount(record.occupancy) <= endgame::MAX_PIECES && endgame::evaluate(bitboards, side, endgameScore);
+        endgameScores[i] = endgameScore;
+
+        packedScores[i] = isEndgames[i] ? 0 : packedScore + getTermScore(bitboards, occupancies, record.occupancy);
+        phases[i] = phase;
+        signs[i] = 1 - 2 * side;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        int score = signs[i] * taper(packedScores[i], phases[i]);
+
+        scores[i] = !isValids[i] ? 0 : (isEndgames[i] ? endgameScores[i] : score);
+    }
+}
+
+} // namespace engine::evaluation
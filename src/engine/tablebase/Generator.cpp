@@ -0,0 +1,531 @@
+#include <set>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <cstring>
+#include <fstream>
+#include <algorithm>
+#include <filesystem>
+
+#include "engine/tablebase/Generator.hpp"
+
+#include "engine/Engine.hpp"
+
+#include "engine/board/Square.hpp"
+
+#include "engine/evaluation/endgame/Endgame.hpp"
+
+#include "engine/piece/Pawn.hpp"
+#include "engine/piece/Knight.hpp"
+#include "engine/piece/Bishop.hpp"
+#include "engine/piece/Rook.hpp"
+#include "engine/piece/Queen.hpp"
+#include "engine/piece/King.hpp"
+
+#include "logger/LoggerMacros.hpp"
+
+#include "utility/BitUtility.hpp"
+#include "utility/BoardUtility.hpp"
+
+using namespace engine::board;
+
+using namespace engine::piece;
+
+using namespace utility;
+
+namespace engine::tablebase {
+
+Generator::Generator(const std::string &directory, int threads) : _directory(directory), _threads(std::max(threads, 1)) {
+    // Move generation reads the shared attack tables, which other threads may already be reading
+    Engine::initialise();
+
+    std::filesystem::create_directories(directory);
+
+    // Resume from whatever was generated before
+    this->_tablebase.load(directory);
+}
+
+// Codes list each side's king followed by its pieces, e.g. "KRKN"
+bool Generator::generate(const std::string &code) {
+    if (code.empty() || code[0] != 'K' || std::count(code.begin(), code.end(), 'K') != 2 || code.find_first_not_of("KQRBNP") != std::string::npos) {
+        LOG_ERROR("Invalid material code: {}", code);
+
+        return false;
+    }
+
+    return this->generateTable(engine::evaluation::endgame::getMaterialKey(code.c_str()));
+}
+
+// Every material set from three pieces up to the limit
+bool Generator::generate(int maxPieces) {
+    std::set<std::pair<int, uint64_t>> materialKeys;
+
+    std::vector<uint64_t> keys = { 0ULL };
+
+    for (int pieces = 3; pieces <= std::min(maxPieces, MAX_PIECES); ++pieces) {
+        std::vector<uint64_t> nextKeys;
+
+        for (uint64_t key : keys) {
+            for (int side = 0; side < 2; ++side) {
+                for (int piece = PieceType::PAWN; piece < PieceType::KING; ++piece) {
+                    uint64_t nextKey = key + (1ULL << (side * engine::evaluation::endgame::MATERIAL_KEY_SIDE_OFFSET + piece * engine::evaluation::endgame::MATERIAL_KEY_PIECE_OFFSET));
+
+                    bool isMirrored = false;
+
+                    materialKeys.insert({ pieces, getCanonicalMaterialKey(nextKey, isMirrored) });
+
+                    nextKeys.push_back(nextKey);
+                }
+            }
+        }
+
+        std::sort(nextKeys.begin(), nextKeys.end());
+
+        nextKeys.erase(std::unique(nextKeys.begin(), nextKeys.end()), nextKeys.end());
+
+        keys = std::move(nextKeys);
+    }
+
+    for (const auto &[pieces, materialKey] : materialKeys) {
+        if (!this->generateTable(materialKey)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Tables for every capture and promotion are generated first
+bool Generator::generateTable(uint64_t materialKey) {
+    if (materialKey == 0ULL) {
+        return true;
+    }
+
+    bool isMirrored = false;
+
+    materialKey = getCanonicalMaterialKey(materialKey, isMirrored);
+
+    if (this->_tablebase.contains(materialKey)) {
+        return true;
+    }
+
+    if (getPieceCount(materialKey) > MAX_PIECES) {
+        LOG_ERROR("Tablebases are limited to {} pieces: {}", MAX_PIECES, getMaterialCode(materialKey));
+
+        return false;
+    }
+
+    const Layout layout = getLayout(materialKey);
+
+    for (int i = 0; i < layout.pieceCount; ++i) {
+        const int offset = layout.colours[i] * engine::evaluation::endgame::MATERIAL_KEY_SIDE_OFFSET;
+
+        const uint64_t withoutPiece = materialKey - (1ULL << (offset + layout.pieces[i] * engine::evaluation::endgame::MATERIAL_KEY_PIECE_OFFSET));
+
+        if (!this->generateTable(withoutPiece)) {
+            return false;
+        }
+
+        if (layout.pieces[i] != PieceType::PAWN) {
+            continue;
+        }
+
+        for (int promotionPiece = PieceType::KNIGHT; promotionPiece <= PieceType::QUEEN; ++promotionPiece) {
+            if (!this->generateTable(withoutPiece + (1ULL << (offset + promotionPiece * engine::evaluation::endgame::MATERIAL_KEY_PIECE_OFFSET)))) {
+                return false;
+            }
+        }
+    }
+
+    return this->build(layout);
+}
+
+bool Generator::build(const Layout &layout) {
+    const std::string code = getMaterialCode(layout.materialKey);
+
+    LOG_INFO("Generating {} with {} positions on {} threads", code, layout.size, this->_threads);
+
+    std::unique_ptr<std::atomic<uint8_t>[]> values(new std::atomic<uint8_t>[layout.size]);
+
+    uint64_t mates = this->runParallel(layout.size, [&](uint64_t begin, uint64_t end) {
+        uint64_t count = 0;
+
+        for (uint64_t index = begin; index < end; ++index) {
+            uint8_t value = this->getInitialValue(layout, index);
+
+            values[index].store(value, std::memory_order_relaxed);
+
+            count += isLoss(value);
+        }
+
+        return count;
+    });
+
+    int maxDistance = 0;
+
+    for (int distance = 1;; ++distance) {
+        if (distance > MAX_DISTANCE) {
+            LOG_ERROR("Distance to mate does not fit in {}", code);
+
+            return false;
+        }
+
+        uint64_t changes = this->runParallel(layout.size, [&](uint64_t begin, uint64_t end) {
+            uint64_t count = 0;
+
+            for (uint64_t index = begin; index < end; ++index) {
+                if (values[index].load(std::memory_order_relaxed) != UNKNOWN) {
+                    continue;
+                }
+
+                uint8_t value = this->getValue(layout, values.get(), index, distance);
+
+                if (value != UNKNOWN) {
+                    values[index].store(value, std::memory_order_relaxed);
+
+                    ++count;
+                }
+            }
+
+            return count;
+        });
+
+        // Nothing can change once the distance passes every distance in this and earlier tables
+        if (changes > 0) {
+            maxDistance = distance;
+        } else if (distance > this->_tablebase.getMaxDistance()) {
+            break;
+        }
+    }
+
+    uint64_t draws = this->runParallel(layout.size, [&](uint64_t begin, uint64_t end) {
+        uint64_t count = 0;
+
+        for (uint64_t index = begin; index < end; ++index) {
+            uint8_t value = values[index].load(std::memory_order_relaxed);
+
+            if (value == UNKNOWN) {
+                values[index].store(DRAW, std::memory_order_relaxed);
+            }
+
+            count += (value == UNKNOWN || value == DRAW);
+        }
+
+        return count;
+    });
+
+    LOG_INFO("Generated {} with {} checkmates, {} draws and longest mate in {} plies", code, mates, draws, maxDistance);
+
+    return this->write(layout, values.get(), maxDistance);
+}
+
+// Written to a temporary file first so a partial table is never loaded
+bool Generator::write(const Layout &layout, const std::atomic<uint8_t> *values, int maxDistance) {
+    const std::string path = this->_directory + "/" + getMaterialCode(layout.materialKey) + TABLE_EXTENSION;
+    const std::string temporaryPath = path + ".tmp";
+
+    std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+
+    if (!file.is_open()) {
+        LOG_ERROR("Could not write tablebase: {}", temporaryPath);
+
+        return false;
+    }
+
+    Header header{ TABLE_MAGIC, static_cast<uint32_t>(maxDistance), layout.materialKey, layout.size, 0ULL };
+
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+    std::vector<uint8_t> buffer(CHUNK_SIZE);
+
+    for (uint64_t begin = 0; begin < layout.size; begin += CHUNK_SIZE) {
+        uint64_t end = std::min(begin + CHUNK_SIZE, layout.size);
+
+        for (uint64_t index = begin; index < end; ++index) {
+            buffer[index - begin] = values[index].load(std::memory_order_relaxed);
+        }
+
+        file.write(reinterpret_cast<const char *>(buffer.data()), static_cast<std::streamsize>(end - begin));
+    }
+
+    file.close();
+
+    if (!file) {
+        LOG_ERROR("Could not write tablebase: {}", temporaryPath);
+
+        return false;
+    }
+
+    std::filesystem::rename(temporaryPath, path);
+
+    return this->_tablebase.add(path);
+}
+
+// Workers claim chunks of indices until none are left, returns the sum of the chunk results
+uint64_t Generator::runParallel(uint64_t size, const std::function<uint64_t(uint64_t, uint64_t)> &function) const {
+    std::atomic<uint64_t> next(0);
+    std::atomic<uint64_t> total(0);
+
+    auto worker = [&]() {
+        uint64_t count = 0;
+
+        for (uint64_t begin = next.fetch_add(CHUNK_SIZE); begin < size; begin = next.fetch_add(CHUNK_SIZE)) {
+            count += function(begin, std::min(begin + CHUNK_SIZE, size));
+        }
+
+        total += count;
+    };
+
+    std::vector<std::thread> threads;
+
+    for (int i = 1; i < this->_threads; ++i) {
+        threads.emplace_back(worker);
+    }
+
+    worker();
+
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+
+    return total;
+}
+
+// Checkmates and stalemates, everything else is resolved by the iterations
+uint8_t Generator::getInitialValue(const Layout &layout, uint64_t index) const {
+    int squares[MAX_PIECES];
+
+    ColourType side;
+
+    getSquares(layout, index, squares, side);
+
+    Position position;
+
+    if (!this->setPosition(position, layout, squares, side)) {
+        return INVALID;
+    }
+
+    uint8_t childValues[MAX_MOVES];
+
+    if (this->getChildValues(layout, nullptr, position, childValues) > 0) {
+        return UNKNOWN;
+    }
+
+    int king = BitUtility::getLSBIndex(position.bitboards[side][PieceType::KING]);
+
+    return this->isSquareAttacked(position, king, side) ? engine::tablebase::getValue(0) : DRAW;
+}
+
+// Odd distances need one move into a loss, even distances need every move to lose
+// Values written during this iteration have this distance, so they are never mistaken for earlier results
+uint8_t Generator::getValue(const Layout &layout, const std::atomic<uint8_t> *values, uint64_t index, int distance) const {
+    int squares[MAX_PIECES];
+
+    ColourType side;
+
+    getSquares(layout, index, squares, side);
+
+    Position position;
+
+    if (!this->setPosition(position, layout, squares, side)) {
+        return UNKNOWN;
+    }
+
+    uint8_t childValues[MAX_MOVES];
+
+    int count = this->getChildValues(layout, values, position, childValues);
+
+    if (distance & 1) {
+        for (int i = 0; i < count; ++i) {
+            if (isLoss(childValues[i]) && getDistance(childValues[i]) < distance) {
+                return engine::tablebase::getValue(distance);
+            }
+        }
+
+        return UNKNOWN;
+    }
+
+    for (int i = 0; i < count; ++i) {
+        if (!isWin(childValues[i]) || getDistance(childValues[i]) >= distance) {
+            return UNKNOWN;
+        }
+    }
+
+    return engine::tablebase::getValue(distance);
+}
+
+// Values of the positions after every legal move, relative to the side to move in each of them
+int Generator::getChildValues(const Layout &layout, const std::atomic<uint8_t> *values, const Position &position, uint8_t childValues[MAX_MOVES]) const {
+    const ColourType side = position.side;
+    const ColourType otherSide = BoardUtility::getOtherSide(side);
+
+    const uint64_t empty = ~position.occupancyBoth;
+
+    int count = 0;
+
+    for (int piece = PieceType::PAWN; piece <= PieceType::KING; ++piece) {
+        uint64_t pieces = position.bitboards[side][piece];
+
+        while (pieces) {
+            int from = BitUtility::popLSB(pieces);
+
+            uint64_t targets = 0ULL;
+
+            switch (piece) {
+            case PieceType::PAWN:
+                if (Pawn::canSinglePush(from, side, empty)) {
+                    BitUtility::setBit(targets, Pawn::singlePush(from, side));
+
+                    if (Pawn::canDoublePush(from, side, empty)) {
+                        BitUtility::setBit(targets, Pawn::doublePush(from, side));
+                    }
+                }
+
+                targets |= Pawn::ATTACKS[side][from] & position.occupancies[otherSide];
+                break;
+            case PieceType::KNIGHT:
+                targets = Knight::ATTACKS[from];
+                break;
+            case PieceType::BISHOP:
+                targets = Bishop::getAttacks(from, position.occupancyBoth);
+                break;
+            case PieceType::ROOK:
+                targets = Rook::getAttacks(from, position.occupancyBoth);
+                break;
+            case PieceType::QUEEN:
+                targets = Queen::getAttacks(from, position.occupancyBoth);
+                break;
+            default:
+                targets = King::ATTACKS[from];
+                break;
+            }
+
+            targets &= ~position.occupancies[side];
+
+            while (targets) {
+                int to = BitUtility::popLSB(targets);
+
+                bool isPromotion = (piece == PieceType::PAWN) && (Pawn::ENEMY_BACK_RANK[side] & BITBOARD_SQUARES[to]);
+
+                for (int promotionPiece = isPromotion ? PieceType::QUEEN : PieceType::EMPTY; promotionPiece >= PieceType::KNIGHT; --promotionPiece) {
+                    Position child;
+
+                    if (this->makeMove(position, child, from, to, static_cast<PieceType>(piece), static_cast<PieceType>(promotionPiece))) {
+                        childValues[count++] = this->getChildValue(layout, values, child);
+                    }
+
+                    if (!isPromotion) {
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    return count;
+}
+
+uint8_t Generator::getChildValue(const Layout &layout, const std::atomic<uint8_t> *values, const Position &child) const {
+    bool isMirrored = false;
+
+    uint64_t materialKey = getCanonicalMaterialKey(engine::evaluation::endgame::getMaterialKey(child.bitboards), isMirrored);
+
+    if (materialKey == layout.materialKey) {
+        if (values == nullptr) {
+            return UNKNOWN;
+        }
+
+        return values[getIndex(layout, child.bitboards, child.side, isMirrored)].load(std::memory_order_relaxed);
+    }
+
+    uint8_t value = UNKNOWN;
+
+    if (!this->_tablebase.probe(child.bitboards, child.side, value)) {
+        return DRAW;
+    }
+
+    return value;
+}
+
+// Rejects overlapping pieces, touching kings, and the side not to move being in check
+bool Generator::setPosition(Position &position, const Layout &layout, const int squares[MAX_PIECES], ColourType side) const {
+    std::memset(&position, 0, sizeof(position));
+
+    position.side = side;
+
+    for (int i = 0; i < layout.pieceCount + 2; ++i) {
+        const uint64_t bitboard = BITBOARD_SQUARES[squares[i]];
+
+        if (position.occupancyBoth & bitboard) {
+            return false;
+        }
+
+        ColourType colour = (i < 2) ? static_cast<ColourType>(i) : layout.colours[i - 2];
+        PieceType piece = (i < 2) ? PieceType::KING : layout.pieces[i - 2];
+
+        position.bitboards[colour][piece] |= bitboard;
+        position.occupancies[colour] |= bitboard;
+        position.occupancyBoth |= bitboard;
+    }
+
+    if (King::ATTACKS[squares[0]] & BITBOARD_SQUARES[squares[1]]) {
+        return false;
+    }
+
+    const ColourType otherSide = BoardUtility::getOtherSide(side);
+
+    return !this->isSquareAttacked(position, BitUtility::getLSBIndex(position.bitboards[otherSide][PieceType::KING]), otherSide);
+}
+
+// Returns false if the move leaves the king in check
+bool Generator::makeMove(const Position &position, Position &child, int from, int to, PieceType piece, PieceType promotionPiece) const {
+    const ColourType side = position.side;
+    const ColourType otherSide = BoardUtility::getOtherSide(side);
+
+    child = position;
+
+    if (position.occupancies[otherSide] & BITBOARD_SQUARES[to]) {
+        for (int capturedPiece = PieceType::PAWN; capturedPiece < PieceType::KING; ++capturedPiece) {
+            child.bitboards[otherSide][capturedPiece] &= INVERTED_BITBOARD_SQUARES[to];
+        }
+
+        child.occupancies[otherSide] &= INVERTED_BITBOARD_SQUARES[to];
+    }
+
+    child.bitboards[side][piece] &= INVERTED_BITBOARD_SQUARES[from];
+    child.bitboards[side][(promotionPiece == PieceType::EMPTY) ? piece : promotionPiece] |= BITBOARD_SQUARES[to];
+
+    child.occupancies[side] = (child.occupancies[side] & INVERTED_BITBOARD_SQUARES[from]) | BITBOARD_SQUARES[to];
+    child.occupancyBoth = child.occupancies[side] | child.occupancies[otherSide];
+
+    child.side = otherSide;
+
+    return !this->isSquareAttacked(child, BitUtility::getLSBIndex(child.bitboards[side][PieceType::KING]), side);
+}
+
+// Whether the square is attacked by the opponent of the side
+bool Generator::isSquareAttacked(const Position &position, int square, ColourType side) const {
+    const ColourType otherSide = BoardUtility::getOtherSide(side);
+
+    const uint64_t(&attackers)[6] = position.bitboards[otherSide];
+
+    if (Pawn::ATTACKS[side][square] & attackers[PieceType::PAWN]) {
+        return true;
+    }
+
+    if (Knight::ATTACKS[square] & attackers[PieceType::KNIGHT]) {
+        return true;
+    }
+
+    if (King::ATTACKS[square] & attackers[PieceType::KING]) {
+        return true;
+    }
+
+    if (Bishop::getAttacks(square, position.occupancyBoth) & (attackers[PieceType::BISHOP] | attackers[PieceType::QUEEN])) {
+        return true;
+    }
+
+    return Rook::getAttacks(square, position.occupancyBoth) & (attackers[PieceType::ROOK] | attackers[PieceType::QUEEN]);
+}
+
+} // namespace engine::tablebase
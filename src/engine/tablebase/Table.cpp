@@ -0,0 +1,74 @@
+#include "engine/tablebase/Table.hpp"
+
+#include "logger/LoggerMacros.hpp"
+
+namespace engine::tablebase {
+
+Table::Table() : _header(nullptr), _values(nullptr), _layout{} {
+}
+
+// Map the whole table read-only, values are read in place
+bool Table::open(const std::string &path) {
+    this->close();
+
+    if (!this->_file.open(path, utility::MappedAccess::RANDOM)) {
+        LOG_WARN("Could not map tablebase: {}", path);
+
+        return false;
+    }
+
+    if (this->_file.size() < sizeof(Header)) {
+        LOG_WARN("Tablebase is too short for a header: {}", path);
+
+        this->_file.close();
+
+        return false;
+    }
+
+    const Header *header = static_cast<const Header *>(this->_file.data());
+
+    Layout layout = engine::tablebase::getLayout(header->materialKey);
+
+    if (header->magic != TABLE_MAGIC || header->size != layout.size || this->_file.size() != sizeof(Header) + header->size) {
+        LOG_WARN("Tablebase has an invalid header: {}", path);
+
+        this->_file.close();
+
+        return false;
+    }
+
+    this->_header = header;
+    this->_values = static_cast<const uint8_t *>(this->_file.data()) + sizeof(Header);
+    this->_layout = layout;
+
+    return true;
+}
+
+void Table::close() {
+    this->_file.close();
+
+    this->_header = nullptr;
+    this->_values = nullptr;
+}
+
+bool Table::isOpen() const {
+    return this->_header != nullptr;
+}
+
+uint64_t Table::getMaterialKey() const {
+    return this->_header->materialKey;
+}
+
+int Table::getMaxDistance() const {
+    return static_cast<int>(this->_header->maxDistance);
+}
+
+const Layout &Table::getLayout() const {
+    return this->_layout;
+}
+
+uint8_t Table::getValue(uint64_t index) const {
+    return this->_values[index];
+}
+
+} // namespace engine::tablebase
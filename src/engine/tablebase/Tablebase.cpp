@@ -0,0 +1,95 @@
+#include <algorithm>
+
+#include "engine/tablebase/Tablebase.hpp"
+#include "engine/tablebase/Index.hpp"
+
+#include "engine/evaluation/endgame/Endgame.hpp"
+
+#include "logger/LoggerMacros.hpp"
+
+#include "utility/FileUtility.hpp"
+
+using namespace engine::board;
+
+using namespace utility;
+
+namespace engine::tablebase {
+
+Tablebase::Tablebase() : _maxPieces(0), _maxDistance(0) {
+}
+
+bool Tablebase::load(const std::string &directory) {
+    if (!FileUtility::isDirectory(directory)) {
+        LOG_WARN("Could not find tablebase directory: {}", directory);
+
+        return false;
+    }
+
+    for (const std::string &path : FileUtility::getPathsInDirectory(directory)) {
+        if (FileUtility::isFile(path) && path.size() > 3 && path.compare(path.size() - 3, 3, TABLE_EXTENSION) == 0) {
+            this->add(path);
+        }
+    }
+
+    LOG_INFO("Loaded {} tablebases from {} with up to {} pieces", this->_tables.size(), directory, this->_maxPieces);
+
+    return !this->_tables.empty();
+}
+
+bool Tablebase::add(const std::string &path) {
+    std::unique_ptr<Table> table = std::make_unique<Table>();
+
+    if (!table->open(path)) {
+        return false;
+    }
+
+    this->_maxPieces = std::max(this->_maxPieces, getPieceCount(table->getMaterialKey()));
+    this->_maxDistance = std::max(this->_maxDistance, table->getMaxDistance());
+
+    this->_tables[table->getMaterialKey()] = std::move(table);
+
+    return true;
+}
+
+bool Tablebase::contains(uint64_t materialKey) const {
+    return this->_tables.find(materialKey) != this->_tables.end();
+}
+
+size_t Tablebase::size() const {
+    return this->_tables.size();
+}
+
+int Tablebase::getMaxPieces() const {
+    return this->_maxPieces;
+}
+
+int Tablebase::getMaxDistance() const {
+    return this->_maxDistance;
+}
+
+// Positions must have no castling rights or en passant square, bare kings are always drawn
+bool Tablebase::probe(const uint64_t bitboards[2][6], ColourType side, uint8_t &value) const {
+    uint64_t materialKey = engine::evaluation::endgame::getMaterialKey(bitboards);
+
+    if (materialKey == 0ULL) {
+        value = DRAW;
+
+        return true;
+    }
+
+    bool isMirrored = false;
+
+    auto iterator = this->_tables.find(getCanonicalMaterialKey(materialKey, isMirrored));
+
+    if (iterator == this->_tables.end()) {
+        return false;
+    }
+
+    const Table &table = *iterator->second;
+
+    value = table.getValue(getIndex(table.getLayout(), bitboards, side, isMirrored));
+
+    return true;
+}
+
+} // namespace engine::tablebase
@@ -9,7 +9,7 @@ using namespace utility;
 
 namespace logger {
 
-Logger::Logger() {
+Logger::Logger() : _severity(Severity::INFO) {
     this->initialise();
 }
 
@@ -32,6 +32,12 @@ void Logger::initialise() {
 }
 
 void Logger::log(Severity severity, const char *file, const char *function, int line, std::string message) {
+    std::lock_guard<std::mutex> lock(this->_mutex);
+
+    if (severity < this->_severity) {
+        return;
+    }
+
     Entry entry(severity, file, function, line, message);
 
     this->addEntry(entry);
@@ -39,6 +45,14 @@ void Logger::log(Severity severity, const char *file, const char *function, int
     std::cout << entry.toString() << std::endl;
 }
 
+void Logger::setSeverity(Severity severity) {
+    this->_severity = severity;
+}
+
+bool Logger::isEnabled(Severity severity) const {
+    return severity >= this->_severity;
+}
+
 void Logger::addEntry(Entry entry) {
     this->_entries.push_back(entry);
 
@@ -1,8 +1,16 @@
 #include "application/Application.hpp"
 
+#include "tool/Tool.hpp"
+
 using namespace application;
 
+using namespace tool;
+
 int main(int argc, char *argv[]) {
+    if (argc > 1) {
+        return Tool::run(argc, argv);
+    }
+
     Application application;
 
     // clang-format off
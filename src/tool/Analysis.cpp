@@ -0,0 +1,438 @@
+#include <cerrno>
+#include <cctype>
+#include <csignal>
+#include <cstring>
+#include <iostream>
+#include <algorithm>
+
+#include <unistd.h>
+#include <sys/un.h>
+#include <sys/socket.h>
+
+#include <fmt/format.h>
+
+#include "tool/Analysis.hpp"
+
+#include "engine/board/FenCodec.hpp"
+
+#include "engine/evaluation/Score.hpp"
+
+#include "logger/LoggerMacros.hpp"
+
+#include "utility/BoardUtility.hpp"
+
+using namespace engine;
+using namespace engine::board;
+using namespace engine::move;
+using namespace engine::evaluation;
+
+using namespace utility;
+
+namespace tool {
+
+AnalysisClient::AnalysisClient(int descriptor) : descriptor(descriptor) {
+}
+
+AnalysisClient::~AnalysisClient() {
+    if (this->descriptor >= 0) {
+        ::close(this->descriptor);
+    }
+}
+
+Analysis::Analysis(const AnalysisSettings &settings) : _settings(settings), _readers(0), _isClosed(false) {
+    if (this->_settings.threads <= 0) {
+        this->_settings.threads = std::max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+    }
+
+    this->_settings.queueSize = std::max<size_t>(this->_settings.queueSize, 1);
+    this->_settings.batchSize = std::max<size_t>(this->_settings.batchSize, 1);
+
+    // The reader validates requests with the shared attack tables before any worker has built an engine
+    Engine::initialise();
+}
+
+bool Analysis::run() {
+    std::vector<std::thread> workers = this->startWorkers();
+
+    this->read(std::make_shared<AnalysisClient>(-1));
+
+    // Workers finish what is queued before they see the queue closed
+    this->close();
+
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+
+    return true;
+}
+
+bool Analysis::run(const std::string &socketPath) {
+    sockaddr_un address{};
+
+    if (socketPath.size() >= sizeof(address.sun_path)) {
+        LOG_ERROR("Socket path is too long: {}", socketPath);
+
+        return false;
+    }
+
+    address.sun_family = AF_UNIX;
+
+    std::strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+
+    int server = ::socket(AF_UNIX, SOCK_STREAM, 0);
+
+    // A socket file left by an earlier run would make bind fail
+    ::unlink(socketPath.c_str());
+
+    if (server < 0 || ::bind(server, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 || ::listen(server, SOMAXCONN) != 0) {
+        LOG_ERROR("Could not listen on socket: {}", socketPath);
+
+        if (server >= 0) {
+            ::close(server);
+        }
+
+        return false;
+    }
+
+    // Writing to a client that went away would otherwise end the process
+    std::signal(SIGPIPE, SIG_IGN);
+
+    std::vector<std::thread> workers = this->startWorkers();
+
+    while (true) {
+        int descriptor = ::accept(server, nullptr, nullptr);
+
+        if (descriptor < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            break;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(this->_mutex);
+
+            ++this->_readers;
+        }
+
+        // Detached so a server that sees many short connections does not hold a thread for each
+        std::thread([this, descriptor]() {
+            this->read(std::make_shared<AnalysisClient>(descriptor));
+
+            std::lock_guard<std::mutex> lock(this->_mutex);
+
+            --this->_readers;
+
+            this->_readerFinished.notify_all();
+        }).detach();
+    }
+
+    LOG_ERROR("Stopped accepting clients on socket: {}", socketPath);
+
+    {
+        std::unique_lock<std::mutex> lock(this->_mutex);
+
+        this->_readerFinished.wait(lock, [this]() { return this->_readers == 0; });
+    }
+
+    this->close();
+
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+
+    ::close(server);
+
+    ::unlink(socketPath.c_str());
+
+    return false;
+}
+
+std::vector<std::thread> Analysis::startWorkers() {
+    std::vector<std::thread> workers;
+
+    for (int i = 0; i < this->_settings.threads; ++i) {
+        workers.emplace_back(&Analysis::work, this);
+    }
+
+    return workers;
+}
+
+// Engines are built once per worker, so a request costs a search and not a table initialisation
+void Analysis::work() {
+    std::unique_ptr<Engine> engine = std::make_unique<Engine>();
+
+    engine->setTranspositionTableSize(this->_settings.hashSize);
+
+    std::vector<AnalysisRequest> batch;
+
+    while (this->takeBatch(batch)) {
+        for (const AnalysisRequest &request : batch) {
+            Analysis::respond(*request.client, this->analyse(*engine, request.json));
+        }
+    }
+}
+
+void Analysis::push(AnalysisRequest request) {
+    std::unique_lock<std::mutex> lock(this->_mutex);
+
+    this->_requestTaken.wait(lock, [this]() { return this->_requests.size() < this->_settings.queueSize; });
+
+    this->_requests.push_back(std::move(request));
+
+    this->_requestAdded.notify_one();
+}
+
+// An even share of the queue up to the batch size, so one worker does not take everything while others idle
+bool Analysis::takeBatch(std::vector<AnalysisRequest> &batch) {
+    batch.clear();
+
+    std::unique_lock<std::mutex> lock(this->_mutex);
+
+    this->_requestAdded.wait(lock, [this]() { return !this->_requests.empty() || this->_isClosed; });
+
+    if (this->_requests.empty()) {
+        return false;
+    }
+
+    size_t size = std::clamp<size_t>(this->_requests.size() / this->_settings.threads, 1, this->_settings.batchSize);
+
+    for (size_t i = 0; i < size; ++i) {
+        batch.push_back(std::move(this->_requests.front()));
+
+        this->_requests.pop_front();
+    }
+
+    this->_requestTaken.notify_all();
+
+    return true;
+}
+
+void Analysis::close() {
+    std::lock_guard<std::mutex> lock(this->_mutex);
+
+    this->_isClosed = true;
+
+    this->_requestAdded.notify_all();
+}
+
+void Analysis::read(const std::shared_ptr<AnalysisClient> &client) {
+    if (client->descriptor < 0) {
+        std::string line;
+
+        while (std::getline(std::cin, line)) {
+            this->accept(client, line);
+        }
+
+        return;
+    }
+
+    std::string buffer;
+
+    char chunk[4096];
+
+    while (true) {
+        ssize_t size = ::read(client->descriptor, chunk, sizeof(chunk));
+
+        if (size < 0 && errno == EINTR) {
+            continue;
+        }
+
+        if (size <= 0) {
+            break;
+        }
+
+        buffer.append(chunk, static_cast<size_t>(size));
+
+        size_t start = 0;
+        size_t end = 0;
+
+        while ((end = buffer.find('\n', start)) != std::string::npos) {
+            this->accept(client, buffer.substr(start, end - start));
+
+            start = end + 1;
+        }
+
+        buffer.erase(0, start);
+    }
+
+    if (!buffer.empty()) {
+        this->accept(client, buffer);
+    }
+}
+
+// Malformed lines are answered straight away, only searches wait for a worker
+void Analysis::accept(const std::shared_ptr<AnalysisClient> &client, const std::string &line) {
+    if (std::all_of(line.begin(), line.end(), [](unsigned char letter) { return std::isspace(letter); })) {
+        return;
+    }
+
+    nlohmann::json json = nlohmann::json::parse(line, nullptr, false);
+
+    if (json.is_discarded() || !json.is_object()) {
+        Analysis::respond(*client, Analysis::getError(nlohmann::json::object(), "request is not a JSON object"));
+
+        return;
+    }
+
+    if (!json.contains("fen") || !json["fen"].is_string()) {
+        Analysis::respond(*client, Analysis::getError(json, "missing fen"));
+
+        return;
+    }
+
+    FenCodec::FenPosition position;
+
+    FenCodec::FenResult result = FenCodec::parse(json["fen"].get<std::string>(), position);
+
+    if (result.error != FenCodec::FenError::NONE) {
+        Analysis::respond(*client, Analysis::getError(json, fmt::format("invalid {} at offset {} of fen", FenCodec::ERROR_NAMES[static_cast<int>(result.error)], result.offset)));
+
+        return;
+    }
+
+    this->push(AnalysisRequest{ std::move(json), client });
+}
+
+// Requests are unrelated positions, so the history tables start empty while the transposition table is kept
+nlohmann::json Analysis::analyse(Engine &engine, const nlohmann::json &request) const {
+    SearchLimits searchLimits = this->_settings.searchLimits;
+
+    searchLimits.depth = static_cast<int>(Analysis::getInteger(request, "depth", searchLimits.depth));
+    searchLimits.time = Analysis::getInteger(request, "time", searchLimits.time);
+    searchLimits.nodes = static_cast<uint64_t>(std::max<int64_t>(Analysis::getInteger(request, "nodes", static_cast<int64_t>(searchLimits.nodes)), 0));
+
+    engine.setSearchLimits(searchLimits);
+    engine.setMultiPV(static_cast<int>(Analysis::getInteger(request, "multipv", 1)));
+
+    // A position the codec passes but the engine refuses would otherwise search the worker's previous one
+    if (!engine.parse(request["fen"].get<std::string>().c_str())) {
+        return Analysis::getError(request, "invalid fen");
+    }
+
+    engine.clearHistories();
+
+    uint16_t bestMove = engine.getMove();
+
+    nlohmann::json response = nlohmann::json::object();
+
+    if (request.contains("id")) {
+        response["id"] = request["id"];
+    }
+
+    response["bestmove"] = (bestMove != 0U) ? nlohmann::json(Analysis::getMoveString(bestMove)) : nlohmann::json(nullptr);
+
+    const std::vector<SearchIteration> &iterations = engine.getSearchIterations();
+
+    if (!iterations.empty()) {
+        response["nodes"] = iterations.back().nodes;
+        response["time"] = iterations.back().time;
+    }
+
+    nlohmann::json lines = nlohmann::json::array();
+
+    for (const PrincipalVariation &principalVariation : engine.getPrincipalVariations()) {
+        nlohmann::json line = nlohmann::json::object();
+
+        line["depth"] = principalVariation.depth;
+        line["score"] = principalVariation.score;
+
+        // Moves to mate, negative when the side to move is mated
+        if (std::abs(principalVariation.score) >= Score::CHECKMATE_THRESHOLD) {
+            int mate = (Score::CHECKMATE_SCORE - std::abs(principalVariation.score) + 1) / 2;
+
+            line["mate"] = (principalVariation.score > 0) ? mate : -mate;
+        }
+
+        line["nodes"] = principalVariation.nodes;
+        line["time"] = principalVariation.time;
+
+        line["pv"] = nlohmann::json::array();
+
+        for (uint16_t move : principalVariation.moves) {
+            line["pv"].push_back(Analysis::getMoveString(move));
+        }
+
+        lines.push_back(std::move(line));
+    }
+
+    // The best line's fields sit at the top level, the rest only make sense as a list
+    if (!lines.empty()) {
+        for (const char *key : { "depth", "score", "mate", "pv" }) {
+            if (lines[0].contains(key)) {
+                response[key] = lines[0][key];
+            }
+        }
+    }
+
+    if (lines.size() > 1) {
+        response["lines"] = std::move(lines);
+    }
+
+    return response;
+}
+
+void Analysis::respond(AnalysisClient &client, const nlohmann::json &response) {
+    std::string line = response.dump() + '\n';
+
+    std::lock_guard<std::mutex> lock(client.mutex);
+
+    if (client.descriptor < 0) {
+        std::cout << line << std::flush;
+
+        return;
+    }
+
+    size_t written = 0;
+
+    // A client that went away just loses its responses
+    while (written < line.size()) {
+        ssize_t size = ::send(client.descriptor, line.data() + written, line.size() - written, 0);
+
+        if (size < 0 && errno == EINTR) {
+            continue;
+        }
+
+        if (size <= 0) {
+            return;
+        }
+
+        written += static_cast<size_t>(size);
+    }
+}
+
+nlohmann::json Analysis::getError(const nlohmann::json &request, const std::string &message) {
+    nlohmann::json error = nlohmann::json::object();
+
+    if (request.contains("id")) {
+        error["id"] = request["id"];
+    }
+
+    error["error"] = message;
+
+    return error;
+}
+
+int64_t Analysis::getInteger(const nlohmann::json &request, const char *key, int64_t defaultValue) {
+    if (!request.contains(key) || !request[key].is_number_integer()) {
+        return defaultValue;
+    }
+
+    return request[key].get<int64_t>();
+}
+
+// Coordinate notation, e.g. "e2e4", "e7e8q", castles as the king's move
+std::string Analysis::getMoveString(uint16_t move) {
+    constexpr char LETTERS[6] = { 'p', 'n', 'b', 'r', 'q', 'k' };
+
+    std::string string = BoardUtility::getPositionFromSquare(Move::getFrom(move)) + BoardUtility::getPositionFromSquare(Move::getTo(move));
+
+    if (Move::isGeneralPromotion(move)) {
+        string += LETTERS[Move::getPromotionPiece(move)];
+    }
+
+    return string;
+}
+
+} // namespace tool
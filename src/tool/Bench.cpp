@@ -0,0 +1,338 @@
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <fstream>
+#include <algorithm>
+
+#include <fmt/format.h>
+
+#include "tool/Bench.hpp"
+#include "tool/Epd.hpp"
+
+#include "engine/board/Fen.hpp"
+#include "engine/board/FenCodec.hpp"
+
+#include "engine/data/Record.hpp"
+
+#include "engine/evaluation/BatchEvaluator.hpp"
+
+#include "logger/LoggerMacros.hpp"
+
+using namespace engine;
+using namespace engine::board;
+using namespace engine::data;
+using namespace engine::evaluation;
+
+namespace tool {
+
+Bench::Bench(const BenchSettings &settings) : _settings(settings) {
+}
+
+bool Bench::run(const std::string &path) {
+    std::vector<std::string> positions = Bench::loadPositions(path);
+
+    if (positions.empty()) {
+        LOG_ERROR("No bench positions in: {}", path);
+
+        return false;
+    }
+
+    std::unique_ptr<Engine> engine = std::make_unique<Engine>();
+
+    this->runEvaluation(*engine, positions);
+    this->runBatchEvaluation(*engine, positions);
+    this->runFen(*engine, positions);
+    this->runSearch(*engine, positions);
+    this->runMultiPV(*engine, positions);
+
+    return true;
+}
+
+void Bench::runEvaluation(Engine &engine, const std::vector<std::string> &positions) const {
+    uint64_t evaluations = 0ULL;
+
+    int64_t checksum = 0;
+
+    std::chrono::nanoseconds time(0);
+
+    for (const std::string &position : positions) {
+        engine.parse(position.c_str());
+
+        auto start = std::chrono::steady_clock::now();
+
+        for (int i = 0; i < this->_settings.evaluations; ++i) {
+            checksum += engine.getEvaluation();
+        }
+
+        time += std::chrono::steady_clock::now() - start;
+
+        evaluations += this->_settings.evaluations;
+    }
+
+    double seconds = std::max(std::chrono::duration<double>(time).count(), 1e-9);
+
+    fmt::print("Evaluations: {} in {:.3f} s, {:.0f} evals/s, checksum {}\n", evaluations, seconds, evaluations / seconds, checksum);
+}
+
+// The same evaluations as runEvaluation, packed and scored in bulk on every core
+void Bench::runBatchEvaluation(Engine &engine, const std::vector<std::string> &positions) const {
+    std::vector<Record> records(this->_BATCH_SIZE);
+
+    std::vector<int> expectedScores(records.size());
+
+    for (size_t i = 0; i < records.size(); ++i) {
+        engine.parse(positions[i % positions.size()].c_str());
+
+        engine.pack(records[i]);
+
+        expectedScores[i] = engine.getEvaluation();
+    }
+
+    std::vector<int> scores(records.size());
+
+    BatchEvaluator evaluator(0);
+
+    const uint64_t evaluations = static_cast<uint64_t>(positions.size()) * this->_settings.evaluations;
+
+    uint64_t evaluated = 0ULL;
+
+    auto start = std::chrono::steady_clock::now();
+
+    while (evaluated < evaluations) {
+        size_t size = static_cast<size_t>(std::min<uint64_t>(records.size(), evaluations - evaluated));
+
+        evaluator.evaluate(records.data(), size, scores.data());
+
+        evaluated += size;
+    }
+
+    double seconds = std::max(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(), 1e-9);
+
+    // The last batch may be partial, only compare what it scored
+    size_t compared = static_cast<size_t>(std::min<uint64_t>(records.size(), evaluations));
+
+    size_t mismatches = 0;
+
+    for (size_t i = 0; i < compared; ++i) {
+        mismatches += (scores[i] != expectedScores[i]);
+    }
+
+    fmt::print("Batch evaluations: {} in {:.3f} s, {:.0f} positions/s, {} mismatches\n", evaluated, seconds, evaluated / seconds, mismatches);
+}
+
+// Bare codec rates as for bulk ingestion, the engine rate adds setting up the position, every position must come back from the engine unchanged
+void Bench::runFen(Engine &engine, const std::vector<std::string> &positions) const {
+    std::vector<FenCodec::FenPosition> parsed(positions.size());
+
+    char buffer[FenCodec::MAX_SIZE];
+    char roundTrip[FenCodec::MAX_SIZE];
+
+    size_t mismatches = 0;
+
+    for (size_t i = 0; i < positions.size(); ++i) {
+        mismatches += (FenCodec::parse(positions[i], parsed[i]).error != FenCodec::FenError::NONE);
+
+        mismatches += (FenCodec::write(parsed[i], buffer, sizeof(buffer)) == 0);
+
+        engine.parse(buffer);
+        engine.toFen(roundTrip, sizeof(roundTrip));
+
+        mismatches += (std::strcmp(buffer, roundTrip) != 0);
+    }
+
+    const uint64_t conversions = static_cast<uint64_t>(positions.size()) * Bench::_FEN_PASSES;
+
+    uint64_t checksum = 0ULL;
+
+    FenCodec::FenPosition position;
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < Bench::_FEN_PASSES; ++i) {
+        for (const std::string &fen : positions) {
+            checksum += static_cast<uint64_t>(FenCodec::parse(fen, position).error) + position.castleRights;
+        }
+    }
+
+    double parseSeconds = std::max(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(), 1e-9);
+
+    start = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < Bench::_FEN_PASSES; ++i) {
+        for (const FenCodec::FenPosition &fenPosition : parsed) {
+            checksum += FenCodec::write(fenPosition, buffer, sizeof(buffer));
+        }
+    }
+
+    double writeSeconds = std::max(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(), 1e-9);
+
+    start = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < Bench::_FEN_PASSES; ++i) {
+        for (const std::string &fen : positions) {
+            engine.parse(fen);
+
+            checksum += engine.toFen(buffer, sizeof(buffer));
+        }
+    }
+
+    double engineSeconds = std::max(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(), 1e-9);
+
+    fmt::print("FEN: parse {:.0f}/s, write {:.0f}/s, engine parse and write {:.0f}/s, {} mismatches, checksum {}\n", conversions / parseSeconds, conversions / writeSeconds, conversions / engineSeconds, mismatches, checksum);
+}
+
+void Bench::runSearch(Engine &engine, const std::vector<std::string> &positions) const {
+    engine.setSearchLimits(SearchLimits{ this->_settings.depth, 0, 0ULL });
+
+    engine.setTranspositionTableSize(this->_settings.hashSize);
+
+    uint64_t nodes = 0ULL;
+
+    int64_t time = 0;
+
+    SearchStatistics pruned{};
+
+    int researches = 0;
+
+    for (const std::string &position : positions) {
+        engine.clearTranspositionTable();
+
+        engine.clearHistories();
+
+        engine.parse(position.c_str());
+
+        engine.getMove();
+
+        const std::vector<SearchIteration> &iterations = engine.getSearchIterations();
+
+        if (!iterations.empty()) {
+            nodes += iterations.back().nodes;
+            time += iterations.back().time;
+        }
+
+        for (const SearchIteration &iteration : iterations) {
+            researches += iteration.researches;
+        }
+
+        const SearchStatistics &statistics = engine.getSearchStatistics();
+
+        pruned.nullMove += statistics.nullMove;
+        pruned.razoring += statistics.razoring;
+        pruned.reverseFutility += statistics.reverseFutility;
+        pruned.futility += statistics.futility;
+        pruned.lateMove += statistics.lateMove;
+        pruned.multiCut += statistics.multiCut;
+        pruned.delta += statistics.delta;
+        pruned.see += statistics.see;
+        pruned.betaCutoffs += statistics.betaCutoffs;
+        pruned.firstMoveCutoffs += statistics.firstMoveCutoffs;
+    }
+
+    fmt::print("Nodes: {} in {} ms with a {} MB hash, {:.0f} nodes/s\n", nodes, time, this->_settings.hashSize, nodes * 1000.0 / std::max<int64_t>(time, 1));
+    fmt::print("Aspiration re-searches: {}\n", researches);
+    fmt::print("Beta cutoffs: {}, first move {:.1f}%\n", pruned.betaCutoffs, pruned.firstMoveCutoffs * 100.0 / std::max<uint64_t>(pruned.betaCutoffs, 1ULL));
+    fmt::print("Pruned: null move {}, razoring {}, reverse futility {}, futility {}, late move {}, multi-cut {}, delta {}, see {}\n", pruned.nullMove, pruned.razoring, pruned.reverseFutility, pruned.futility, pruned.lateMove, pruned.multiCut, pruned.delta, pruned.see);
+}
+
+// Every line after the first is searched with the better root moves excluded, its score must still come from a full window, so it should match a single line search of its move from the same root
+void Bench::runMultiPV(Engine &engine, const std::vector<std::string> &positions) const {
+    uint64_t lines = 0ULL;
+    uint64_t agreeing = 0ULL;
+
+    int largestDifference = 0;
+
+    for (const std::string &position : positions) {
+        engine.clearTranspositionTable();
+        engine.clearHistories();
+
+        engine.parse(position);
+
+        engine.setMultiPV(Bench::_MULTI_PV_LINES);
+        engine.setSearchLimits(SearchLimits{ this->_settings.depth, 0, 0ULL });
+
+        engine.getMove();
+
+        std::vector<PrincipalVariation> principalVariations = engine.getPrincipalVariations();
+
+        engine.setMultiPV(1);
+        engine.setSearchLimits(SearchLimits{ std::max(this->_settings.depth - 1, 1), 0, 0ULL });
+
+        for (const PrincipalVariation &principalVariation : principalVariations) {
+            if (principalVariation.moves.empty()) {
+                continue;
+            }
+
+            engine.clearTranspositionTable();
+            engine.clearHistories();
+
+            engine.parse(position);
+
+            uint16_t move = principalVariation.moves.front();
+
+            engine.makeMove(move);
+
+            // Mate or stalemate after the move, there is nothing to search
+            if (!engine.hasLegalMove()) {
+                continue;
+            }
+
+            engine.getMove();
+
+            const std::vector<PrincipalVariation> &singleLine = engine.getPrincipalVariations();
+
+            if (singleLine.empty()) {
+                continue;
+            }
+
+            int difference = std::abs(principalVariation.score + singleLine.front().score);
+
+            ++lines;
+
+            agreeing += (difference <= Bench::_MULTI_PV_MARGIN);
+
+            largestDifference = std::max(largestDifference, difference);
+        }
+    }
+
+    engine.setSearchLimits(SearchLimits{ this->_settings.depth, 0, 0ULL });
+
+    fmt::print("MultiPV: {} of {} lines within {} of a single line search, largest difference {}\n", agreeing, lines, Bench::_MULTI_PV_MARGIN, largestDifference);
+}
+
+// Without a file the perft and test positions from Fen.hpp are used, so results compare across builds
+std::vector<std::string> Bench::loadPositions(const std::string &path) {
+    std::vector<std::string> positions;
+
+    if (path.empty()) {
+        positions.emplace_back(INITIAL_POSITION);
+
+        for (const char *position : POSITIONS) {
+            positions.emplace_back(position);
+        }
+
+        positions.emplace_back(KILLER_POSITION);
+
+        for (const char *position : TEST_POSITIONS) {
+            positions.emplace_back(position);
+        }
+
+        return positions;
+    }
+
+    std::ifstream file(path);
+
+    std::string line;
+
+    while (std::getline(file, line)) {
+        EpdRecord record;
+
+        if (Epd::parseRecord(line, record)) {
+            positions.push_back(record.fen);
+        }
+    }
+
+    return positions;
+}
+
+} // namespace tool
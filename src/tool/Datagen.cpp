@@ -0,0 +1,217 @@
+#include <memory>
+#include <thread>
+#include <algorithm>
+
+#include <fmt/format.h>
+
+#include "tool/Datagen.hpp"
+
+#include "engine/board/Fen.hpp"
+
+#include "engine/evaluation/Score.hpp"
+
+#include "logger/LoggerMacros.hpp"
+
+using namespace engine;
+using namespace engine::board;
+using namespace engine::data;
+using namespace engine::move;
+using namespace engine::evaluation;
+
+namespace tool {
+
+Datagen::Datagen(const DatagenSettings &settings) : _settings(settings), _positions(0ULL), _games(0ULL), _isFinished(false) {
+    if (this->_settings.threads <= 0) {
+        this->_settings.threads = std::max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+    }
+}
+
+bool Datagen::run(const std::string &path) {
+    if (!this->_writer.open(path)) {
+        return false;
+    }
+
+    this->_start = std::chrono::steady_clock::now();
+
+    auto worker = [this](uint64_t seed) {
+        std::unique_ptr<Engine> engine = std::make_unique<Engine>();
+
+        engine->setSearchLimits({ MAX_PLY, 0, this->_settings.nodes });
+
+        std::mt19937_64 generator(seed);
+
+        std::vector<Record> records;
+
+        while (!this->_isFinished) {
+            this->play(*engine, generator, records);
+
+            this->write(records);
+        }
+    };
+
+    std::random_device device;
+
+    std::vector<std::thread> threads;
+
+    for (int i = 0; i < this->_settings.threads; ++i) {
+        threads.emplace_back(worker, (static_cast<uint64_t>(device()) << 32) ^ device() ^ static_cast<uint64_t>(i));
+    }
+
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+
+    this->_writer.close();
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - this->_start).count();
+
+    fmt::print("Wrote {} positions from {} games to {} in {:.1f} s ({:.0f} positions per hour)\n", this->_positions, this->_games, path, seconds, this->_positions * 3600.0 / std::max(seconds, 1e-3));
+
+    return true;
+}
+
+// Records are labelled with the result once the game is over, an abandoned game leaves none
+void Datagen::play(Engine &engine, std::mt19937_64 &generator, std::vector<Record> &records) {
+    records.clear();
+
+    engine.parse(INITIAL_POSITION);
+
+    engine.clearTranspositionTable();
+
+    engine.clearHistories();
+
+    if (!this->playRandomMoves(engine, generator)) {
+        return;
+    }
+
+    std::vector<uint64_t> keys = { engine.getPolyglotKey() };
+
+    Result result = Result::DRAW;
+
+    int winPlies = 0;
+    int drawPlies = 0;
+
+    for (int ply = 0;; ++ply) {
+        ColourType side = engine.getSide();
+
+        bool isInCheck = engine.isInCheck();
+
+        if (!engine.hasLegalMove()) {
+            result = !isInCheck ? Result::DRAW : (side == ColourType::WHITE) ? Result::BLACK_WIN : Result::WHITE_WIN;
+
+            break;
+        }
+
+        if (engine.getHalfMove() >= this->_FIFTY_MOVE_PLIES || std::count(keys.begin(), keys.end(), keys.back()) >= this->_REPETITIONS || engine.isInsufficientMaterial() || ply >= this->_MAX_PLIES) {
+            break;
+        }
+
+        uint16_t move = engine.getMove();
+
+        const std::vector<SearchIteration> &iterations = engine.getSearchIterations();
+
+        if (move == 0U || iterations.empty()) {
+            records.clear();
+
+            return;
+        }
+
+        int score = iterations.back().score;
+        int whiteScore = (side == ColourType::WHITE) ? score : -score;
+
+        if (ply == 0 && std::abs(score) > this->_MAX_OPENING_SCORE) {
+            return;
+        }
+
+        // The static evaluation can not see tactics, so only quiet positions are worth learning from
+        bool isQuiet = !isInCheck && !Move::isGeneralCapture(move) && !Move::isGeneralPromotion(move) && std::abs(score) < Score::CHECKMATE_THRESHOLD;
+
+        if (isQuiet) {
+            Record record;
+
+            engine.pack(record);
+
+            record.score = static_cast<int16_t>(whiteScore);
+
+            records.push_back(record);
+        }
+
+        // Signed streak, positive while white is winning
+        int sign = (whiteScore > 0) ? 1 : -1;
+
+        winPlies = (std::abs(whiteScore) < this->_WIN_SCORE) ? 0 : (winPlies * sign > 0) ? winPlies + sign : sign;
+        drawPlies = (ply >= this->_DRAW_MINIMUM_PLY && std::abs(whiteScore) <= this->_DRAW_SCORE) ? drawPlies + 1 : 0;
+
+        if (std::abs(winPlies) >= this->_WIN_PLIES) {
+            result = (winPlies > 0) ? Result::WHITE_WIN : Result::BLACK_WIN;
+
+            break;
+        }
+
+        if (drawPlies >= this->_DRAW_PLIES) {
+            break;
+        }
+
+        engine.makeMove(move);
+
+        keys.push_back(engine.getPolyglotKey());
+    }
+
+    for (Record &record : records) {
+        record.result = result;
+    }
+}
+
+bool Datagen::playRandomMoves(Engine &engine, std::mt19937_64 &generator) {
+    for (int ply = 0; ply < this->_settings.randomPlies; ++ply) {
+        ColourType side = engine.getSide();
+
+        Move::MoveList moves = engine.generateMoves(side);
+
+        std::vector<uint16_t> legalMoves;
+
+        for (int i = 0; i < moves.size; ++i) {
+            if (engine.isMoveLegal(moves.moves[i], side)) {
+                legalMoves.push_back(moves.moves[i]);
+            }
+        }
+
+        if (legalMoves.empty()) {
+            return false;
+        }
+
+        uint16_t move = legalMoves[std::uniform_int_distribution<size_t>(0, legalMoves.size() - 1)(generator)];
+
+        engine.makeMove(move);
+    }
+
+    return true;
+}
+
+void Datagen::write(const std::vector<Record> &records) {
+    std::lock_guard<std::mutex> lock(this->_writerMutex);
+
+    if (this->_isFinished) {
+        return;
+    }
+
+    size_t count = static_cast<size_t>(std::min<uint64_t>(records.size(), this->_settings.positions - this->_positions));
+
+    this->_writer.write(records.data(), count);
+
+    uint64_t previousPositions = this->_positions;
+
+    this->_positions += count;
+
+    ++this->_games;
+
+    if (this->_positions / this->_REPORT_INTERVAL != previousPositions / this->_REPORT_INTERVAL) {
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - this->_start).count();
+
+        fmt::print("{} positions, {} games, {:.0f} positions per hour\n", this->_positions, this->_games, this->_positions * 3600.0 / std::max(seconds, 1e-3));
+    }
+
+    this->_isFinished = this->_positions >= this->_settings.positions;
+}
+
+} // namespace tool
@@ -0,0 +1,306 @@
+#include <mutex>
+#include <memory>
+#include <thread>
+#include <fstream>
+#include <algorithm>
+
+#include <fmt/format.h>
+
+#include <nlohmann/json.hpp>
+
+#include "tool/Epd.hpp"
+
+#include "logger/LoggerMacros.hpp"
+
+#include "utility/FileUtility.hpp"
+#include "utility/StringUtility.hpp"
+
+using namespace engine;
+
+using namespace utility;
+
+namespace tool {
+
+Epd::Epd(int threads, const SearchLimits &searchLimits) : _threads(std::max(threads, 1)), _searchLimits(searchLimits) {
+    // The engine would clamp it anyway, the report gives the depth actually searched to
+    this->_searchLimits.depth = std::clamp(this->_searchLimits.depth, 1, Engine::getMaxSearchDepth());
+}
+
+// Workers pull lines from the file as they become free, so slow positions do not hold up the rest
+bool Epd::run(const std::string &path, const std::string &reportPath) {
+    std::ifstream file(path);
+
+    if (!file.is_open()) {
+        LOG_ERROR("Could not open EPD file: {}", path);
+
+        return false;
+    }
+
+    std::mutex fileMutex;
+    std::mutex resultMutex;
+
+    std::vector<std::pair<size_t, EpdResult>> results;
+
+    size_t nextIndex = 0;
+
+    auto worker = [&]() {
+        std::unique_ptr<Engine> engine = std::make_unique<Engine>();
+
+        while (true) {
+            EpdRecord record;
+
+            size_t index = 0;
+
+            {
+                std::lock_guard<std::mutex> lock(fileMutex);
+
+                std::string line;
+
+                bool isRecordFound = false;
+
+                while (!isRecordFound && std::getline(file, line)) {
+                    isRecordFound = Epd::parseRecord(line, record);
+                }
+
+                if (!isRecordFound) {
+                    return;
+                }
+
+                index = nextIndex++;
+            }
+
+            EpdResult result = this->solve(*engine, record);
+
+            std::lock_guard<std::mutex> lock(resultMutex);
+
+            if (result.isValid) {
+                fmt::print("{:>4} {:<24} {:<8} {:<7} depth {:>2} time {:>6} ms nodes {:>10}\n", index + 1, result.id, result.move, result.isSolved ? "solved" : "failed", result.depth, result.time, result.nodes);
+            } else {
+                fmt::print("{:>4} {:<24} invalid position, skipped\n", index + 1, result.id);
+            }
+
+            results.emplace_back(index, std::move(result));
+        }
+    };
+
+    std::vector<std::thread> threads;
+
+    for (int i = 0; i < this->_threads; ++i) {
+        threads.emplace_back(worker);
+    }
+
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+
+    std::sort(results.begin(), results.end(), [](const auto &result, const auto &otherResult) { return result.first < otherResult.first; });
+
+    std::vector<EpdResult> orderedResults;
+
+    for (auto &[index, result] : results) {
+        orderedResults.push_back(std::move(result));
+    }
+
+    size_t solved = std::count_if(orderedResults.begin(), orderedResults.end(), [](const EpdResult &result) { return result.isSolved; });
+    size_t valid = std::count_if(orderedResults.begin(), orderedResults.end(), [](const EpdResult &result) { return result.isValid; });
+
+    int64_t solutionTime = 0;
+
+    for (const EpdResult &result : orderedResults) {
+        solutionTime += result.isSolved ? result.solutionTime : 0;
+    }
+
+    double solveRate = (valid == 0) ? 0.0 : 100.0 * solved / valid;
+
+    fmt::print("Solved {} of {} ({:.1f}%), average time to solution {} ms\n", solved, valid, solveRate, solved ? solutionTime / static_cast<int64_t>(solved) : 0);
+
+    if (valid < orderedResults.size()) {
+        LOG_WARN("Skipped {} records with an invalid position", orderedResults.size() - valid);
+    }
+
+    this->writeReport(reportPath, orderedResults);
+
+    return true;
+}
+
+// "<board> <side> <castling> <en passant> bm Qxf7+; id "WAC.001";"
+bool Epd::parseRecord(const std::string &line, EpdRecord &record) {
+    std::vector<std::string> tokens = StringUtility::splitStringByWhiteSpace(line);
+
+    if (tokens.size() < 5 || tokens[0][0] == '#') {
+        return false;
+    }
+
+    record = EpdRecord();
+
+    record.fen = tokens[0] + " " + tokens[1] + " " + tokens[2] + " " + tokens[3];
+
+    std::string halfMove = "0";
+    std::string fullMove = "1";
+
+    // Operations are separated by semicolons outside of quotes
+    std::string operations;
+
+    for (size_t i = 4; i < tokens.size(); ++i) {
+        operations += tokens[i] + " ";
+    }
+
+    std::string operation;
+
+    bool isQuoted = false;
+
+    for (char letter : operations) {
+        if (letter == '"') {
+            isQuoted = !isQuoted;
+
+            continue;
+        }
+
+        if (letter != ';' || isQuoted) {
+            operation += letter;
+
+            continue;
+        }
+
+        std::vector<std::string> operands = StringUtility::splitStringByWhiteSpace(operation);
+
+        operation.clear();
+
+        if (operands.empty()) {
+            continue;
+        }
+
+        const std::string opcode = operands[0];
+
+        operands.erase(operands.begin());
+
+        if (opcode == "bm") {
+            record.bestMoves.insert(record.bestMoves.end(), operands.begin(), operands.end());
+        } else if (opcode == "am") {
+            record.avoidMoves.insert(record.avoidMoves.end(), operands.begin(), operands.end());
+        } else if (opcode == "id" && !operands.empty()) {
+            record.id = operands[0];
+
+            for (size_t i = 1; i < operands.size(); ++i) {
+                record.id += " " + operands[i];
+            }
+        } else if (opcode == "hmvc" && !operands.empty()) {
+            halfMove = operands[0];
+        } else if (opcode == "fmvn" && !operands.empty()) {
+            fullMove = operands[0];
+        }
+    }
+
+    record.fen += " " + halfMove + " " + fullMove;
+
+    return !record.bestMoves.empty() || !record.avoidMoves.empty();
+}
+
+EpdResult Epd::solve(Engine &engine, const EpdRecord &record) const {
+    EpdResult result{};
+
+    result.id = record.id;
+    result.fen = record.fen;
+    result.solutionTime = -1;
+
+    // Searching anyway would report the previous record's position against this one
+    result.isValid = engine.parse(record.fen.c_str());
+
+    if (!result.isValid) {
+        LOG_WARN("Skipping EPD record with an invalid position: {}", record.id.empty() ? record.fen : record.id);
+
+        return result;
+    }
+
+    engine.clearTranspositionTable();
+
+    engine.clearHistories();
+
+    engine.setSearchLimits(this->_searchLimits);
+
+    uint16_t move = engine.getMove();
+
+    const std::vector<SearchIteration> &iterations = engine.getSearchIterations();
+
+    result.move = engine.getSan(move);
+    result.isSolved = Epd::isCorrect(record, result.move);
+
+    if (!iterations.empty()) {
+        result.depth = iterations.back().depth;
+        result.score = iterations.back().score;
+        result.nodes = iterations.back().nodes;
+        result.time = iterations.back().time;
+    }
+
+    if (!result.isSolved) {
+        return result;
+    }
+
+    // Walk back to the first depth of the final run of correct moves
+    for (auto iteration = iterations.rbegin(); iteration != iterations.rend(); ++iteration) {
+        if (!Epd::isCorrect(record, engine.getSan(iteration->bestMove))) {
+            break;
+        }
+
+        result.solutionTime = iteration->time;
+        result.solutionNodes = iteration->nodes;
+    }
+
+    return result;
+}
+
+void Epd::writeReport(const std::string &path, const std::vector<EpdResult> &results) const {
+    nlohmann::json report;
+
+    report["limits"] = { { "depth", this->_searchLimits.depth }, { "time", this->_searchLimits.time }, { "nodes", this->_searchLimits.nodes } };
+    report["threads"] = this->_threads;
+    report["total"] = std::count_if(results.begin(), results.end(), [](const EpdResult &result) { return result.isValid; });
+    report["invalid"] = std::count_if(results.begin(), results.end(), [](const EpdResult &result) { return !result.isValid; });
+    report["solved"] = std::count_if(results.begin(), results.end(), [](const EpdResult &result) { return result.isSolved; });
+    report["results"] = nlohmann::json::array();
+
+    for (const EpdResult &result : results) {
+        report["results"].push_back({
+            { "id", result.id },
+            { "fen", result.fen },
+            { "move", result.move },
+            { "valid", result.isValid },
+            { "solved", result.isSolved },
+            { "depth", result.depth },
+            { "score", result.score },
+            { "nodes", result.nodes },
+            { "time", result.time },
+            { "solutionTime", result.solutionTime },
+            { "solutionNodes", result.solutionNodes },
+        });
+    }
+
+    FileUtility::saveJson(report, path);
+}
+
+bool Epd::isCorrect(const EpdRecord &record, const std::string &san) {
+    const std::string move = Epd::getNormalisedSan(san);
+
+    auto isMatch = [&move](const std::string &expectedMove) { return Epd::getNormalisedSan(expectedMove) == move; };
+
+    if (std::any_of(record.avoidMoves.begin(), record.avoidMoves.end(), isMatch)) {
+        return false;
+    }
+
+    return record.bestMoves.empty() || std::any_of(record.bestMoves.begin(), record.bestMoves.end(), isMatch);
+}
+
+// Suites disagree on check marks, annotations, and zeros in castling
+std::string Epd::getNormalisedSan(std::string san) {
+    while (!san.empty() && (san.back() == '+' || san.back() == '#' || san.back() == '!' || san.back() == '?')) {
+        san.pop_back();
+    }
+
+    std::replace(san.begin(), san.end(), '0', 'O');
+
+    san.erase(std::remove(san.begin(), san.end(), '='), san.end());
+
+    return san;
+}
+
+} // namespace tool
@@ -0,0 +1,91 @@
+#include <chrono>
+#include <memory>
+#include <algorithm>
+
+#include <fmt/format.h>
+
+#include "tool/Explorer.hpp"
+#include "tool/Pgn.hpp"
+
+#include "engine/Engine.hpp"
+
+#include "engine/book/Tree.hpp"
+#include "engine/book/TreeBuilder.hpp"
+
+#include "logger/LoggerMacros.hpp"
+
+using namespace engine;
+using namespace engine::book;
+
+namespace tool {
+
+Explorer::Explorer(const ExplorerSettings &settings) : _settings(settings) {
+}
+
+bool Explorer::build(const std::string &pgnPath, const std::string &treePath) {
+    Pgn pgn(PgnSettings{ this->_settings.threads, 4 << 20, this->_settings.plies });
+
+    TreeBuilder treeBuilder(treePath, this->_settings.memoryBytes);
+
+    auto start = std::chrono::steady_clock::now();
+
+    if (!pgn.run(pgnPath, treeBuilder)) {
+        return false;
+    }
+
+    size_t runs = treeBuilder.runs();
+
+    if (!treeBuilder.finish()) {
+        return false;
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    fmt::print("Wrote {} moves from {} runs to {} in {:.2f} s\n", treeBuilder.size(), runs + 1, treePath, seconds);
+
+    return true;
+}
+
+bool Explorer::probe(const std::string &treePath, const std::string &fen) const {
+    Tree tree;
+
+    if (!tree.open(treePath)) {
+        return false;
+    }
+
+    std::unique_ptr<Engine> engine = std::make_unique<Engine>();
+
+    if (!engine->parse(fen)) {
+        return false;
+    }
+
+    const uint64_t key = engine->getPolyglotKey();
+
+    size_t found = 0;
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < this->_TIMED_LOOKUPS; ++i) {
+        found += tree.getEntries(key).size();
+    }
+
+    double microseconds = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / this->_TIMED_LOOKUPS;
+
+    std::vector<TreeEntry> entries = tree.getEntries(key);
+
+    fmt::print("{} moves in {:.2f} us ({} lookups)\n", entries.size(), microseconds, found / std::max<size_t>(entries.size(), 1));
+
+    for (const TreeEntry &entry : entries) {
+        const double games = static_cast<double>(getTreeGames(entry));
+
+        // From the side to move's point of view
+        const double whiteScore = (entry.whiteWins + entry.draws * 0.5) / games;
+        const double score = (engine->getSide() == engine::board::ColourType::WHITE) ? whiteScore : 1.0 - whiteScore;
+
+        fmt::print("{:<8} {:>10} games  {:5.1f}% white {:5.1f}% draw {:5.1f}% black  score {:5.1f}%\n", engine->getSan(entry.move), getTreeGames(entry), entry.whiteWins * 100.0 / games, entry.draws * 100.0 / games, entry.blackWins * 100.0 / games, score * 100.0);
+    }
+
+    return true;
+}
+
+} // namespace tool
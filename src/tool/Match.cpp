@@ -0,0 +1,533 @@
+#include <cmath>
+#include <cctype>
+#include <ctime>
+#include <limits>
+#include <memory>
+#include <thread>
+#include <algorithm>
+
+#include <fmt/format.h>
+
+#include "tool/Match.hpp"
+
+#include "engine/board/Fen.hpp"
+#include "engine/board/FenCodec.hpp"
+
+#include "logger/LoggerMacros.hpp"
+
+#include "utility/StringUtility.hpp"
+
+using namespace engine;
+using namespace engine::board;
+using namespace engine::move;
+
+using namespace utility;
+
+namespace tool {
+
+Match::Match(const MatchEngine &engine, const MatchEngine &otherEngine, const MatchSettings &settings)
+    : _engines{ engine, otherEngine }, _settings(settings), _wins(0), _losses(0), _draws(0), _nextGame(0), _isFinished(false) {
+    if (this->_settings.threads <= 0) {
+        this->_settings.threads = std::max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+    }
+}
+
+// Game 2n and 2n + 1 share an opening with colours reversed, so an unbalanced opening cancels out
+bool Match::run(const std::string &openingsPath, const std::string &pgnPath) {
+    std::vector<std::string> openings = Match::loadOpenings(openingsPath);
+
+    if (openings.empty()) {
+        LOG_ERROR("No openings found in: {}", openingsPath);
+
+        return false;
+    }
+
+    return this->run(openings, pgnPath);
+}
+
+// An empty PGN path plays without writing the games
+bool Match::run(const std::vector<std::string> &openings, const std::string &pgnPath) {
+    if (openings.empty()) {
+        return false;
+    }
+
+    if (!pgnPath.empty()) {
+        this->_pgn.open(pgnPath, std::ios::app);
+
+        if (!this->_pgn.is_open()) {
+            LOG_ERROR("Could not open PGN file: {}", pgnPath);
+
+            return false;
+        }
+    }
+
+    auto worker = [&]() {
+        std::unique_ptr<Engine> engines[2] = { Match::createEngine(this->_engines[0]), Match::createEngine(this->_engines[1]) };
+
+        while (!this->_isFinished) {
+            int game = this->_nextGame++;
+
+            if (game >= this->_settings.games) {
+                return;
+            }
+
+            bool isFirstWhite = (game % 2) == 0;
+
+            Engine *players[2] = { engines[isFirstWhite ? 0 : 1].get(), engines[isFirstWhite ? 1 : 0].get() };
+
+            MatchGame matchGame = this->play(players, openings[(game / 2) % openings.size()], game + 1);
+
+            // An opening the engines refused was never played, so it neither counts nor goes in the PGN
+            if (matchGame.result.empty()) {
+                LOG_WARN("Game {} aborted, the engines could not load its opening: {}", matchGame.round, matchGame.fen);
+
+                continue;
+            }
+
+            matchGame.white = this->_engines[isFirstWhite ? 0 : 1].name;
+            matchGame.black = this->_engines[isFirstWhite ? 1 : 0].name;
+
+            std::lock_guard<std::mutex> lock(this->_resultMutex);
+
+            if (matchGame.result == "1/2-1/2") {
+                ++this->_draws;
+            } else if ((matchGame.result == "1-0") == isFirstWhite) {
+                ++this->_wins;
+            } else {
+                ++this->_losses;
+            }
+
+            this->record(matchGame);
+        }
+    };
+
+    std::vector<std::thread> threads;
+
+    for (int i = 0; i < this->_settings.threads; ++i) {
+        threads.emplace_back(worker);
+    }
+
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+
+    if (!this->_settings.isQuiet) {
+        this->printResults();
+    }
+
+    return true;
+}
+
+int Match::getWins() const {
+    return this->_wins;
+}
+
+int Match::getLosses() const {
+    return this->_losses;
+}
+
+int Match::getDraws() const {
+    return this->_draws;
+}
+
+bool Match::parseConfig(const nlohmann::json &config, MatchEngine &engine, MatchEngine &otherEngine, MatchSettings &settings) {
+    if (!config.contains("engines") || !config["engines"].is_array() || config["engines"].size() != 2) {
+        LOG_ERROR("Match config needs exactly two engines");
+
+        return false;
+    }
+
+    engine = Match::parseEngine(config["engines"][0], "engine1");
+    otherEngine = Match::parseEngine(config["engines"][1], "engine2");
+
+    settings = Match::parseSettings(config);
+
+    return true;
+}
+
+// { "name": "dev", "depth": 64, "time": 100, "nodes": 0, "book": "", "tablebases": "", "tunables": { "NMP_REDUCTION": 3 } }
+MatchEngine Match::parseEngine(const nlohmann::json &options, const std::string &name) {
+    MatchEngine engine;
+
+    engine.name = options.value("name", name);
+    engine.searchLimits = { options.value("depth", MAX_PLY), options.value("time", int64_t(100)), options.value("nodes", uint64_t(0)) };
+    engine.bookPath = options.value("book", std::string());
+    engine.tablebasePath = options.value("tablebases", std::string());
+
+    for (const auto &[tunable, value] : options.value("tunables", nlohmann::json::object()).items()) {
+        engine.tunables.emplace_back(tunable, value.get<int>());
+    }
+
+    return engine;
+}
+
+MatchSettings Match::parseSettings(const nlohmann::json &config) {
+    const nlohmann::json resign = config.value("resign", nlohmann::json::object());
+    const nlohmann::json draw = config.value("draw", nlohmann::json::object());
+    const nlohmann::json sprt = config.value("sprt", nlohmann::json::object());
+
+    MatchSettings settings;
+
+    settings.games = config.value("games", 1000);
+    settings.threads = config.value("threads", 0);
+
+    settings.resignScore = resign.value("score", 1000);
+    settings.resignPlies = resign.value("plies", 6);
+
+    settings.drawScore = draw.value("score", 10);
+    settings.drawPlies = draw.value("plies", 8);
+    settings.drawMinimumPly = draw.value("minimumPly", 80);
+
+    settings.maxPlies = config.value("maxPlies", 400);
+
+    settings.elo0 = sprt.value("elo0", 0.0);
+    settings.elo1 = sprt.value("elo1", 5.0);
+    settings.alpha = sprt.value("alpha", 0.05);
+    settings.beta = sprt.value("beta", 0.05);
+
+    settings.isSprt = true;
+    settings.isQuiet = false;
+
+    return settings;
+}
+
+// An empty result means the game was aborted before the first move
+MatchGame Match::play(Engine *engines[2], const std::string &fen, int round) {
+    MatchGame game;
+
+    game.fen = fen;
+    game.round = round;
+
+    for (int side = 0; side < 2; ++side) {
+        if (!engines[side]->parse(fen.c_str())) {
+            return game;
+        }
+
+        engines[side]->clearTranspositionTable();
+
+        engines[side]->clearHistories();
+    }
+
+    // Polyglot keys since the start, enough for repetitions since irreversible moves never repeat
+    std::vector<uint64_t> keys = { engines[0]->getPolyglotKey() };
+
+    // Scores from white's point of view, one per ply
+    std::vector<int> scores;
+
+    while (true) {
+        ColourType side = engines[0]->getSide();
+
+        Engine &engine = *engines[side];
+
+        const char *sideName = (side == ColourType::WHITE) ? "White" : "Black";
+        const char *otherResult = (side == ColourType::WHITE) ? "0-1" : "1-0";
+
+        if (!engine.hasLegalMove()) {
+            game.result = engine.isInCheck() ? otherResult : "1/2-1/2";
+            game.termination = engine.isInCheck() ? fmt::format("{} is mated", sideName) : "Stalemate";
+
+            return game;
+        }
+
+        if (engine.getHalfMove() >= this->_FIFTY_MOVE_PLIES) {
+            game.result = "1/2-1/2";
+            game.termination = "Fifty move rule";
+
+            return game;
+        }
+
+        if (std::count(keys.begin(), keys.end(), keys.back()) >= this->_REPETITIONS) {
+            game.result = "1/2-1/2";
+            game.termination = "Threefold repetition";
+
+            return game;
+        }
+
+        if (engine.isInsufficientMaterial()) {
+            game.result = "1/2-1/2";
+            game.termination = "Insufficient material";
+
+            return game;
+        }
+
+        game.result = this->adjudicate(scores, static_cast<int>(game.moves.size()), game.termination);
+
+        if (!game.result.empty()) {
+            return game;
+        }
+
+        uint16_t move = engine.getMove();
+
+        Move::MoveList moves = engine.generateMoves(side);
+
+        bool isLegal = false;
+
+        for (int i = 0; i < moves.size && !isLegal; ++i) {
+            isLegal = (moves.moves[i] == move) && engine.isMoveLegal(moves.moves[i], side);
+        }
+
+        if (!isLegal) {
+            game.result = otherResult;
+            game.termination = fmt::format("{} plays an illegal move", sideName);
+
+            return game;
+        }
+
+        const std::vector<SearchIteration> &iterations = engine.getSearchIterations();
+
+        int score = iterations.empty() ? std::numeric_limits<int>::min() : iterations.back().score;
+
+        scores.push_back((iterations.empty() || side == ColourType::WHITE) ? score : -score);
+
+        game.moves.push_back(engine.getSan(move));
+
+        for (int i = 0; i < 2; ++i) {
+            uint16_t playedMove = move;
+
+            engines[i]->makeMove(playedMove);
+        }
+
+        keys.push_back(engines[0]->getPolyglotKey());
+    }
+}
+
+// Called with the result mutex held
+void Match::record(const MatchGame &game) {
+    if (this->_pgn.is_open()) {
+        this->_pgn << this->getPgn(game);
+        this->_pgn.flush();
+    }
+
+    if (this->_settings.isQuiet && !this->_settings.isSprt) {
+        return;
+    }
+
+    int games = this->_wins + this->_losses + this->_draws;
+
+    double llr = this->getLlr();
+    double lowerBound = std::log(this->_settings.beta / (1.0 - this->_settings.alpha));
+    double upperBound = std::log((1.0 - this->_settings.beta) / this->_settings.alpha);
+
+    if (!this->_settings.isQuiet) {
+        fmt::print("Game {:>5} {} vs {}: {} {{{}}}\n", game.round, game.white, game.black, game.result, game.termination);
+        fmt::print("Score of {} vs {}: {} - {} - {} [{:.3f}] {} LLR {:.2f} [{:.2f}, {:.2f}]\n", this->_engines[0].name, this->_engines[1].name, this->_wins, this->_losses, this->_draws, (this->_wins + 0.5 * this->_draws) / games, games, llr, lowerBound, upperBound);
+    }
+
+    if (this->_settings.isSprt && ((llr >= upperBound) || (llr <= lowerBound))) {
+        this->_isFinished = true;
+    }
+}
+
+void Match::printResults() {
+    int games = this->_wins + this->_losses + this->_draws;
+
+    if (games == 0) {
+        return;
+    }
+
+    double score = (this->_wins + 0.5 * this->_draws) / games;
+    double variance = (this->_wins + 0.25 * this->_draws) / games - score * score;
+    double margin = 1.96 * std::sqrt(variance / games);
+
+    double llr = this->getLlr();
+    double lowerBound = std::log(this->_settings.beta / (1.0 - this->_settings.alpha));
+    double upperBound = std::log((1.0 - this->_settings.beta) / this->_settings.alpha);
+
+    std::string sprtResult = (llr >= upperBound) ? "H1 accepted" : (llr <= lowerBound) ? "H0 accepted" : "inconclusive";
+
+    fmt::print("Score of {} vs {}: {} - {} - {} [{:.3f}] {}\n", this->_engines[0].name, this->_engines[1].name, this->_wins, this->_losses, this->_draws, score, games);
+    fmt::print("Elo difference: {:.1f} +/- {:.1f}\n", Match::getElo(score), (Match::getElo(score + margin) - Match::getElo(score - margin)) / 2.0);
+    fmt::print("SPRT ({:.1f}, {:.1f}): LLR {:.2f} [{:.2f}, {:.2f}], {}\n", this->_settings.elo0, this->_settings.elo1, llr, lowerBound, upperBound, sprtResult);
+}
+
+std::string Match::getPgn(const MatchGame &game) {
+    char date[16];
+
+    std::time_t now = std::time(nullptr);
+
+    std::strftime(date, sizeof(date), "%Y.%m.%d", std::localtime(&now));
+
+    std::string pgn;
+
+    pgn += "[Event \"Match\"]\n";
+    pgn += "[Site \"?\"]\n";
+    pgn += fmt::format("[Date \"{}\"]\n", date);
+    pgn += fmt::format("[Round \"{}\"]\n", game.round);
+    pgn += fmt::format("[White \"{}\"]\n", game.white);
+    pgn += fmt::format("[Black \"{}\"]\n", game.black);
+    pgn += fmt::format("[Result \"{}\"]\n", game.result);
+
+    if (game.fen != INITIAL_POSITION) {
+        pgn += fmt::format("[FEN \"{}\"]\n", game.fen);
+        pgn += "[SetUp \"1\"]\n";
+    }
+
+    pgn += fmt::format("[PlyCount \"{}\"]\n\n", game.moves.size());
+
+    std::vector<std::string> fields = StringUtility::splitStringByWhiteSpace(game.fen);
+
+    int fullMove = std::stoi(fields[5]);
+
+    bool isWhite = fields[1] == "w";
+
+    std::string line;
+
+    auto append = [&pgn, &line](const std::string &token) {
+        if (!line.empty() && line.size() + token.size() + 1 > 80) {
+            pgn += line + "\n";
+
+            line.clear();
+        }
+
+        line += line.empty() ? token : " " + token;
+    };
+
+    for (size_t i = 0; i < game.moves.size(); ++i) {
+        if (isWhite) {
+            append(fmt::format("{}. {}", fullMove, game.moves[i]));
+        } else {
+            append((i == 0) ? fmt::format("{}... {}", fullMove, game.moves[i]) : game.moves[i]);
+
+            ++fullMove;
+        }
+
+        isWhite = !isWhite;
+    }
+
+    append(fmt::format("{{{}}} {}", game.termination, game.result));
+
+    return pgn + line + "\n\n";
+}
+
+// Both engines have to agree for the whole window, a single engine can not end the game on its own
+std::string Match::adjudicate(const std::vector<int> &scores, int ply, std::string &termination) const {
+    if (ply >= this->_settings.maxPlies) {
+        termination = "Adjudicated, maximum game length";
+
+        return "1/2-1/2";
+    }
+
+    auto isWindow = [&scores](int plies, auto isMatch) {
+        return plies > 0 && static_cast<int>(scores.size()) >= plies && std::all_of(scores.end() - plies, scores.end(), isMatch);
+    };
+
+    auto isScored = [](int score) { return score != std::numeric_limits<int>::min(); };
+
+    int resignScore = this->_settings.resignScore;
+    int drawScore = this->_settings.drawScore;
+
+    if (isWindow(this->_settings.resignPlies, [&](int score) { return isScored(score) && score >= resignScore; })) {
+        termination = "Adjudicated, black resigns";
+
+        return "1-0";
+    }
+
+    if (isWindow(this->_settings.resignPlies, [&](int score) { return isScored(score) && score <= -resignScore; })) {
+        termination = "Adjudicated, white resigns";
+
+        return "0-1";
+    }
+
+    if (ply >= this->_settings.drawMinimumPly && isWindow(this->_settings.drawPlies, [&](int score) { return isScored(score) && std::abs(score) <= drawScore; })) {
+        termination = "Adjudicated, draw";
+
+        return "1/2-1/2";
+    }
+
+    return "";
+}
+
+// Log-likelihood ratio of the trinomial model, with elo0 and elo1 in logistic Elo
+double Match::getLlr() const {
+    int games = this->_wins + this->_losses + this->_draws;
+
+    if (games == 0 || this->_wins + this->_losses == 0) {
+        return 0.0;
+    }
+
+    double score = (this->_wins + 0.5 * this->_draws) / games;
+    double variance = (this->_wins + 0.25 * this->_draws) / games - score * score;
+
+    if (variance <= 0.0) {
+        return 0.0;
+    }
+
+    double score0 = 1.0 / (1.0 + std::pow(10.0, -this->_settings.elo0 / 400.0));
+    double score1 = 1.0 / (1.0 + std::pow(10.0, -this->_settings.elo1 / 400.0));
+
+    return games * (score1 - score0) * (2.0 * score - score0 - score1) / (2.0 * variance);
+}
+
+std::unique_ptr<Engine> Match::createEngine(const MatchEngine &matchEngine) {
+    std::unique_ptr<Engine> engine = std::make_unique<Engine>();
+
+    engine->setSearchLimits(matchEngine.searchLimits);
+
+    if (!matchEngine.bookPath.empty() && !engine->loadBook(matchEngine.bookPath)) {
+        LOG_WARN("Could not load book for {}: {}", matchEngine.name, matchEngine.bookPath);
+    }
+
+    if (!matchEngine.tablebasePath.empty() && !engine->loadTablebases(matchEngine.tablebasePath)) {
+        LOG_WARN("Could not load tablebases for {}: {}", matchEngine.name, matchEngine.tablebasePath);
+    }
+
+    for (const auto &[name, value] : matchEngine.tunables) {
+        if (!engine->setTunable(name, value)) {
+            LOG_WARN("Could not set tunable {} for {}, it needs a build with TUNING defined", name, matchEngine.name);
+        }
+    }
+
+    return engine;
+}
+
+// FEN or EPD lines, EPD operations are ignored and the move counters default to "0 1". Lines that are not a valid position are dropped with a warning
+std::vector<std::string> Match::loadOpenings(const std::string &path) {
+    std::vector<std::string> openings;
+
+    std::ifstream file(path);
+
+    std::string line;
+
+    int lineNumber = 0;
+
+    // The codec's check test reads the shared attack tables
+    Engine::initialise();
+
+    while (std::getline(file, line)) {
+        ++lineNumber;
+
+        std::vector<std::string> tokens = StringUtility::splitStringByWhiteSpace(line);
+
+        if (tokens.size() < 4 || tokens[0][0] == '#') {
+            continue;
+        }
+
+        std::string fen = tokens[0] + " " + tokens[1] + " " + tokens[2] + " " + tokens[3];
+
+        bool hasCounters = tokens.size() >= 6 && std::isdigit(static_cast<unsigned char>(tokens[4][0])) && std::isdigit(static_cast<unsigned char>(tokens[5][0]));
+
+        fen += hasCounters ? " " + tokens[4] + " " + tokens[5] : " 0 1";
+
+        FenCodec::FenPosition position;
+
+        FenCodec::FenResult result = FenCodec::parse(fen, position);
+
+        if (result.error != FenCodec::FenError::NONE) {
+            LOG_WARN("Skipping opening on line {} of {}, invalid {} at offset {}: {}", lineNumber, path, FenCodec::ERROR_NAMES[static_cast<int>(result.error)], result.offset, fen);
+
+            continue;
+        }
+
+        openings.push_back(fen);
+    }
+
+    return openings;
+}
+
+double Match::getElo(double score) {
+    score = std::clamp(score, 1e-6, 1.0 - 1e-6);
+
+    return -400.0 * std::log10(1.0 / score - 1.0);
+}
+
+} // namespace tool
@@ -0,0 +1,502 @@
+#include <memory>
+#include <thread>
+#include <algorithm>
+
+#include <fmt/format.h>
+
+#include "tool/Pgn.hpp"
+
+#include "engine/board/Fen.hpp"
+#include "engine/board/FenCodec.hpp"
+
+#include "logger/LoggerMacros.hpp"
+
+using namespace engine;
+using namespace engine::data;
+using namespace engine::board;
+using namespace engine::book;
+
+namespace tool {
+
+Pgn::Pgn(const PgnSettings &settings) : _settings(settings), _isClosed(false), _treeBuilder(nullptr), _games(0ULL), _positions(0ULL), _skippedGames(0ULL), _invalidGames(0ULL), _isFailed(false), _reportedGames(0ULL) {
+    if (this->_settings.threads <= 0) {
+        this->_settings.threads = std::max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+    }
+
+    this->_settings.chunkSize = std::max<size_t>(this->_settings.chunkSize, 1);
+}
+
+bool Pgn::run(const std::string &path, const std::string &outputPath) {
+    if (!outputPath.empty() && !this->_writer.open(outputPath)) {
+        return false;
+    }
+
+    return this->parse(path);
+}
+
+bool Pgn::run(const std::string &path, TreeBuilder &treeBuilder) {
+    this->_treeBuilder = &treeBuilder;
+
+    bool isParsed = this->parse(path);
+
+    this->_treeBuilder = nullptr;
+
+    return isParsed;
+}
+
+bool Pgn::parse(const std::string &path) {
+    std::ifstream file(path, std::ios::binary);
+
+    if (!file.is_open()) {
+        LOG_ERROR("Could not open PGN file: {}", path);
+
+        return false;
+    }
+
+    this->_start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> workers;
+
+    for (int i = 0; i < this->_settings.threads; ++i) {
+        workers.emplace_back(&Pgn::work, this);
+    }
+
+    uint64_t bytes = this->read(file);
+
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+
+    this->_writer.close();
+
+    double seconds = std::max(std::chrono::duration<double>(std::chrono::steady_clock::now() - this->_start).count(), 1e-9);
+
+    fmt::print("Parsed {} games ({} skipped, {} invalid) with {} positions in {:.2f} s, {:.0f} games/s, {:.1f} MB/s\n", this->_games, this->_skippedGames, this->_invalidGames, this->_positions, seconds, this->_games / seconds, bytes / seconds / (1 << 20));
+
+    return !this->_isFailed;
+}
+
+// Only the unparsed tail and the queued chunks are ever in memory
+uint64_t Pgn::read(std::ifstream &file) {
+    std::vector<char> block(this->_READ_SIZE);
+
+    std::string buffer;
+
+    uint64_t bytes = 0ULL;
+
+    while (file) {
+        file.read(block.data(), static_cast<std::streamsize>(block.size()));
+
+        size_t size = static_cast<size_t>(file.gcount());
+
+        if (size == 0) {
+            break;
+        }
+
+        bytes += size;
+
+        buffer.append(block.data(), size);
+
+        size_t offset = 0;
+
+        // A game longer than the chunk size is kept whole, the chunk just grows until the next game starts
+        while (buffer.size() - offset > this->_settings.chunkSize) {
+            size_t end = Pgn::findGameStart(buffer, offset + this->_settings.chunkSize);
+
+            if (end == std::string::npos) {
+                break;
+            }
+
+            this->push(buffer.substr(offset, end - offset));
+
+            offset = end;
+        }
+
+        buffer.erase(0, offset);
+    }
+
+    if (!buffer.empty()) {
+        this->push(std::move(buffer));
+    }
+
+    std::lock_guard<std::mutex> lock(this->_mutex);
+
+    this->_isClosed = true;
+
+    this->_chunkAdded.notify_all();
+
+    return bytes;
+}
+
+void Pgn::push(std::string chunk) {
+    std::unique_lock<std::mutex> lock(this->_mutex);
+
+    this->_chunkTaken.wait(lock, [this]() { return this->_chunks.size() < this->_QUEUED_CHUNKS * this->_settings.threads; });
+
+    this->_chunks.push_back(std::move(chunk));
+
+    this->_chunkAdded.notify_one();
+}
+
+bool Pgn::take(std::string &chunk) {
+    std::unique_lock<std::mutex> lock(this->_mutex);
+
+    this->_chunkAdded.wait(lock, [this]() { return !this->_chunks.empty() || this->_isClosed; });
+
+    if (this->_chunks.empty()) {
+        return false;
+    }
+
+    chunk = std::move(this->_chunks.front());
+
+    this->_chunks.pop_front();
+
+    this->_chunkTaken.notify_one();
+
+    return true;
+}
+
+void Pgn::work() {
+    std::unique_ptr<Engine> engine = std::make_unique<Engine>();
+
+    std::string chunk;
+
+    std::vector<Record> records;
+
+    std::vector<TreeEntry> treeEntries;
+
+    while (this->take(chunk)) {
+        this->parseChunk(*engine, chunk, records, treeEntries);
+
+        this->write(records, treeEntries);
+    }
+}
+
+// Tags, movetext, comments, variations and annotation glyphs, one game after another
+void Pgn::parseChunk(Engine &engine, std::string_view chunk, std::vector<Record> &records, std::vector<TreeEntry> &treeEntries) {
+    records.clear();
+
+    treeEntries.clear();
+
+    bool isGameStarted = false;
+    bool isMovetext = false;
+    bool isSkipped = false;
+    bool isValid = true;
+    bool isResultKnown = false;
+
+    Result result = Result::DRAW;
+
+    // Where the current game's positions and moves start
+    size_t first = 0;
+    size_t firstTreeEntry = 0;
+
+    auto finishGame = [&]() {
+        if (!isGameStarted) {
+            return;
+        }
+
+        ++this->_games;
+
+        if (!isValid) {
+            ++this->_invalidGames;
+
+            records.resize(first);
+            treeEntries.resize(firstTreeEntry);
+        } else if (isSkipped || !isResultKnown) {
+            ++this->_skippedGames;
+
+            records.resize(first);
+            treeEntries.resize(firstTreeEntry);
+        } else {
+            for (size_t i = first; i < records.size(); ++i) {
+                records[i].result = result;
+            }
+
+            for (size_t i = firstTreeEntry; i < treeEntries.size(); ++i) {
+                treeEntries[i].whiteWins = (result == Result::WHITE_WIN);
+                treeEntries[i].draws = (result == Result::DRAW);
+                treeEntries[i].blackWins = (result == Result::BLACK_WIN);
+            }
+        }
+
+        isGameStarted = false;
+    };
+
+    auto startGame = [&]() {
+        finishGame();
+
+        engine.parse(INITIAL_POSITION);
+
+        isGameStarted = true;
+        isMovetext = false;
+        isSkipped = false;
+        isValid = true;
+        isResultKnown = false;
+
+        first = records.size();
+        firstTreeEntry = treeEntries.size();
+    };
+
+    bool isLineStart = true;
+
+    size_t index = 0;
+
+    while (index < chunk.size()) {
+        const char letter = chunk[index];
+
+        if (letter == ' ' || letter == '\t' || letter == '\r' || letter == '\n') {
+            isLineStart |= (letter == '\n');
+
+            ++index;
+
+            continue;
+        }
+
+        // Tag pairs and escaped lines take the rest of their line
+        if (isLineStart && (letter == '[' || letter == '%')) {
+            size_t end = std::min(chunk.find('\n', index), chunk.size());
+
+            if (letter == '[') {
+                std::string_view line = chunk.substr(index, end - index);
+
+                if (!isGameStarted || isMovetext) {
+                    startGame();
+                }
+
+                std::string_view value;
+
+                if (!(value = Pgn::getTagValue(line, "FEN")).empty()) {
+                    // Checked first so a database full of broken setups does not flood the log
+                    FenCodec::FenPosition position;
+
+                    isValid = isValid && FenCodec::parse(value, position).error == FenCodec::FenError::NONE && engine.parse(value);
+                } else if (!(value = Pgn::getTagValue(line, "Result")).empty()) {
+                    isResultKnown = Pgn::parseResult(value, result);
+                } else if (!(value = Pgn::getTagValue(line, "Variant")).empty()) {
+                    isSkipped = isSkipped || (value != "Standard" && value != "From Position");
+                }
+            }
+
+            index = end;
+
+            continue;
+        }
+
+        isLineStart = false;
+
+        // A line comment leaves its newline, so a tag on the next line is still at a line start
+        if (letter == '{' || letter == ';') {
+            size_t end = chunk.find((letter == '{') ? '}' : '\n', index);
+
+            index = (end == std::string_view::npos) ? chunk.size() : end + (letter == '{');
+
+            continue;
+        }
+
+        // Variations are skipped whole, comments inside them may hold parentheses
+        if (letter == '(') {
+            int depth = 0;
+
+            for (; index < chunk.size(); ++index) {
+                if (chunk[index] == '{') {
+                    index = std::min(chunk.find('}', index), chunk.size() - 1);
+                } else if (chunk[index] == '(') {
+                    ++depth;
+                } else if (chunk[index] == ')' && --depth == 0) {
+                    break;
+                }
+            }
+
+            ++index;
+
+            continue;
+        }
+
+        size_t end = index;
+
+        while (end < chunk.size() && chunk[end] != ' ' && chunk[end] != '\t' && chunk[end] != '\r' && chunk[end] != '\n' && chunk[end] != '{' && chunk[end] != '(' && chunk[end] != ')' && chunk[end] != ';') {
+            ++end;
+        }
+
+        std::string_view token = chunk.substr(index, std::max<size_t>(end - index, 1));
+
+        index = std::max(end, index + 1);
+
+        if (!isGameStarted) {
+            startGame();
+        }
+
+        isMovetext = true;
+
+        if (Pgn::isTermination(token)) {
+            Result terminationResult;
+
+            if (Pgn::parseResult(token, terminationResult)) {
+                result = terminationResult;
+                isResultKnown = true;
+            }
+
+            finishGame();
+
+            continue;
+        }
+
+        // Numeric annotation glyphs and stray closing parentheses
+        if (token[0] == '$' || token[0] == ')') {
+            continue;
+        }
+
+        // Move numbers, possibly run into the move as in "1.e4" or "12...Nf6"
+        size_t digits = 0;
+
+        while (digits < token.size() && token[digits] >= '0' && token[digits] <= '9') {
+            ++digits;
+        }
+
+        if (digits > 0 && digits < token.size() && token[digits] == '.') {
+            token.remove_prefix(digits);
+
+            while (!token.empty() && token[0] == '.') {
+                token.remove_prefix(1);
+            }
+        }
+
+        if (token.empty() || !isValid || isSkipped) {
+            continue;
+        }
+
+        uint16_t move = engine.getMoveFromSan(token);
+
+        if (move == 0U) {
+            isValid = false;
+
+            continue;
+        }
+
+        if (this->_treeBuilder != nullptr) {
+            if (static_cast<int>(treeEntries.size() - firstTreeEntry) < this->_settings.treePlies) {
+                treeEntries.push_back(TreeEntry{ engine.getPolyglotKey(), move, 0, 0U, 0U, 0U });
+            }
+        } else {
+            Record record;
+
+            engine.pack(record);
+
+            records.push_back(record);
+        }
+
+        engine.makeMove(move);
+    }
+
+    // The last game of the file may have no termination marker
+    finishGame();
+}
+
+void Pgn::write(const std::vector<Record> &records, const std::vector<TreeEntry> &treeEntries) {
+    std::lock_guard<std::mutex> lock(this->_writerMutex);
+
+    if (this->_writer.isOpen()) {
+        this->_writer.write(records.data(), records.size());
+    }
+
+    if (this->_treeBuilder != nullptr && !this->_treeBuilder->add(treeEntries.data(), treeEntries.size())) {
+        this->_isFailed = true;
+    }
+
+    this->_positions += records.size() + treeEntries.size();
+
+    if (this->_games / this->_REPORT_INTERVAL != this->_reportedGames / this->_REPORT_INTERVAL) {
+        this->_reportedGames = this->_games;
+
+        double seconds = std::max(std::chrono::duration<double>(std::chrono::steady_clock::now() - this->_start).count(), 1e-9);
+
+        fmt::print("{} games, {} positions, {:.0f} games/s\n", this->_reportedGames, this->_positions, this->_reportedGames / seconds);
+    }
+}
+
+// First game start from the line at or after the offset: a tag line whose previous non-blank line is not a tag, so a game's own tags are never split from it
+size_t Pgn::findGameStart(std::string_view text, size_t from) {
+    size_t index = (from == 0) ? 0 : text.find('\n', from - 1);
+
+    if (index == std::string_view::npos) {
+        return std::string_view::npos;
+    }
+
+    index += (from != 0);
+
+    // The line before the search starts decides whether the first tag line found opens a game
+    size_t previous = index;
+
+    while (previous > 0 && (text[previous - 1] == ' ' || text[previous - 1] == '\t' || text[previous - 1] == '\r' || text[previous - 1] == '\n')) {
+        --previous;
+    }
+
+    bool isPreviousTag = false;
+
+    if (previous > 0) {
+        size_t lineStart = text.rfind('\n', previous - 1);
+
+        isPreviousTag = Pgn::isTagLine(text, (lineStart == std::string_view::npos) ? 0 : lineStart + 1);
+    }
+
+    while (index < text.size()) {
+        size_t end = std::min(text.find('\n', index), text.size());
+
+        if (text.find_first_not_of(" \t\r", index) < end) {
+            bool isTag = Pgn::isTagLine(text, index);
+
+            if (isTag && !isPreviousTag) {
+                return index;
+            }
+
+            isPreviousTag = isTag;
+        }
+
+        index = end + 1;
+    }
+
+    return std::string_view::npos;
+}
+
+bool Pgn::isTagLine(std::string_view text, size_t index) {
+    index = text.find_first_not_of(" \t", index);
+
+    return index != std::string_view::npos && text[index] == '[';
+}
+
+// [Name "Value"], empty for another tag
+std::string_view Pgn::getTagValue(std::string_view line, std::string_view name) {
+    if (line.size() < name.size() + 4 || line.compare(1, name.size(), name) != 0 || line[name.size() + 1] != ' ') {
+        return {};
+    }
+
+    size_t start = line.find('"', name.size() + 1);
+    size_t end = line.rfind('"');
+
+    if (start == std::string_view::npos || end <= start) {
+        return {};
+    }
+
+    return line.substr(start + 1, end - start - 1);
+}
+
+bool Pgn::isTermination(std::string_view token) {
+    return token == "1-0" || token == "0-1" || token == "1/2-1/2" || token == "*";
+}
+
+// False for "*" and anything else that is not a finished game
+bool Pgn::parseResult(std::string_view text, Result &result) {
+    if (text == "1-0") {
+        result = Result::WHITE_WIN;
+    } else if (text == "0-1") {
+        result = Result::BLACK_WIN;
+    } else if (text == "1/2-1/2") {
+        result = Result::DRAW;
+    } else {
+        return false;
+    }
+
+    return true;
+}
+
+} // namespace tool
@@ -0,0 +1,72 @@
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <cstring>
+#include <algorithm>
+
+#include <fmt/format.h>
+
+#include "tool/Records.hpp"
+
+#include "engine/Engine.hpp"
+
+using namespace engine;
+using namespace engine::data;
+
+namespace tool {
+
+Records::Records(const DatasetSettings &settings) : _settings(settings) {
+}
+
+bool Records::run(const std::string &path) {
+    Dataset dataset(this->_settings);
+
+    if (!dataset.open(path)) {
+        return false;
+    }
+
+    std::unique_ptr<Engine> engine = std::make_unique<Engine>();
+
+    std::vector<Record> chunk;
+
+    uint64_t results[3] = { 0ULL, 0ULL, 0ULL };
+
+    size_t invalid = 0;
+    size_t mismatches = 0;
+
+    auto start = std::chrono::steady_clock::now();
+
+    while (dataset.next(chunk)) {
+        for (const Record &record : chunk) {
+            if (!isValid(record)) {
+                ++invalid;
+
+                continue;
+            }
+
+            ++results[record.result];
+
+            engine->unpack(record);
+
+            // The label is not part of the position, so it is carried over before comparing bytes
+            Record packed;
+
+            engine->pack(packed);
+
+            packed.result = record.result;
+            packed.score = record.score;
+
+            mismatches += (std::memcmp(&packed, &record, sizeof(Record)) != 0);
+        }
+    }
+
+    double seconds = std::max(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(), 1e-9);
+
+    fmt::print("Records: {} in {} chunks, {:.3f} s, {:.0f} records/s\n", dataset.size(), dataset.chunks(), seconds, dataset.size() / seconds);
+    fmt::print("Results: white {}, draw {}, black {}\n", results[Result::WHITE_WIN], results[Result::DRAW], results[Result::BLACK_WIN]);
+    fmt::print("Invalid: {}, round trip mismatches: {}\n", invalid, mismatches);
+
+    return invalid == 0 && mismatches == 0;
+}
+
+} // namespace tool
@@ -0,0 +1,147 @@
+#include <cmath>
+#include <random>
+#include <algorithm>
+
+#include <fmt/format.h>
+
+#include <nlohmann/json.hpp>
+
+#include "tool/Spsa.hpp"
+
+#include "engine/search/Tunable.hpp"
+
+#include "logger/LoggerMacros.hpp"
+
+#include "utility/FileUtility.hpp"
+
+using namespace engine::search;
+
+using namespace utility;
+
+namespace tool {
+
+Spsa::Spsa(const MatchEngine &engine, const MatchSettings &matchSettings, const SpsaSettings &settings) : _engine(engine), _matchSettings(matchSettings), _settings(settings) {
+    const double iterations = std::max(this->_settings.iterations, 1);
+    const double stability = this->_STABILITY * iterations;
+
+    for (const TunableInfo &tunable : TUNABLES) {
+        bool isSelected = this->_settings.tunables.empty() || std::find(this->_settings.tunables.begin(), this->_settings.tunables.end(), tunable.name) != this->_settings.tunables.end();
+
+        if (!isSelected) {
+            continue;
+        }
+
+        // The step decays to the tunable's own step by the last iteration
+        double c = tunable.step * std::pow(iterations, this->_GAMMA);
+        double a = this->_settings.rEnd * tunable.step * tunable.step * std::pow(stability + iterations, this->_ALPHA);
+
+        this->_parameters.push_back({ tunable.name, static_cast<double>(tunable.value), tunable.minimum, tunable.maximum, c, a });
+    }
+
+    this->_matchSettings.games = std::max(this->_settings.gamesPerIteration - (this->_settings.gamesPerIteration % 2), 2);
+    this->_matchSettings.isSprt = false;
+    this->_matchSettings.isQuiet = true;
+}
+
+bool Spsa::run(const std::string &openingsPath) {
+    if (!Tunables().set(TUNABLES[0].name, TUNABLES[0].value)) {
+        LOG_ERROR("Tunables are compile time constants in this build, rebuild with TUNING defined");
+
+        return false;
+    }
+
+    if (this->_parameters.empty()) {
+        LOG_ERROR("None of the requested tunables exist");
+
+        return false;
+    }
+
+    std::vector<std::string> openings = Match::loadOpenings(openingsPath);
+
+    if (openings.empty()) {
+        LOG_ERROR("No openings found in: {}", openingsPath);
+
+        return false;
+    }
+
+    std::mt19937_64 generator(std::random_device{}());
+
+    const double stability = this->_STABILITY * this->_settings.iterations;
+
+    for (int iteration = 1; iteration <= this->_settings.iterations; ++iteration) {
+        MatchEngine plus = this->_engine;
+        MatchEngine minus = this->_engine;
+
+        plus.name = "plus";
+        minus.name = "minus";
+
+        std::vector<double> steps;
+        std::vector<int> flips;
+
+        for (const Parameter &parameter : this->_parameters) {
+            double step = parameter.c / std::pow(iteration, this->_GAMMA);
+
+            int flip = std::bernoulli_distribution(0.5)(generator) ? 1 : -1;
+
+            auto getValue = [&parameter](double value) { return static_cast<int>(std::lround(std::clamp(value, static_cast<double>(parameter.minimum), static_cast<double>(parameter.maximum)))); };
+
+            plus.tunables.emplace_back(parameter.name, getValue(parameter.value + step * flip));
+            minus.tunables.emplace_back(parameter.name, getValue(parameter.value - step * flip));
+
+            steps.push_back(step);
+            flips.push_back(flip);
+        }
+
+        // A fresh sample of openings every iteration, each played with both colours
+        std::vector<std::string> batch;
+
+        std::uniform_int_distribution<size_t> distribution(0, openings.size() - 1);
+
+        for (int i = 0; i < this->_matchSettings.games / 2; ++i) {
+            batch.push_back(openings[distribution(generator)]);
+        }
+
+        Match match(plus, minus, this->_matchSettings);
+
+        if (!match.run(batch, "")) {
+            return false;
+        }
+
+        double result = match.getWins() - match.getLosses();
+
+        for (size_t i = 0; i < this->_parameters.size(); ++i) {
+            Parameter &parameter = this->_parameters[i];
+
+            double learningRate = parameter.a / std::pow(stability + iteration, this->_ALPHA);
+
+            parameter.value = std::clamp(parameter.value + learningRate / steps[i] * result * flips[i], static_cast<double>(parameter.minimum), static_cast<double>(parameter.maximum));
+        }
+
+        std::string values;
+
+        for (const Parameter &parameter : this->_parameters) {
+            values += fmt::format(" {}={:.2f}", parameter.name, parameter.value);
+        }
+
+        fmt::print("Iteration {:>5} +{} -{} ={}{}\n", iteration, match.getWins(), match.getLosses(), match.getDraws(), values);
+
+        this->save(iteration);
+    }
+
+    return true;
+}
+
+void Spsa::save(int iteration) const {
+    nlohmann::json json;
+
+    json["iteration"] = iteration;
+    json["tunables"] = nlohmann::json::object();
+
+    for (const Parameter &parameter : this->_parameters) {
+        json["tunables"][parameter.name] = parameter.value;
+    }
+
+    FileUtility::saveJson(json, this->_settings.outputPath);
+}
+
+} // namespace tool
@@ -0,0 +1,418 @@
+#include <thread>
+#include <cctype>
+#include <random>
+#include <charconv>
+#include <system_error>
+
+#include "tool/Tool.hpp"
+#include "tool/Epd.hpp"
+#include "tool/Match.hpp"
+#include "tool/Datagen.hpp"
+#include "tool/Tuner.hpp"
+#include "tool/Spsa.hpp"
+#include "tool/Bench.hpp"
+#include "tool/Analysis.hpp"
+#include "tool/Records.hpp"
+#include "tool/Pgn.hpp"
+#include "tool/Explorer.hpp"
+
+#include "engine/hash/Transposition.hpp"
+
+#include "engine/tablebase/Generator.hpp"
+
+#include "logger/LoggerMacros.hpp"
+
+#include "utility/FileUtility.hpp"
+
+using namespace engine;
+
+using namespace engine::hash;
+
+using namespace engine::tablebase;
+
+using namespace utility;
+
+namespace tool {
+
+int Tool::run(int argc, char *argv[]) {
+    std::vector<std::string> arguments(argv + 1, argv + argc);
+
+    if (arguments[0] == "tablebase") {
+        return Tool::runTablebase(arguments);
+    }
+
+    if (arguments[0] == "epd") {
+        return Tool::runEpd(arguments);
+    }
+
+    if (arguments[0] == "match") {
+        return Tool::runMatch(arguments);
+    }
+
+    if (arguments[0] == "datagen") {
+        return Tool::runDatagen(arguments);
+    }
+
+    if (arguments[0] == "tune") {
+        return Tool::runTuner(arguments);
+    }
+
+    if (arguments[0] == "spsa") {
+        return Tool::runSpsa(arguments);
+    }
+
+    if (arguments[0] == "bench") {
+        return Tool::runBench(arguments);
+    }
+
+    if (arguments[0] == "analyse") {
+        return Tool::runAnalysis(arguments);
+    }
+
+    if (arguments[0] == "records") {
+        return Tool::runRecords(arguments);
+    }
+
+    if (arguments[0] == "pgn") {
+        return Tool::runPgn(arguments);
+    }
+
+    if (arguments[0] == "tree") {
+        return Tool::runTree(arguments);
+    }
+
+    if (arguments[0] == "explore") {
+        return Tool::runExplore(arguments);
+    }
+
+    return Tool::printUsage();
+}
+
+// tablebase <directory> <pieces | material> [threads]
+int Tool::runTablebase(const std::vector<std::string> &arguments) {
+    if (arguments.size() < 3) {
+        return Tool::printUsage();
+    }
+
+    int threads = static_cast<int>(std::thread::hardware_concurrency());
+    int pieces = 0;
+
+    bool isPieces = std::isdigit(static_cast<unsigned char>(arguments[2][0]));
+
+    if (!Tool::parseArgument(arguments, 3, threads) || (isPieces && !Tool::parseArgument(arguments, 2, pieces))) {
+        return Tool::printUsage();
+    }
+
+    Generator generator(arguments[1], threads);
+
+    bool isGenerated = isPieces ? generator.generate(pieces) : generator.generate(arguments[2]);
+
+    return isGenerated ? 0 : 1;
+}
+
+// epd <file> [milliseconds per position] [threads] [report]
+int Tool::runEpd(const std::vector<std::string> &arguments) {
+    if (arguments.size() < 2) {
+        return Tool::printUsage();
+    }
+
+    int64_t time = 1000;
+    int threads = static_cast<int>(std::thread::hardware_concurrency());
+
+    if (!Tool::parseArgument(arguments, 2, time) || !Tool::parseArgument(arguments, 3, threads)) {
+        return Tool::printUsage();
+    }
+
+    std::string reportPath = (arguments.size() > 4) ? arguments[4] : arguments[1] + ".json";
+
+    // Engines log every depth, which would drown the results
+    logger::Logger::getInstance().setSeverity(logger::Severity::WARN);
+
+    Epd epd(threads, SearchLimits{ engine::move::MAX_PLY, time, 0ULL });
+
+    return epd.run(arguments[1], reportPath) ? 0 : 1;
+}
+
+// match <config> <openings> [pgn]
+int Tool::runMatch(const std::vector<std::string> &arguments) {
+    if (arguments.size() < 3) {
+        return Tool::printUsage();
+    }
+
+    nlohmann::json config;
+
+    FileUtility::loadJson(config, arguments[1]);
+
+    MatchEngine engine;
+    MatchEngine otherEngine;
+
+    MatchSettings settings;
+
+    if (!Match::parseConfig(config, engine, otherEngine, settings)) {
+        return 1;
+    }
+
+    std::string pgnPath = (arguments.size() > 3) ? arguments[3] : "match.pgn";
+
+    logger::Logger::getInstance().setSeverity(logger::Severity::WARN);
+
+    Match match(engine, otherEngine, settings);
+
+    return match.run(arguments[2], pgnPath) ? 0 : 1;
+}
+
+// datagen <output> [positions] [nodes per move] [threads] [random plies]
+int Tool::runDatagen(const std::vector<std::string> &arguments) {
+    if (arguments.size() < 2) {
+        return Tool::printUsage();
+    }
+
+    DatagenSettings settings;
+
+    settings.positions = 1000000ULL;
+    settings.nodes = 5000ULL;
+    settings.threads = 0;
+    settings.randomPlies = 8;
+
+    if (!Tool::parseArgument(arguments, 2, settings.positions) || !Tool::parseArgument(arguments, 3, settings.nodes) || !Tool::parseArgument(arguments, 4, settings.threads) || !Tool::parseArgument(arguments, 5, settings.randomPlies)) {
+        return Tool::printUsage();
+    }
+
+    logger::Logger::getInstance().setSeverity(logger::Severity::WARN);
+
+    Datagen datagen(settings);
+
+    return datagen.run(arguments[1]) ? 0 : 1;
+}
+
+// tune <records> [epochs] [threads] [output directory] [lambda] [learning rate]
+int Tool::runTuner(const std::vector<std::string> &arguments) {
+    if (arguments.size() < 2) {
+        return Tool::printUsage();
+    }
+
+    TunerSettings settings;
+
+    settings.epochs = 500;
+    settings.threads = 0;
+    settings.lambda = 1.0;
+    settings.learningRate = 1.0;
+
+    if (!Tool::parseArgument(arguments, 2, settings.epochs) || !Tool::parseArgument(arguments, 3, settings.threads) || !Tool::parseArgument(arguments, 5, settings.lambda) || !Tool::parseArgument(arguments, 6, settings.learningRate)) {
+        return Tool::printUsage();
+    }
+
+    std::string outputDirectory = (arguments.size() > 4) ? arguments[4] : "tuned";
+
+    logger::Logger::getInstance().setSeverity(logger::Severity::WARN);
+
+    Tuner tuner(settings);
+
+    if (!tuner.open(arguments[1])) {
+        return 1;
+    }
+
+    return tuner.run(outputDirectory) ? 0 : 1;
+}
+
+// spsa <config> <openings>
+int Tool::runSpsa(const std::vector<std::string> &arguments) {
+    if (arguments.size() < 3) {
+        return Tool::printUsage();
+    }
+
+    nlohmann::json config;
+
+    FileUtility::loadJson(config, arguments[1]);
+
+    SpsaSettings settings;
+
+    settings.iterations = config.value("iterations", 1000);
+    settings.gamesPerIteration = config.value("gamesPerIteration", 16);
+    settings.rEnd = config.value("rEnd", 0.002);
+    settings.tunables = config.value("tunables", std::vector<std::string>());
+    settings.outputPath = config.value("output", std::string("spsa.json"));
+
+    logger::Logger::getInstance().setSeverity(logger::Severity::WARN);
+
+    Spsa spsa(Match::parseEngine(config.value("engine", nlohmann::json::object()), "engine"), Match::parseSettings(config), settings);
+
+    return spsa.run(arguments[2]) ? 0 : 1;
+}
+
+// bench [depth] [evaluations per position] [hash megabytes] [epd]
+int Tool::runBench(const std::vector<std::string> &arguments) {
+    BenchSettings settings;
+
+    settings.depth = 7;
+    settings.evaluations = 1000000;
+    settings.hashSize = Transposition::TRANSPOSITION_TABLE_MEGABYTES;
+
+    if (!Tool::parseArgument(arguments, 1, settings.depth) || !Tool::parseArgument(arguments, 2, settings.evaluations) || !Tool::parseArgument(arguments, 3, settings.hashSize)) {
+        return Tool::printUsage();
+    }
+
+    logger::Logger::getInstance().setSeverity(logger::Severity::WARN);
+
+    Bench bench(settings);
+
+    return bench.run((arguments.size() > 4) ? arguments[4] : "") ? 0 : 1;
+}
+
+// analyse [socket | -] [threads] [hash megabytes per thread] [queue size] [batch size]
+int Tool::runAnalysis(const std::vector<std::string> &arguments) {
+    AnalysisSettings settings;
+
+    settings.threads = 0;
+    settings.hashSize = Transposition::TRANSPOSITION_TABLE_MEGABYTES;
+    settings.queueSize = 1024;
+    settings.batchSize = 8;
+    settings.searchLimits = SearchLimits{ engine::move::MAX_PLY, 1000, 0ULL };
+
+    if (!Tool::parseArgument(arguments, 2, settings.threads) || !Tool::parseArgument(arguments, 3, settings.hashSize) || !Tool::parseArgument(arguments, 4, settings.queueSize) || !Tool::parseArgument(arguments, 5, settings.batchSize)) {
+        return Tool::printUsage();
+    }
+
+    std::string socketPath = (arguments.size() > 1) ? arguments[1] : "-";
+
+    // Responses go to standard output, which the log would share
+    logger::Logger::getInstance().setSeverity((socketPath == "-") ? logger::Severity::FATAL : logger::Severity::WARN);
+
+    Analysis analysis(settings);
+
+    bool isRun = (socketPath == "-") ? analysis.run() : analysis.run(socketPath);
+
+    return isRun ? 0 : 1;
+}
+
+// records <file> [chunk size] [shuffle] [prefetch chunks]
+int Tool::runRecords(const std::vector<std::string> &arguments) {
+    if (arguments.size() < 2) {
+        return Tool::printUsage();
+    }
+
+    engine::data::DatasetSettings settings;
+
+    int shuffle = 0;
+
+    settings.chunkSize = 1 << 16;
+    settings.prefetchChunks = 4;
+
+    if (!Tool::parseArgument(arguments, 2, settings.chunkSize) || !Tool::parseArgument(arguments, 3, shuffle) || !Tool::parseArgument(arguments, 4, settings.prefetchChunks)) {
+        return Tool::printUsage();
+    }
+
+    settings.isShuffled = shuffle != 0;
+    settings.seed = std::random_device{}();
+
+    logger::Logger::getInstance().setSeverity(logger::Severity::WARN);
+
+    Records records(settings);
+
+    return records.run(arguments[1]) ? 0 : 1;
+}
+
+// pgn <file> [records] [threads] [chunk megabytes]
+int Tool::runPgn(const std::vector<std::string> &arguments) {
+    if (arguments.size() < 2) {
+        return Tool::printUsage();
+    }
+
+    PgnSettings settings;
+
+    settings.threads = 0;
+    settings.chunkSize = 4;
+    settings.treePlies = 0;
+
+    if (!Tool::parseArgument(arguments, 3, settings.threads) || !Tool::parseArgument(arguments, 4, settings.chunkSize)) {
+        return Tool::printUsage();
+    }
+
+    settings.chunkSize <<= 20;
+
+    logger::Logger::getInstance().setSeverity(logger::Severity::WARN);
+
+    Pgn pgn(settings);
+
+    return pgn.run(arguments[1], (arguments.size() > 2) ? arguments[2] : "") ? 0 : 1;
+}
+
+// tree <pgn> <tree> [threads] [plies] [memory megabytes]
+int Tool::runTree(const std::vector<std::string> &arguments) {
+    if (arguments.size() < 3) {
+        return Tool::printUsage();
+    }
+
+    ExplorerSettings settings;
+
+    settings.threads = 0;
+    settings.plies = 40;
+    settings.memoryBytes = 1024;
+
+    if (!Tool::parseArgument(arguments, 3, settings.threads) || !Tool::parseArgument(arguments, 4, settings.plies) || !Tool::parseArgument(arguments, 5, settings.memoryBytes)) {
+        return Tool::printUsage();
+    }
+
+    settings.memoryBytes <<= 20;
+
+    logger::Logger::getInstance().setSeverity(logger::Severity::WARN);
+
+    Explorer explorer(settings);
+
+    return explorer.build(arguments[1], arguments[2]) ? 0 : 1;
+}
+
+// explore <tree> <fen>
+int Tool::runExplore(const std::vector<std::string> &arguments) {
+    if (arguments.size() < 3) {
+        return Tool::printUsage();
+    }
+
+    logger::Logger::getInstance().setSeverity(logger::Severity::WARN);
+
+    Explorer explorer(ExplorerSettings{ 0, 0, 0 });
+
+    return explorer.probe(arguments[1], arguments[2]) ? 0 : 1;
+}
+
+int Tool::printUsage() {
+    LOG_ERROR("Usage: chess tablebase <directory> <pieces | material, e.g. KRKN> [threads]");
+    LOG_ERROR("Usage: chess epd <file> [milliseconds per position] [threads] [report]");
+    LOG_ERROR("Usage: chess match <config> <openings> [pgn]");
+    LOG_ERROR("Usage: chess datagen <output> [positions] [nodes per move] [threads] [random plies]");
+    LOG_ERROR("Usage: chess tune <records> [epochs] [threads] [output directory] [lambda] [learning rate]");
+    LOG_ERROR("Usage: chess spsa <config> <openings>");
+    LOG_ERROR("Usage: chess bench [depth] [evaluations per position] [hash megabytes] [epd]");
+    LOG_ERROR("Usage: chess analyse [socket | -] [threads] [hash megabytes per thread] [queue size] [batch size]");
+    LOG_ERROR("Usage: chess records <file> [chunk size] [shuffle] [prefetch chunks]");
+    LOG_ERROR("Usage: chess pgn <file> [records] [threads] [chunk megabytes]");
+    LOG_ERROR("Usage: chess tree <pgn> <tree> [threads] [plies] [memory megabytes]");
+    LOG_ERROR("Usage: chess explore <tree> <fen>");
+
+    return 1;
+}
+
+template <typename Number>
+bool Tool::parseArgument(const std::vector<std::string> &arguments, size_t index, Number &number) {
+    if (index >= arguments.size()) {
+        return true;
+    }
+
+    const std::string &argument = arguments[index];
+
+    Number value{};
+
+    auto [end, error] = std::from_chars(argument.data(), argument.data() + argument.size(), value);
+
+    if (error != std::errc() || end != argument.data() + argument.size()) {
+        LOG_ERROR("Not a valid number for argument {}: {}", index, argument);
+
+        return false;
+    }
+
+    number = value;
+
+    return true;
+}
+
+} // namespace tool
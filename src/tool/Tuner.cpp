@@ -0,0 +1,537 @@
+#include <cmath>
+#include <atomic>
+#include <thread>
+#include <fstream>
+#include <algorithm>
+#include <filesystem>
+
+#include <fmt/format.h>
+
+#include "tool/Tuner.hpp"
+
+#include "engine/Engine.hpp"
+
+#include "engine/board/Square.hpp"
+
+#include "engine/piece/King.hpp"
+#include "engine/piece/Queen.hpp"
+#include "engine/piece/Bishop.hpp"
+
+#include "engine/evaluation/pesto/Phase.hpp"
+#include "engine/evaluation/pesto/Material.hpp"
+#include "engine/evaluation/pesto/Position.hpp"
+
+#include "logger/LoggerMacros.hpp"
+
+#include "utility/BitUtility.hpp"
+
+using namespace engine;
+using namespace engine::data;
+using namespace engine::board;
+using namespace engine::piece;
+using namespace engine::evaluation::pesto;
+
+using namespace utility;
+
+namespace tool {
+
+Tuner::Tuner(const TunerSettings &settings) : _settings(settings), _records(nullptr), _size(0), _validSize(0), _k(1.0) {
+    if (this->_settings.threads <= 0) {
+        this->_settings.threads = std::max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+    }
+
+    // The features are computed with the shared attack tables
+    Engine::initialise();
+
+    this->initialiseWeights();
+}
+
+// Pages are streamed in by the workers, so the data set can be far larger than memory
+bool Tuner::open(const std::string &path) {
+    this->close();
+
+    if (!this->_file.open(path, utility::MappedAccess::SEQUENTIAL)) {
+        LOG_ERROR("Could not map record file: {}", path);
+
+        return false;
+    }
+
+    if (this->_file.size() < sizeof(Record)) {
+        LOG_ERROR("Record file is empty: {}", path);
+
+        this->_file.close();
+
+        return false;
+    }
+
+    this->_records = static_cast<const Record *>(this->_file.data());
+    this->_size = this->_file.size() / sizeof(Record);
+
+    // Files may be corrupt or written by other tools, and decoding a bad record writes past the bitboards
+    std::vector<size_t> validSizes(this->_settings.threads, 0);
+
+    this->runParallel([&](size_t first, size_t last, int thread) {
+        for (size_t i = first; i < last; ++i) {
+            validSizes[thread] += isValid(this->_records[i]);
+        }
+    });
+
+    for (size_t validSize : validSizes) {
+        this->_validSize += validSize;
+    }
+
+    if (this->_validSize == 0) {
+        LOG_ERROR("Record file has no valid records: {}", path);
+
+        this->close();
+
+        return false;
+    }
+
+    if (this->_validSize < this->_size) {
+        LOG_WARN("Skipping {} invalid records of {} in: {}", this->_size - this->_validSize, this->_size, path);
+    }
+
+    return true;
+}
+
+void Tuner::close() {
+    this->_file.close();
+
+    this->_records = nullptr;
+    this->_size = 0;
+    this->_validSize = 0;
+}
+
+bool Tuner::run(const std::string &outputDirectory) {
+    if (this->_records == nullptr) {
+        return false;
+    }
+
+    this->_k = this->fitK();
+
+    fmt::print("Tuning {} weights on {} positions with {} threads, K = {:.4f}\n", this->_WEIGHTS, this->_validSize, this->_settings.threads, this->_k);
+
+    std::vector<double> gradient(this->_WEIGHTS);
+    std::vector<double> momentum(this->_WEIGHTS, 0.0);
+    std::vector<double> velocity(this->_WEIGHTS, 0.0);
+
+    for (int epoch = 1; epoch <= this->_settings.epochs; ++epoch) {
+        double error = this->getGradient(gradient);
+
+        double beta1Correction = 1.0 - std::pow(this->_BETA1, epoch);
+        double beta2Correction = 1.0 - std::pow(this->_BETA2, epoch);
+
+        for (int i = 0; i < this->_WEIGHTS; ++i) {
+            momentum[i] = this->_BETA1 * momentum[i] + (1.0 - this->_BETA1) * gradient[i];
+            velocity[i] = this->_BETA2 * velocity[i] + (1.0 - this->_BETA2) * gradient[i] * gradient[i];
+
+            this->_weights[i] -= this->_settings.learningRate * (momentum[i] / beta1Correction) / (std::sqrt(velocity[i] / beta2Correction) + this->_EPSILON);
+        }
+
+        if (epoch % this->_REPORT_INTERVAL == 0 || epoch == 1 || epoch == this->_settings.epochs) {
+            fmt::print("Epoch {:>5} error {:.8f}\n", epoch, error);
+        }
+    }
+
+    fmt::print("Final error {:.8f}\n", this->getError(this->_k, this->_settings.lambda));
+
+    return this->writeHeaders(outputDirectory);
+}
+
+void Tuner::initialiseWeights() {
+    this->_weights.assign(this->_WEIGHTS, 0.0);
+
+    for (int phase = GamePhase::OPENING; phase <= GamePhase::ENDGAME; ++phase) {
+        for (int piece = PieceType::PAWN; piece <= PieceType::KING; ++piece) {
+            this->_weights[this->_MATERIAL_OFFSET + phase * 6 + piece] = MATERIAL_VALUES[phase][piece];
+
+            for (int square = 0; square < 64; ++square) {
+                this->_weights[this->_POSITION_OFFSET + (phase * 6 + piece) * 64 + square] = POSITION_VALUES[phase][piece][square];
+            }
+        }
+
+        this->_weights[this->_STACKED_PAWN_OFFSET + phase] = STACKED_PAWN_PENALTY_PESTO[phase];
+        this->_weights[this->_ISOLATED_PAWN_OFFSET + phase] = ISOLATED_PAWN_PENALTY_PESTO[phase];
+        this->_weights[this->_BISHOP_MOBILITY_OFFSET + phase] = BISHOP_MOBILITY_WEIGHT[phase];
+        this->_weights[this->_QUEEN_MOBILITY_OFFSET + phase] = QUEEN_MOBILITY_WEIGHT[phase];
+    }
+
+    for (int rank = 0; rank < 8; ++rank) {
+        this->_weights[this->_PASSED_PAWN_OFFSET + rank] = PASSED_PAWN_BONUS_PESTO[rank];
+    }
+
+    this->_weights[this->_SEMI_OPEN_FILE_OFFSET] = SEMI_OPEN_FILE_SCORE_PESTO;
+    this->_weights[this->_OPEN_FILE_OFFSET] = OPEN_FILE_SCORE_PESTO;
+    this->_weights[this->_KING_SAFETY_OFFSET] = KING_SAFETY_WEIGHT_PESTO;
+}
+
+double Tuner::getError(double k, double lambda) {
+    std::vector<double> errors(this->_settings.threads, 0.0);
+
+    this->runParallel([&](size_t first, size_t last, int thread) {
+        std::vector<TunerFeature> features;
+
+        uint64_t bitboards[2][6];
+
+        for (size_t i = first; i < last; ++i) {
+            const Record &record = this->_records[i];
+
+            if (!isValid(record)) {
+                continue;
+            }
+
+            Tuner::decode(record, bitboards);
+
+            Tuner::getFeatures(bitboards, features);
+
+            double target = lambda * record.result / 2.0 + (1.0 - lambda) * Tuner::getSigmoid(record.score, k);
+
+            double difference = Tuner::getSigmoid(this->evaluate(features, Tuner::getPhase(bitboards)), k) - target;
+
+            errors[thread] += difference * difference;
+        }
+    });
+
+    double error = 0.0;
+
+    for (double threadError : errors) {
+        error += threadError;
+    }
+
+    return error / this->_validSize;
+}
+
+// Mean squared error and its gradient, each thread sums into its own buffer
+double Tuner::getGradient(std::vector<double> &gradient) {
+    std::vector<std::vector<double>> gradients(this->_settings.threads, std::vector<double>(this->_WEIGHTS, 0.0));
+
+    std::vector<double> errors(this->_settings.threads, 0.0);
+
+    const double k = this->_k;
+    const double lambda = this->_settings.lambda;
+
+    this->runParallel([&](size_t first, size_t last, int thread) {
+        std::vector<TunerFeature> features;
+
+        std::vector<double> &threadGradient = gradients[thread];
+
+        uint64_t bitboards[2][6];
+
+        for (size_t i = first; i < last; ++i) {
+            const Record &record = this->_records[i];
+
+            if (!isValid(record)) {
+                continue;
+            }
+
+            Tuner::decode(record, bitboards);
+
+            Tuner::getFeatures(bitboards, features);
+
+            double phase = Tuner::getPhase(bitboards);
+
+            double target = lambda * record.result / 2.0 + (1.0 - lambda) * Tuner::getSigmoid(record.score, k);
+
+            double sigmoid = Tuner::getSigmoid(this->evaluate(features, phase), k);
+
+            double difference = sigmoid - target;
+
+            errors[thread] += difference * difference;
+
+            // d(sigmoid - target)^2 / d(evaluation)
+            double scale = 2.0 * difference * sigmoid * (1.0 - sigmoid) * k * std::log(10.0) / 400.0;
+
+            for (const TunerFeature &feature : features) {
+                threadGradient[feature.openingIndex] += scale * feature.coefficient * phase;
+                threadGradient[feature.endgameIndex] += scale * feature.coefficient * (1.0 - phase);
+            }
+        }
+    });
+
+    std::fill(gradient.begin(), gradient.end(), 0.0);
+
+    double error = 0.0;
+
+    for (int thread = 0; thread < this->_settings.threads; ++thread) {
+        for (int i = 0; i < this->_WEIGHTS; ++i) {
+            gradient[i] += gradients[thread][i] / this->_validSize;
+        }
+
+        error += errors[thread];
+    }
+
+    return error / this->_validSize;
+}
+
+// Ternary search on the game results alone, the error is convex in K
+double Tuner::fitK() {
+    double low = 0.1;
+    double high = 4.0;
+
+    for (int i = 0; i < 20; ++i) {
+        double lowMiddle = low + (high - low) / 3.0;
+        double highMiddle = high - (high - low) / 3.0;
+
+        if (this->getError(lowMiddle, 1.0) < this->getError(highMiddle, 1.0)) {
+            high = highMiddle;
+        } else {
+            low = lowMiddle;
+        }
+    }
+
+    return (low + high) / 2.0;
+}
+
+double Tuner::evaluate(const std::vector<TunerFeature> &features, double phase) const {
+    double opening = 0.0;
+    double endgame = 0.0;
+
+    for (const TunerFeature &feature : features) {
+        opening += feature.coefficient * this->_weights[feature.openingIndex];
+        endgame += feature.coefficient * this->_weights[feature.endgameIndex];
+    }
+
+    return opening * phase + endgame * (1.0 - phase);
+}
+
+double Tuner::getSigmoid(double score, double k) {
+    return 1.0 / (1.0 + std::pow(10.0, -k * score / 400.0));
+}
+
+// Opening weight of the taper, the same phase the engine tracks incrementally
+double Tuner::getPhase(const uint64_t bitboards[2][6]) {
+    int phase = 0;
+
+    for (int piece = PieceType::KNIGHT; piece <= PieceType::QUEEN; ++piece) {
+        phase += GAME_PHASE_VALUES[piece] * (BitUtility::popCount(bitboards[ColourType::WHITE][piece]) + BitUtility::popCount(bitboards[ColourType::BLACK][piece]));
+    }
+
+    return static_cast<double>(std::min(phase, MAX_PHASE)) / MAX_PHASE;
+}
+
+void Tuner::decode(const Record &record, uint64_t bitboards[2][6]) {
+    uint8_t castleRights;
+
+    int enPassantSquare;
+
+    ColourType side;
+
+    uint16_t halfMove;
+    uint16_t fullMove;
+
+    engine::data::decode(record, bitboards, castleRights, enPassantSquare, side, halfMove, fullMove);
+}
+
+// Mirrors Engine::evaluate term by term from white's point of view
+void Tuner::getFeatures(const uint64_t bitboards[2][6], std::vector<TunerFeature> &features) {
+    features.clear();
+
+    const uint64_t pawns[2] = { bitboards[ColourType::WHITE][PieceType::PAWN], bitboards[ColourType::BLACK][PieceType::PAWN] };
+
+    const uint64_t bothPawns = pawns[ColourType::WHITE] | pawns[ColourType::BLACK];
+
+    uint64_t occupancies[2] = { 0ULL, 0ULL };
+
+    for (int side = ColourType::WHITE; side <= ColourType::BLACK; ++side) {
+        for (int piece = PieceType::PAWN; piece <= PieceType::KING; ++piece) {
+            occupancies[side] |= bitboards[side][piece];
+        }
+    }
+
+    const uint64_t occupancyBoth = occupancies[ColourType::WHITE] | occupancies[ColourType::BLACK];
+
+    for (int side = ColourType::WHITE; side <= ColourType::BLACK; ++side) {
+        const int sign = (side == ColourType::WHITE) ? 1 : -1;
+
+        const uint64_t ownPawns = pawns[side];
+        const uint64_t otherPawns = pawns[side ^ 1];
+
+        for (int piece = PieceType::PAWN; piece <= PieceType::KING; ++piece) {
+            uint64_t pieces = bitboards[side][piece];
+
+            while (pieces) {
+                int square = BitUtility::popLSB(pieces);
+
+                // Tables are laid out from a8, so white reads them mirrored
+                int tableSquare = (side == ColourType::WHITE) ? MIRROR[square] : square;
+
+                int file = FILE_FROM_SQUARE[square];
+                int rank = RANK_FROM_SQUARE[(side == ColourType::WHITE) ? square : MIRROR[square]];
+
+                Tuner::addFeature(features, Tuner::_MATERIAL_OFFSET + piece, Tuner::_MATERIAL_OFFSET + 6 + piece, sign);
+                Tuner::addFeature(features, Tuner::_POSITION_OFFSET + piece * 64 + tableSquare, Tuner::_POSITION_OFFSET + (6 + piece) * 64 + tableSquare, sign);
+
+                if (piece == PieceType::PAWN) {
+                    if ((ownPawns & ISOLATED_FILE_MASKS[file]) == 0ULL) {
+                        Tuner::addFeature(features, Tuner::_ISOLATED_PAWN_OFFSET, Tuner::_ISOLATED_PAWN_OFFSET + 1, sign);
+                    }
+
+                    if ((otherPawns & PASSED_PAWN_MASKS[side][square]) == 0ULL) {
+                        Tuner::addFeature(features, Tuner::_PASSED_PAWN_OFFSET + rank, Tuner::_PASSED_PAWN_OFFSET + rank, sign);
+                    }
+
+                    int stackedPawns = BitUtility::popCount(ownPawns & FILE_MASKS[file]);
+
+                    if (stackedPawns > 1) {
+                        Tuner::addFeature(features, Tuner::_STACKED_PAWN_OFFSET, Tuner::_STACKED_PAWN_OFFSET + 1, sign * (stackedPawns - 1));
+                    }
+                }
+
+                if (piece == PieceType::BISHOP) {
+                    int mobility = BitUtility::popCount(Bishop::getAttacks(square, occupancyBoth)) - BISHOP_OFFSET_VALUE;
+
+                    Tuner::addFeature(features, Tuner::_BISHOP_MOBILITY_OFFSET, Tuner::_BISHOP_MOBILITY_OFFSET + 1, sign * mobility);
+                }
+
+                if (piece == PieceType::ROOK || piece == PieceType::KING) {
+                    // Open files help rooks and hurt kings
+                    int fileSign = (piece == PieceType::ROOK) ? sign : -sign;
+
+                    if ((ownPawns & FILE_MASKS[file]) == 0ULL) {
+                        Tuner::addFeature(features, Tuner::_SEMI_OPEN_FILE_OFFSET, Tuner::_SEMI_OPEN_FILE_OFFSET, fileSign);
+                    }
+
+                    if ((bothPawns & FILE_MASKS[file]) == 0ULL) {
+                        Tuner::addFeature(features, Tuner::_OPEN_FILE_OFFSET, Tuner::_OPEN_FILE_OFFSET, fileSign);
+                    }
+                }
+
+                if (piece == PieceType::QUEEN) {
+                    int mobility = BitUtility::popCount(Queen::getAttacks(square, occupancyBoth)) - QUEEN_OFFSET_VALUE;
+
+                    Tuner::addFeature(features, Tuner::_QUEEN_MOBILITY_OFFSET, Tuner::_QUEEN_MOBILITY_OFFSET + 1, sign * mobility);
+                }
+
+                if (piece == PieceType::KING) {
+                    int shelter = BitUtility::popCount(King::ATTACKS[square] & occupancies[side]);
+
+                    Tuner::addFeature(features, Tuner::_KING_SAFETY_OFFSET, Tuner::_KING_SAFETY_OFFSET, sign * shelter);
+                }
+            }
+        }
+    }
+}
+
+void Tuner::addFeature(std::vector<TunerFeature> &features, int openingIndex, int endgameIndex, int coefficient) {
+    if (coefficient != 0) {
+        features.push_back({ static_cast<uint16_t>(openingIndex), static_cast<uint16_t>(endgameIndex), static_cast<int16_t>(coefficient) });
+    }
+}
+
+// Workers take chunks in order, function(first, last, thread) must only write to its own thread's state
+template <typename Function>
+void Tuner::runParallel(Function function) {
+    std::atomic<size_t> nextChunk(0);
+
+    auto worker = [&](int thread) {
+        while (true) {
+            size_t first = nextChunk.fetch_add(1) * this->_CHUNK_SIZE;
+
+            if (first >= this->_size) {
+                return;
+            }
+
+            function(first, std::min(first + this->_CHUNK_SIZE, this->_size), thread);
+        }
+    };
+
+    std::vector<std::thread> threads;
+
+    for (int thread = 0; thread < this->_settings.threads; ++thread) {
+        threads.emplace_back(worker, thread);
+    }
+
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+}
+
+// Writes drop-in replacements for pesto/Material.hpp and pesto/Position.hpp
+bool Tuner::writeHeaders(const std::string &outputDirectory) const {
+    std::filesystem::create_directories(outputDirectory);
+
+    std::ofstream material(outputDirectory + "/Material.hpp");
+    std::ofstream position(outputDirectory + "/Position.hpp");
+
+    if (!material.is_open() || !position.is_open()) {
+        LOG_ERROR("Could not write tuned headers to: {}", outputDirectory);
+
+        return false;
+    }
+
+    material << "#pragma once\n\nnamespace engine::evaluation::pesto {\n\n";
+    material << "// 0: opening, 1: endgame\n";
+    material << "inline constexpr int MATERIAL_VALUES[2][6] = {\n";
+
+    for (int phase = GamePhase::OPENING; phase <= GamePhase::ENDGAME; ++phase) {
+        material << "    {";
+
+        for (int piece = PieceType::PAWN; piece <= PieceType::KING; ++piece) {
+            material << ((piece == PieceType::PAWN) ? " " : ", ") << this->getWeight(this->_MATERIAL_OFFSET + phase * 6 + piece);
+        }
+
+        material << " },\n";
+    }
+
+    material << "};\n\n} // namespace engine::evaluation::pesto\n";
+
+    position << "#pragma once\n\nnamespace engine::evaluation::pesto {\n\n";
+    position << "// clang-format off\n// 0: opening, 1: endgame\n";
+    position << "inline constexpr int POSITION_VALUES[2][6][64] = {\n";
+
+    for (int phase = GamePhase::OPENING; phase <= GamePhase::ENDGAME; ++phase) {
+        position << "    {\n";
+
+        for (int piece = PieceType::PAWN; piece <= PieceType::KING; ++piece) {
+            position << "        {\n";
+
+            for (int rank = 0; rank < 8; ++rank) {
+                position << "           ";
+
+                for (int file = 0; file < 8; ++file) {
+                    position << fmt::format(" {:>4},", this->getWeight(this->_POSITION_OFFSET + (phase * 6 + piece) * 64 + rank * 8 + file));
+                }
+
+                position << "\n";
+            }
+
+            position << "        },\n";
+        }
+
+        position << "    },\n";
+    }
+
+    position << "};\n// clang-format on\n\n";
+
+    position << "// Pawn penalties\n";
+    position << fmt::format("inline constexpr int STACKED_PAWN_PENALTY_PESTO[2] = {{ {}, {} }};\n\n", this->getWeight(this->_STACKED_PAWN_OFFSET), this->getWeight(this->_STACKED_PAWN_OFFSET + 1));
+    position << fmt::format("inline constexpr int ISOLATED_PAWN_PENALTY_PESTO[2] = {{ {}, {} }};\n\n", this->getWeight(this->_ISOLATED_PAWN_OFFSET), this->getWeight(this->_ISOLATED_PAWN_OFFSET + 1));
+    position << "inline constexpr int PASSED_PAWN_BONUS_PESTO[8] = {";
+
+    for (int rank = 0; rank < 8; ++rank) {
+        position << ((rank == 0) ? " " : ", ") << this->getWeight(this->_PASSED_PAWN_OFFSET + rank);
+    }
+
+    position << " };\n\n";
+    position << "// Rook open files\n";
+    position << fmt::format("inline constexpr int SEMI_OPEN_FILE_SCORE_PESTO = {};\n\n", this->getWeight(this->_SEMI_OPEN_FILE_OFFSET));
+    position << fmt::format("inline constexpr int OPEN_FILE_SCORE_PESTO = {};\n\n", this->getWeight(this->_OPEN_FILE_OFFSET));
+    position << fmt::format("inline constexpr int BISHOP_MOBILITY_WEIGHT[2] = {{ {}, {} }};\n", this->getWeight(this->_BISHOP_MOBILITY_OFFSET), this->getWeight(this->_BISHOP_MOBILITY_OFFSET + 1));
+    position << fmt::format("inline constexpr int BISHOP_OFFSET_VALUE = {};\n\n", BISHOP_OFFSET_VALUE);
+    position << fmt::format("inline constexpr int QUEEN_MOBILITY_WEIGHT[2] = {{ {}, {} }};\n", this->getWeight(this->_QUEEN_MOBILITY_OFFSET), this->getWeight(this->_QUEEN_MOBILITY_OFFSET + 1));
+    position << fmt::format("inline constexpr int QUEEN_OFFSET_VALUE = {};\n\n", QUEEN_OFFSET_VALUE);
+    position << "// King safety factor\n";
+    position << fmt::format("inline constexpr int KING_SAFETY_WEIGHT_PESTO = {};\n\n", this->getWeight(this->_KING_SAFETY_OFFSET));
+    position << "} // namespace engine::evaluation::pesto\n";
+
+    fmt::print("Wrote tuned headers to {}\n", outputDirectory);
+
+    return true;
+}
+
+std::string Tuner::getWeight(int index) const {
+    return std::to_string(static_cast<int>(std::lround(this->_weights[index])));
+}
+
+} // namespace tool
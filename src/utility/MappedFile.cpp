@@ -0,0 +1,85 @@
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "utility/MappedFile.hpp"
+
+namespace utility {
+
+MappedFile::MappedFile() : _data(nullptr), _size(0) {
+}
+
+MappedFile::~MappedFile() {
+    this->close();
+}
+
+// The descriptor is closed straight away, the mapping keeps the file alive
+bool MappedFile::open(const std::string &path, MappedAccess access) {
+    this->close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+
+    if (fd == -1) {
+        return false;
+    }
+
+    struct stat status;
+
+    if (fstat(fd, &status) == -1 || status.st_size <= 0) {
+        ::close(fd);
+
+        return false;
+    }
+
+    size_t size = static_cast<size_t>(status.st_size);
+
+    void *data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    ::close(fd);
+
+    if (data == MAP_FAILED) {
+        return false;
+    }
+
+    switch (access) {
+    case MappedAccess::SEQUENTIAL:
+        madvise(data, size, MADV_SEQUENTIAL);
+        break;
+    case MappedAccess::RANDOM:
+        madvise(data, size, MADV_RANDOM);
+        break;
+    default:
+        break;
+    }
+
+    this->_data = data;
+    this->_size = size;
+
+    return true;
+}
+
+void MappedFile::close() {
+    if (this->_data == nullptr) {
+        return;
+    }
+
+    munmap(this->_data, this->_size);
+
+    this->_data = nullptr;
+    this->_size = 0;
+}
+
+bool MappedFile::isOpen() const {
+    return this->_data != nullptr;
+}
+
+const void *MappedFile::data() const {
+    return this->_data;
+}
+
+size_t MappedFile::size() const {
+    return this->_size;
+}
+
+} // namespace utility